@@ -0,0 +1,125 @@
+#include <pch/pch.hpp>
+#include <core/actor/actor.hpp>
+#include <adt/frp/batch.hpp>
+#include "../../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const float minPosY = 0.45f;
+	float getY( const FVec3& vec )
+	{
+		return vec.y;
+	}
+	FVec3 fromY( const float& y )
+	{
+		return FVec3{ 0.0f, y, 0.0f };
+	}
+	bool onTheGround( const float& y )
+	{
+		return y <= minPosY;
+	}
+	bool falling( const float& velY )
+	{
+		return velY < 0.0f;
+	}
+	float bounce( const bool& b )
+	{
+		return b ? -1.0f : 1.0f;
+	}
+	bool both( const bool a, const bool b )
+	{
+		return a && b;
+	}
+	FVec3 aboveGround( const FVec3& pos )
+	{
+		return FVec3{ pos.x, pos.y < minPosY ? minPosY : pos.y, pos.z };
+	}
+	ActorState withPos( const FVec3& pos, const ActorState& state )
+	{
+		auto newState = state;
+		newState.pos = pos;
+		return newState;
+	}
+	ActorState withVel( const FVec3& vel, const ActorState& state )
+	{
+		auto newState = state;
+		newState.vel = vel;
+		return newState;
+	}
+	ActorState withRot( const FQuat& rot, const ActorState& state )
+	{
+		auto newState = state;
+		newState.rot = rot;
+		return newState;
+	}
+	ActorOutput conActorOutput( const ActorState& state )
+	{
+		return ActorOutput{ state };
+	}
+	// same network as the bouncing ball of example 1
+	BatchSF<ActorInput, ActorOutput> bouncingBall( )
+	{
+		auto input = fused::input<ActorInput>( );
+		auto state = fused::member( &ActorInput::state ) < input;
+		auto rot = fused::mul( fused::member( &ActorState::rot ) < state )
+			< fused::arr( eulerRadToQuat<float> ) < fused::arr( fromY )
+			< fused::integral( ) < 0.003f;
+		auto velY = fused::add( fused::arr( getY ) < fused::member( &ActorState::vel ) < state )
+			< fused::integral( ) < -0.00000981f;
+		auto velY2 = fused::mul( fused::arr( bounce )
+			< fused::lift2( both, fused::arr( onTheGround )
+			< fused::arr( getY ) < fused::member( &ActorState::pos ) < state )
+			< fused::arr( falling ) < velY ) < velY;
+		auto vel = fused::arr( fromY ) < velY2;
+		auto pos = fused::arr( aboveGround ) < fused::add( fused::integral( ) < vel )
+			< fused::member( &ActorState::pos ) < state;
+		return fused::batch( input, fused::arr( conActorOutput )
+			< fused::lift2( withRot, rot ) < fused::lift2( withVel, vel )
+			< fused::lift2( withPos, pos ) < state );
+	}
+	std::vector<ActorInput> balls( const UInt32 count )
+	{
+		std::vector<ActorInput> inputs( count );
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			const float a = i * TWO_PI_F / count;
+			inputs[i].state.pos = FVec3{ sinf( a ) * 10.0f, minPosY + ( i % 32 ) * 0.15f,
+				cosf( a ) * 10.0f };
+			inputs[i].state.scl = FVec3{ 1.0f, 1.0f, 1.0f };
+		}
+		return inputs;
+	}
+}
+
+HP_BENCHMARK( bouncingBalls )
+{
+	const float deltaMs = 16.0f;
+	const auto ball = bouncingBall( );
+	const UInt32 counts[] = { 64, 256, 1024, 4096, 16384, 65536, 100000 };
+	for ( const auto count : counts )
+	{
+		const std::vector<ActorInput> inputs = balls( count );
+		std::vector<ActorOutput> outputs( count );
+		std::vector<SFInstance<ActorInput, ActorOutput>> instances;
+		instances.reserve( count );
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			instances.push_back( instantiate( ball.sf ) );
+		}
+		const double scalarNs = measureNs_IO( [&]
+		{
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				outputs[i] = sample_IO( instances[i], inputs[i], deltaMs );
+			}
+		} );
+		report_IO( "scalar", count, scalarNs / count );
+		const double batchNs = measureNs_IO( [&]
+		{
+			sample_IO( *ball.tape, inputs.data( ), outputs.data( ), count, deltaMs );
+		} );
+		report_IO( BATCH_SIMD_WIDTH == 8 ? "batch avx 8 wide" : "batch sse 4 wide", count,
+			batchNs / count );
+	}
+}
@@ -0,0 +1,110 @@
+#include <pch/pch.hpp>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <adt/map.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const UInt32 counts[] = { 1000, 10000, 100000 };
+	// pseudo random keys, same for all variants
+	std::vector<Int32> keys( const UInt32 count )
+	{
+		std::vector<Int32> ks( count );
+		UInt32 x = 12345;
+		for ( auto& k : ks )
+		{
+			x = x * 1103515245 + 12345;
+			k = static_cast<Int32>( x >> 1 );
+		}
+		return ks;
+	}
+}
+
+// count column is the number of entries, times are per entry
+HP_BENCHMARK( mapBuild )
+{
+	for ( const auto count : counts )
+	{
+		const auto ks = keys( count );
+		report_IO( "std::map insert", count, measureNs_IO( [&ks]
+		{
+			std::map<Int32, Int32> m;
+			for ( const auto k : ks )
+			{
+				m.emplace( k, k );
+			}
+		} ) / count );
+		report_IO( "std::unordered_map insert", count, measureNs_IO( [&ks]
+		{
+			std::unordered_map<Int32, Int32> m;
+			for ( const auto k : ks )
+			{
+				m.emplace( k, k );
+			}
+		} ) / count );
+		report_IO( "Map insert", count, measureNs_IO( [&ks]
+		{
+			Map<Int32, Int32> m;
+			for ( const auto k : ks )
+			{
+				m = m.insert( k, k );
+			}
+		} ) / count );
+		report_IO( "MapTransient insert_IO", count, measureNs_IO( [&ks]
+		{
+			MapTransient<Int32, Int32> t;
+			for ( const auto k : ks )
+			{
+				t.insert_IO( k, k );
+			}
+			t.persistent_IO( );
+		} ) / count );
+	}
+}
+
+HP_BENCHMARK( mapFind )
+{
+	for ( const auto count : counts )
+	{
+		const auto ks = keys( count );
+		std::map<Int32, Int32> sm;
+		std::unordered_map<Int32, Int32> um;
+		MapTransient<Int32, Int32> t;
+		for ( const auto k : ks )
+		{
+			sm.emplace( k, k );
+			um.emplace( k, k );
+			t.insert_IO( k, k );
+		}
+		const auto m = t.persistent_IO( );
+		Int64 sum = 0;
+		report_IO( "std::map", count, measureNs_IO( [&]
+		{
+			for ( const auto k : ks )
+			{
+				sum += sm.find( k )->second;
+			}
+		} ) / count );
+		report_IO( "std::unordered_map", count, measureNs_IO( [&]
+		{
+			for ( const auto k : ks )
+			{
+				sum += um.find( k )->second;
+			}
+		} ) / count );
+		report_IO( "Map", count, measureNs_IO( [&]
+		{
+			for ( const auto k : ks )
+			{
+				sum += *m.find( k );
+			}
+		} ) / count );
+		if ( sum == 0 )
+		{
+			printf( "  unexpected sum\n" );
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#include <pch/pch.hpp>
+#include <adt/frp/e.hpp>
+#include <adt/frp/sfs.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	// fires every other tick
+	E<float> everyOther( const float& x )
+	{
+		return x > 0.5f ? e( x * 2.0f ) : noE<float>( );
+	}
+}
+
+// count column is the number of ticks, each tick makes an event or no event
+HP_BENCHMARK( maybeEvents )
+{
+	const UInt32 ticks = 1024;
+	auto events = instantiate( hold( 0.0f ) < arr( everyOther ) );
+	float sum = 0.0f;
+	const auto run = [&]
+	{
+		for ( UInt32 i = 0; i < ticks; ++i )
+		{
+			sum += sample_IO( events, static_cast<float>( i & 1 ), 16.0f );
+		}
+	};
+	report_IO( "hold < event", ticks, measureNs_IO( run ) / ticks );
+	reportAllocations_IO( "hold < event", ticks, measureAllocations_IO( run ) / ticks );
+	if ( sum == 0.0f )
+	{
+		printf( "  unexpected sum\n" );
+	}
+}
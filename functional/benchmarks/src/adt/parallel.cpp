@@ -0,0 +1,86 @@
+#include <pch/pch.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include <adt/parallel.hpp>
+#include <adt/vector.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const UInt32 count = 1000000;
+	struct Enemy
+	{
+		float x, y, z;
+		Int32 health;
+	};
+	float distanceSq( const Enemy& e )
+	{
+		return e.x * e.x + e.y * e.y + e.z * e.z;
+	}
+	// nearest living enemy so far, 1e9 when there is none
+	float nearer( const float acc, const Enemy& e )
+	{
+		return e.health > 0 ? std::min( acc, distanceSq( e ) ) : acc;
+	}
+	float nearest( const float a, const float b )
+	{
+		return std::min( a, b );
+	}
+	std::vector<Enemy> enemies( )
+	{
+		std::vector<Enemy> es( count );
+		UInt32 x = 12345;
+		for ( auto& e : es )
+		{
+			x = x * 1103515245 + 12345;
+			e = Enemy{ ( x >> 8 ) % 1000 * 0.1f, ( x >> 12 ) % 1000 * 0.1f, 1.0f,
+				static_cast<Int32>( x >> 16 ) % 4 };
+		}
+		return es;
+	}
+}
+
+// nearest living enemy over 1M enemies, sequential foldl against parallelReduce with 1, 2, 4
+// and 8 threads, time is per enemy
+HP_BENCHMARK( parallelReduce )
+{
+	const auto es = enemies( );
+	const Vector<Enemy> ev( es.begin( ), es.end( ) );
+	struct Reducer
+	{
+		float operator ( ) ( const float acc, const Enemy& e ) const
+		{
+			return nearer( acc, e );
+		}
+		float operator ( ) ( const float a, const float b ) const
+		{
+			return nearest( a, b );
+		}
+	};
+	float result = 0.0f;
+	report_IO( "foldl Vector", count, measureNs_IO( [&ev, &result]
+	{
+		result = foldl( nearer, 1e9f, ev );
+	} ) / count );
+	for ( UInt32 threads = 1; threads <= 8; threads *= 2 )
+	{
+		ThreadPool pool( threads );
+		char variant[32];
+		sprintf( variant, "parallel Vector x%u", threads );
+		report_IO( variant, count, measureNs_IO( [&pool, &ev, &result]
+		{
+			result = parallelReduce( pool, Reducer( ), 1e9f, ev, 16 * PARALLEL_GRAIN );
+		} ) / count );
+		sprintf( variant, "parallel std::vector x%u", threads );
+		report_IO( variant, count, measureNs_IO( [&pool, &es, &result]
+		{
+			result = parallelReduce( pool, Reducer( ), 1e9f, es, 16 * PARALLEL_GRAIN );
+		} ) / count );
+	}
+	if ( result < 0.0f )
+	{
+		printf( "  unexpected result\n" );
+	}
+}
@@ -0,0 +1,90 @@
+#include <pch/pch.hpp>
+#include <algorithm>
+#include <vector>
+#include <adt/stream.hpp>
+#include <adt/vector.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const UInt32 count = 100000;
+	struct Enemy
+	{
+		float x, y, z;
+		Int32 health;
+	};
+	bool isAlive( const Enemy& e )
+	{
+		return e.health > 0;
+	}
+	float distanceSq( const Enemy& e )
+	{
+		return e.x * e.x + e.y * e.y + e.z * e.z;
+	}
+	float nearer( const float acc, const float d )
+	{
+		return std::min( acc, d );
+	}
+	std::vector<Enemy> enemies( )
+	{
+		std::vector<Enemy> es( count );
+		UInt32 x = 12345;
+		for ( auto& e : es )
+		{
+			x = x * 1103515245 + 12345;
+			e = Enemy{ ( x >> 8 ) % 1000 * 0.1f, ( x >> 12 ) % 1000 * 0.1f, 1.0f,
+				static_cast<Int32>( x >> 16 ) % 4 };
+		}
+		return es;
+	}
+}
+
+// nearest living enemy, filter -> fmap -> foldl over 100k enemies, times and allocations are
+// per enemy
+HP_BENCHMARK( streamPipeline )
+{
+	const auto es = enemies( );
+	const Vector<Enemy> ev( es.begin( ), es.end( ) );
+	float nearest = 0.0f;
+	auto eagerVector = [&es, &nearest]
+	{
+		std::vector<Enemy> alive;
+		std::copy_if( es.begin( ), es.end( ), std::back_inserter( alive ), isAlive );
+		std::vector<float> ds( alive.size( ) );
+		std::transform( alive.begin( ), alive.end( ), ds.begin( ), distanceSq );
+		nearest = 1e9f;
+		for ( const auto d : ds )
+		{
+			nearest = nearer( nearest, d );
+		}
+	};
+	auto eagerVectorAdt = [&ev, &nearest]
+	{
+		nearest = foldl( nearer, 1e9f, fmap( distanceSq, filter( isAlive, ev ) ) );
+	};
+	auto lazyVector = [&es, &nearest]
+	{
+		nearest = foldl( nearer, 1e9f, fmap( distanceSq, filter( isAlive, stream( es ) ) ) );
+	};
+	auto lazyVectorAdt = [&ev, &nearest]
+	{
+		nearest = foldl( nearer, 1e9f, fmap( distanceSq, filter( isAlive, stream( ev ) ) ) );
+	};
+	report_IO( "eager std::vector", count, measureNs_IO( eagerVector ) / count );
+	reportAllocations_IO( "eager std::vector", count,
+		measureAllocations_IO( eagerVector, 10 ) / count );
+	report_IO( "eager Vector", count, measureNs_IO( eagerVectorAdt ) / count );
+	reportAllocations_IO( "eager Vector", count,
+		measureAllocations_IO( eagerVectorAdt, 10 ) / count );
+	report_IO( "stream std::vector", count, measureNs_IO( lazyVector ) / count );
+	reportAllocations_IO( "stream std::vector", count,
+		measureAllocations_IO( lazyVector, 10 ) / count );
+	report_IO( "stream Vector", count, measureNs_IO( lazyVectorAdt ) / count );
+	reportAllocations_IO( "stream Vector", count,
+		measureAllocations_IO( lazyVectorAdt, 10 ) / count );
+	if ( nearest < 0.0f )
+	{
+		printf( "  unexpected result\n" );
+	}
+}
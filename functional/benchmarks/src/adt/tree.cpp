@@ -0,0 +1,105 @@
+#include <pch/pch.hpp>
+#include <vector>
+#include <adt/tree.hpp>
+#include <math/vec3.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const UInt32 sceneSize = 50000;
+	// children per actor, the scene is 7 levels deep
+	const UInt32 width = 6;
+	const UInt32 changedCounts[] = { 1, 10, 100, 1000 };
+	// actor i has children i * width + 1 to i * width + width
+	Tree<FVec3> scene( const std::vector<FVec3>& positions, const UInt32 i = 0 )
+	{
+		std::vector<Tree<FVec3>> children;
+		for ( UInt32 c = i * width + 1; c <= i * width + width && c < positions.size( ); ++c )
+		{
+			children.push_back( scene( positions, c ) );
+		}
+		return Tree<FVec3>( positions[i], Vector<Tree<FVec3>>( children.begin( ), children.end( ) ) );
+	}
+	TreePath pathOf( UInt32 i )
+	{
+		TreePath path;
+		for ( ; i > 0; i = ( i - 1 ) / width )
+		{
+			path.insert( path.begin( ), ( i - 1 ) % width );
+		}
+		return path;
+	}
+	// pseudo random actors, same for all variants
+	std::vector<UInt32> changedActors( const UInt32 count )
+	{
+		std::vector<UInt32> is( count );
+		UInt32 x = 12345;
+		for ( auto& i : is )
+		{
+			x = x * 1103515245 + 12345;
+			i = ( x >> 8 ) % sceneSize;
+		}
+		return is;
+	}
+}
+
+// count column is the number of actors changed per frame in a 50k actor scene, times and
+// allocations are per changed actor
+HP_BENCHMARK( treeSceneUpdate )
+{
+	std::vector<FVec3> positions( sceneSize, FVec3{ 0.0f, 1.0f, 2.0f } );
+	const auto initial = scene( positions );
+	for ( const auto count : changedCounts )
+	{
+		const auto actors = changedActors( count );
+		std::vector<TreePath> paths;
+		for ( const auto i : actors )
+		{
+			paths.push_back( pathOf( i ) );
+		}
+		auto rebuild = [&positions, &actors]
+		{
+			for ( const auto i : actors )
+			{
+				positions[i].x += 1.0f;
+			}
+			scene( positions );
+		};
+		auto update = [&initial, &paths]
+		{
+			Tree<FVec3> t = initial;
+			for ( const auto& path : paths )
+			{
+				t = t.modify( path, []( const FVec3& p )
+				{
+					return FVec3{ p.x + 1.0f, p.y, p.z };
+				} );
+			}
+		};
+		report_IO( "full rebuild", count, measureNs_IO( rebuild ) / count );
+		reportAllocations_IO( "full rebuild", count,
+			measureAllocations_IO( rebuild, 10 ) / count );
+		report_IO( "path copying modify", count, measureNs_IO( update ) / count );
+		reportAllocations_IO( "path copying modify", count,
+			measureAllocations_IO( update, 10 ) / count );
+	}
+}
+
+// count column is the number of actors, times are per actor
+HP_BENCHMARK( treeSceneIterate )
+{
+	const auto t = scene( std::vector<FVec3>( sceneSize, FVec3{ 0.0f, 1.0f, 2.0f } ) );
+	float sum = 0.0f;
+	report_IO( "Tree forEach", sceneSize, measureNs_IO( [&t, &sum]
+	{
+		t.forEach( [&sum]( const FVec3& p )
+		{
+			sum += p.y;
+		} );
+	} ) / sceneSize );
+	if ( sum == 0.0f )
+	{
+		printf( "  unexpected sum\n" );
+	}
+}
@@ -0,0 +1,205 @@
+#include <pch/pch.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <adt/list.hpp>
+#include <adt/vector.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const UInt32 counts[] = { 10000, 100000, 1000000 };
+	// longer List overflows the stack in its recursive destructor
+	const UInt32 maxListCount = 10000;
+	// persistent std::vector, every change copies it
+	typedef std::shared_ptr<const std::vector<Int32>> CowVector;
+	CowVector update( const CowVector& v, const UInt32 i, const Int32 a )
+	{
+		auto copy = std::make_shared<std::vector<Int32>>( *v );
+		( *copy )[i] = a;
+		return copy;
+	}
+	CowVector concat( const CowVector& a, const CowVector& b )
+	{
+		auto copy = std::make_shared<std::vector<Int32>>( );
+		copy->reserve( a->size( ) + b->size( ) );
+		copy->insert( copy->end( ), a->begin( ), a->end( ) );
+		copy->insert( copy->end( ), b->begin( ), b->end( ) );
+		return copy;
+	}
+	Vector<Int32> vectorOf( const UInt32 count )
+	{
+		Vector<Int32> v;
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			v = v.pushBack( i );
+		}
+		return v;
+	}
+	// pseudo random indices, same for all variants
+	std::vector<UInt32> indices( const UInt32 count )
+	{
+		std::vector<UInt32> is( 1024 );
+		UInt32 x = 12345;
+		for ( auto& i : is )
+		{
+			x = x * 1103515245 + 12345;
+			i = ( x >> 8 ) % count;
+		}
+		return is;
+	}
+}
+
+// count column is the number of elements, times are per element or per operation
+HP_BENCHMARK( vectorBuild )
+{
+	for ( const auto count : counts )
+	{
+		if ( count <= maxListCount )
+		{
+			report_IO( "List push", count, measureNs_IO( [count]
+			{
+				List<Int32> l;
+				for ( UInt32 i = 0; i < count; ++i )
+				{
+					const Int32 a = i;
+					l = l.push( a );
+				}
+			} ) / count );
+		}
+		report_IO( "std::vector push_back", count, measureNs_IO( [count]
+		{
+			std::vector<Int32> v;
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				v.push_back( i );
+			}
+		} ) / count );
+		report_IO( "Vector pushBack", count, measureNs_IO( [count]
+		{
+			vectorOf( count );
+		} ) / count );
+	}
+}
+
+HP_BENCHMARK( vectorIterate )
+{
+	for ( const auto count : counts )
+	{
+		List<Int32> l;
+		for ( UInt32 i = 0; i < std::min( count, maxListCount ); ++i )
+		{
+			const Int32 a = i;
+			l = l.push( a );
+		}
+		const std::vector<Int32> sv( count, 1 );
+		const auto v = vectorOf( count );
+		Int64 sum = 0;
+		if ( count <= maxListCount )
+		{
+			report_IO( "List", count, measureNs_IO( [&]
+			{
+				for ( auto it = l; !it.isEmpty( ); it = it.tail( ) )
+				{
+					sum += it.head( );
+				}
+			} ) / count );
+		}
+		report_IO( "std::vector", count, measureNs_IO( [&]
+		{
+			for ( const auto a : sv )
+			{
+				sum += a;
+			}
+		} ) / count );
+		report_IO( "Vector forEach", count, measureNs_IO( [&]
+		{
+			v.forEach( [&sum]( const Int32& a )
+			{
+				sum += a;
+			} );
+		} ) / count );
+		report_IO( "Vector []", count, measureNs_IO( [&]
+		{
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				sum += v[i];
+			}
+		} ) / count );
+		if ( sum == 0 )
+		{
+			printf( "  unexpected sum\n" );
+		}
+	}
+}
+
+HP_BENCHMARK( vectorRandomAccess )
+{
+	for ( const auto count : counts )
+	{
+		const std::vector<Int32> sv( count, 1 );
+		const auto v = vectorOf( count );
+		const auto is = indices( count );
+		Int64 sum = 0;
+		report_IO( "std::vector", count, measureNs_IO( [&]
+		{
+			for ( const auto i : is )
+			{
+				sum += sv[i];
+			}
+		} ) / is.size( ) );
+		report_IO( "Vector", count, measureNs_IO( [&]
+		{
+			for ( const auto i : is )
+			{
+				sum += v[i];
+			}
+		} ) / is.size( ) );
+		if ( sum == 0 )
+		{
+			printf( "  unexpected sum\n" );
+		}
+	}
+}
+
+// persistent update of one element, the original stays intact
+HP_BENCHMARK( vectorUpdate )
+{
+	for ( const auto count : counts )
+	{
+		const auto cow = std::make_shared<const std::vector<Int32>>( count, 1 );
+		const auto v = vectorOf( count );
+		const auto is = indices( count );
+		report_IO( "std::vector copy", count, measureNs_IO( [&]
+		{
+			update( cow, is[0], 2 );
+		} ) );
+		report_IO( "Vector update", count, measureNs_IO( [&]
+		{
+			for ( const auto i : is )
+			{
+				v.update( i, 2 );
+			}
+		} ) / is.size( ) );
+	}
+}
+
+HP_BENCHMARK( vectorConcat )
+{
+	for ( const auto count : counts )
+	{
+		const auto cowA = std::make_shared<const std::vector<Int32>>( count / 2, 1 );
+		const auto cowB = std::make_shared<const std::vector<Int32>>( count - count / 2, 1 );
+		const auto a = vectorOf( count / 2 );
+		const auto b = vectorOf( count - count / 2 );
+		report_IO( "std::vector copy", count, measureNs_IO( [&]
+		{
+			concat( cowA, cowB );
+		} ) );
+		report_IO( "Vector concat", count, measureNs_IO( [&]
+		{
+			concat( a, b );
+		} ) );
+	}
+}
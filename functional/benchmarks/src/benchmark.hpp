@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+// Minimal benchmark registry. Benchmarks are registered with HP_BENCHMARK and run by main,
+// each one reports average time per item for its variants.
+namespace hp_fp
+{
+	struct Benchmark
+	{
+		const char* name;
+		void( *run_IO )( );
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	inline std::vector<Benchmark>& benchmarks_IO( )
+	{
+		static std::vector<Benchmark> benchmarks;
+		return benchmarks;
+	}
+	inline bool registerBenchmark_IO( const char* name, void( *run_IO )( ) )
+	{
+		benchmarks_IO( ).push_back( Benchmark{ name, run_IO } );
+		return true;
+	}
+	// average duration of one call of fn in nanoseconds, fn is called repeatedly for at least minMs
+	inline double measureNs_IO( const std::function<void( )>& fn, const double minMs = 200.0 )
+	{
+		typedef std::chrono::high_resolution_clock Clock;
+		fn( );
+		UInt64 iterations = 0;
+		double elapsedNs = 0.0;
+		const auto start = Clock::now( );
+		do
+		{
+			fn( );
+			++iterations;
+			elapsedNs = static_cast<double>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+				Clock::now( ) - start ).count( ) );
+		} while ( elapsedNs < minMs * 1000000.0 );
+		return elapsedNs / iterations;
+	}
+	inline void report_IO( const char* variant, const UInt32 count, const double nsPerItem )
+	{
+		printf( "  %-24s %8u %12.2f ns/item\n", variant, count, nsPerItem );
+	}
+	inline void reportRate_IO( const char* variant, const UInt32 count, const double itemsPerS )
+	{
+		printf( "  %-24s %8u %12.2f M items/s\n", variant, count, itemsPerS / 1000000.0 );
+	}
+	inline void reportError_IO( const char* variant, const UInt32 count, const double maxError )
+	{
+		printf( "  %-24s %8u %12.3e max abs error\n", variant, count, maxError );
+	}
+	// heap allocations made so far, counted by operator new of main.cpp
+	inline std::atomic<UInt64>& allocations_IO( )
+	{
+		static std::atomic<UInt64> allocations( 0 );
+		return allocations;
+	}
+	// average number of heap allocations made by one call of fn
+	inline double measureAllocations_IO( const std::function<void( )>& fn,
+		const UInt32 iterations = 100 )
+	{
+		fn( );
+		const UInt64 start = allocations_IO( );
+		for ( UInt32 i = 0; i < iterations; ++i )
+		{
+			fn( );
+		}
+		return static_cast<double>( allocations_IO( ) - start ) / iterations;
+	}
+	inline void reportAllocations_IO( const char* variant, const UInt32 count,
+		const double allocationsPerItem )
+	{
+		printf( "  %-24s %8u %12.2f allocations/item\n", variant, count, allocationsPerItem );
+	}
+	// any other event counted per item, e.g. atomic operations
+	inline void reportEvents_IO( const char* variant, const UInt32 count, const double perItem,
+		const char* events )
+	{
+		printf( "  %-24s %8u %12.2f %s/item\n", variant, count, perItem, events );
+	}
+}
+#define HP_BENCHMARK( name ) \
+	void name##_IO( ); \
+	static const bool name##Registered = hp_fp::registerBenchmark_IO( #name, &name##_IO ); \
+	void name##_IO( )
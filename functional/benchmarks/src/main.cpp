@@ -0,0 +1,36 @@
+#include <pch/pch.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "benchmark.hpp"
+using namespace hp_fp;
+// count heap allocations for measureAllocations_IO
+void* operator new( size_t size )
+{
+	++allocations_IO( );
+	void* p = malloc( size ? size : 1 );
+	// exceptions are off, see pch.hpp
+	if ( !p )
+	{
+		abort( );
+	}
+	return p;
+}
+void operator delete( void* p )
+{
+	free( p );
+}
+// runs all benchmarks, or only those whose name contains the first argument
+int main( int argc, char** argv )
+{
+	for ( const auto& benchmark : benchmarks_IO( ) )
+	{
+		if ( argc > 1 && !strstr( benchmark.name, argv[1] ) )
+		{
+			continue;
+		}
+		printf( "%s\n", benchmark.name );
+		benchmark.run_IO( );
+	}
+	return 0;
+}
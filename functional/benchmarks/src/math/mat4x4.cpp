@@ -0,0 +1,94 @@
+#include <pch/pch.hpp>
+#include <cmath>
+#include <vector>
+#include <math/mat4x4.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const UInt32 count = 10000;
+	struct Transform
+	{
+		FQuat rot;
+		FVec3 scl;
+		FVec3 pos;
+	};
+	std::vector<Transform> transforms( )
+	{
+		std::vector<Transform> ts( count );
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			const float a = i * 0.001f;
+			ts[i] = Transform{ FQuat( sinf( a ), 0.0f, 0.0f, cosf( a ) ),
+				FVec3{ 1.0f, 1.0f + a, 1.0f }, FVec3{ a, -a, 2.0f * a } };
+		}
+		return ts;
+	}
+	// checksum, so that no variant is optimized out
+	float sum( const Mat4x4& mat )
+	{
+		return mat.m[0][0] + mat.m[1][1] + mat.m[2][2] + mat.m[3][0];
+	}
+}
+
+// per actor matrix work of a frame, world = local * parent and the view inverse, scalar
+// kernels against the compile-time selected ones
+HP_BENCHMARK( mat4x4 )
+{
+	const auto ts = transforms( );
+	const Mat4x4 parent = rotSclPosToMat4x4( FQuat( 0.1f, 0.2f, 0.3f, 0.927f ),
+		FVec3{ 2.0f, 2.0f, 2.0f }, FVec3{ 1.0f, 2.0f, 3.0f } );
+	float checksum = 0.0f;
+	report_IO( "local * parent scalar", count, measureNs_IO( [&ts, &parent, &checksum]
+	{
+		for ( const auto& t : ts )
+		{
+			checksum += sum( mulScalar( rotSclPosToMat4x4( t.rot, t.scl, t.pos ), parent ) );
+		}
+	} ) / count );
+	report_IO( "local * parent simd", count, measureNs_IO( [&ts, &parent, &checksum]
+	{
+		for ( const auto& t : ts )
+		{
+			checksum += sum( mul( rotSclPosToMat4x4( t.rot, t.scl, t.pos ), parent ) );
+		}
+	} ) / count );
+	report_IO( "fused local parent", count, measureNs_IO( [&ts, &parent, &checksum]
+	{
+		for ( const auto& t : ts )
+		{
+			checksum += sum( rotSclPosToMat4x4( t.rot, t.scl, t.pos, parent ) );
+		}
+	} ) / count );
+	std::vector<Mat4x4> mats;
+	for ( const auto& t : ts )
+	{
+		mats.push_back( rotSclPosToMat4x4( t.rot, t.scl, t.pos, parent ) );
+	}
+	report_IO( "inverse scalar", count, measureNs_IO( [&mats, &checksum]
+	{
+		for ( const auto& mat : mats )
+		{
+			checksum += sum( inverseScalar( mat ) );
+		}
+	} ) / count );
+	report_IO( "inverse", count, measureNs_IO( [&mats, &checksum]
+	{
+		for ( const auto& mat : mats )
+		{
+			checksum += sum( inverse( mat ) );
+		}
+	} ) / count );
+	report_IO( "affineInverse", count, measureNs_IO( [&mats, &checksum]
+	{
+		for ( const auto& mat : mats )
+		{
+			checksum += sum( affineInverse( mat ) );
+		}
+	} ) / count );
+	if ( checksum != checksum )
+	{
+		printf( "  unexpected result\n" );
+	}
+}
@@ -0,0 +1,159 @@
+#include <pch/pch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <math/quat.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const UInt32 count = 10000;
+	// twelve sin and cos calls, as eulerRadToQuat computed it before
+	FQuat referenceEulerRadToQuat( const FVec3& vec )
+	{
+		return FQuat(
+			sinf( vec.y / 2.0f ) * cosf( vec.x / 2.0f ) * sinf( vec.z / 2.0f ) +
+			cosf( vec.y / 2.0f ) * sinf( vec.x / 2.0f ) * cosf( vec.z / 2.0f ),
+			sinf( vec.y / 2.0f ) * cosf( vec.x / 2.0f ) * cosf( vec.z / 2.0f ) -
+			cosf( vec.y / 2.0f ) * sinf( vec.x / 2.0f ) * sinf( vec.z / 2.0f ),
+			cosf( vec.y / 2.0f ) * cosf( vec.x / 2.0f ) * sinf( vec.z / 2.0f ) -
+			sinf( vec.y / 2.0f ) * sinf( vec.x / 2.0f ) * cosf( vec.z / 2.0f ),
+			cosf( vec.y / 2.0f ) * cosf( vec.x / 2.0f ) * cosf( vec.z / 2.0f ) +
+			sinf( vec.y / 2.0f ) * sinf( vec.x / 2.0f ) * sinf( vec.z / 2.0f ) );
+	}
+	// two quaternion products, as rotate computed it before
+	FVec3 referenceRotate( const FVec3& vec, const FQuat& quat )
+	{
+		const FQuat rotated = conjugate( quat ) * FQuat( vec.x, vec.y, vec.z, 0.0f ) * quat;
+		return FVec3{ rotated.x, rotated.y, rotated.z };
+	}
+	// small per tick angles of ball( ) and BallTransformComponent, every other one scaled to turns
+	std::vector<FVec3> angles( )
+	{
+		std::vector<FVec3> euler( count );
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			const float a = i * 0.001f;
+			euler[i] = FVec3{ sinf( a ) * 0.05f, a, -cosf( a ) * 0.05f } * ( i % 2 ? 1.0f : 60.0f );
+		}
+		return euler;
+	}
+	double error( const FQuat& a, const FQuat& b )
+	{
+		return std::max( std::max( fabs( a.x - b.x ), fabs( a.y - b.y ) ),
+			std::max( fabs( a.z - b.z ), fabs( a.w - b.w ) ) );
+	}
+	double error( const FVec3& a, const FVec3& b )
+	{
+		return std::max( std::max( fabs( a.x - b.x ), fabs( a.y - b.y ) ), fabs( a.z - b.z ) );
+	}
+}
+
+// Euler angles to quaternions and vector rotation of the ball update, the previous scalar
+// versions against the current ones and the array versions, followed by the max abs error of
+// each against a double precision reference
+HP_BENCHMARK( quat )
+{
+	const auto euler = angles( );
+	std::vector<FQuat> quats( count );
+	std::vector<FVec3> vecs( count );
+	std::vector<FVec3> rotated( count );
+	for ( UInt32 i = 0; i < count; ++i )
+	{
+		quats[i] = eulerRadToQuat( euler[i] );
+		vecs[i] = FVec3{ euler[i].z, 1.0f, euler[i].x };
+	}
+	float checksum = 0.0f;
+	report_IO( "eulerRadToQuat previous", count, measureNs_IO( [&euler, &checksum]
+	{
+		for ( const auto& e : euler )
+		{
+			checksum += referenceEulerRadToQuat( e ).w;
+		}
+	} ) / count );
+	report_IO( "eulerRadToQuat", count, measureNs_IO( [&euler, &checksum]
+	{
+		for ( const auto& e : euler )
+		{
+			checksum += eulerRadToQuat( e ).w;
+		}
+	} ) / count );
+	std::vector<FQuat> out( count );
+	report_IO( "eulerRadToQuat_IO precise", count, measureNs_IO( [&euler, &out]
+	{
+		eulerRadToQuat_IO( euler.data( ), count, out.data( ), TrigAccuracy::Precise );
+	} ) / count );
+	report_IO( "eulerRadToQuat_IO fast", count, measureNs_IO( [&euler, &out]
+	{
+		eulerRadToQuat_IO( euler.data( ), count, out.data( ), TrigAccuracy::Fast );
+	} ) / count );
+	report_IO( "rotate previous", count, measureNs_IO( [&vecs, &quats, &checksum]
+	{
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			checksum += referenceRotate( vecs[i], quats[i] ).x;
+		}
+	} ) / count );
+	report_IO( "rotate", count, measureNs_IO( [&vecs, &quats, &checksum]
+	{
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			checksum += rotate( vecs[i], quats[i] ).x;
+		}
+	} ) / count );
+	report_IO( "rotate_IO", count, measureNs_IO( [&vecs, &quats, &rotated]
+	{
+		rotate_IO( vecs.data( ), quats.data( ), count, rotated.data( ) );
+	} ) / count );
+	// accuracy against double precision sin and cos and quaternion products
+	double previousError = 0.0, currentError = 0.0, preciseError = 0.0, fastError = 0.0;
+	std::vector<FQuat> precise( count ), fast( count );
+	eulerRadToQuat_IO( euler.data( ), count, precise.data( ), TrigAccuracy::Precise );
+	eulerRadToQuat_IO( euler.data( ), count, fast.data( ), TrigAccuracy::Fast );
+	for ( UInt32 i = 0; i < count; ++i )
+	{
+		const double sx = sin( euler[i].x / 2.0 ), cx = cos( euler[i].x / 2.0 );
+		const double sy = sin( euler[i].y / 2.0 ), cy = cos( euler[i].y / 2.0 );
+		const double sz = sin( euler[i].z / 2.0 ), cz = cos( euler[i].z / 2.0 );
+		const FQuat exact(
+			static_cast<float>( sy * cx * sz + cy * sx * cz ),
+			static_cast<float>( sy * cx * cz - cy * sx * sz ),
+			static_cast<float>( cy * cx * sz - sy * sx * cz ),
+			static_cast<float>( cy * cx * cz + sy * sx * sz ) );
+		previousError = std::max( previousError, error( exact,
+			referenceEulerRadToQuat( euler[i] ) ) );
+		currentError = std::max( currentError, error( exact, eulerRadToQuat( euler[i] ) ) );
+		preciseError = std::max( preciseError, error( exact, precise[i] ) );
+		fastError = std::max( fastError, error( exact, fast[i] ) );
+	}
+	reportError_IO( "eulerRadToQuat previous", count, previousError );
+	reportError_IO( "eulerRadToQuat", count, currentError );
+	reportError_IO( "eulerRadToQuat_IO precise", count, preciseError );
+	reportError_IO( "eulerRadToQuat_IO fast", count, fastError );
+	previousError = currentError = 0.0;
+	double arrayError = 0.0;
+	for ( UInt32 i = 0; i < count; ++i )
+	{
+		// v + 2 w ( u x v ) + 2 u x ( u x v ) in double precision
+		const double ux = quats[i].x, uy = quats[i].y, uz = quats[i].z, w = quats[i].w;
+		const double vx = vecs[i].x, vy = vecs[i].y, vz = vecs[i].z;
+		const double tx = 2.0 * ( uy * vz - uz * vy );
+		const double ty = 2.0 * ( uz * vx - ux * vz );
+		const double tz = 2.0 * ( ux * vy - uy * vx );
+		const FVec3 exact{ static_cast<float>( vx + w * tx + uy * tz - uz * ty ),
+			static_cast<float>( vy + w * ty + uz * tx - ux * tz ),
+			static_cast<float>( vz + w * tz + ux * ty - uy * tx ) };
+		previousError = std::max( previousError, error( exact, referenceRotate( vecs[i],
+			quats[i] ) ) );
+		currentError = std::max( currentError, error( exact, rotate( vecs[i], quats[i] ) ) );
+		arrayError = std::max( arrayError, error( exact, rotated[i] ) );
+	}
+	reportError_IO( "rotate previous", count, previousError );
+	reportError_IO( "rotate", count, currentError );
+	reportError_IO( "rotate_IO", count, arrayError );
+	if ( checksum != checksum || out[0].w != out[0].w )
+	{
+		printf( "  unexpected result\n" );
+	}
+}
@@ -0,0 +1,90 @@
+#include <pch/pch.hpp>
+#include <cmath>
+#include <vector>
+#include <math/transformBatch.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	// the commented stress scene of example 1 scaled up, balls on a circle, each with one
+	// child like the camera of the player's ball
+	const UInt32 ballCount = 4096;
+	struct Node
+	{
+		FVec3 pos;
+		FVec3 scl;
+		FQuat rot;
+		std::vector<Node> children;
+	};
+	FQuat rotAt( const UInt32 i )
+	{
+		const float a = 0.5f * i * 0.001f;
+		return FQuat( 0.0f, sinf( a ), 0.0f, cosf( a ) );
+	}
+	std::vector<Node> scene( )
+	{
+		std::vector<Node> balls;
+		for ( UInt32 i = 0; i < ballCount; ++i )
+		{
+			const float a = i * TWO_PI_F / ballCount;
+			const FVec3 pos{ sinf( a ) * 10.0f, 0.45f + ( i % 64 ) / 32.0f, cosf( a ) * 10.0f };
+			const Node child{ FVec3{ 0.0f, 2.0f, -7.0f }, FVec3{ 1.0f, 1.0f, 1.0f },
+				FQuat::identity, { } };
+			balls.push_back( Node{ pos, FVec3{ 1.0f, 1.0f, 1.0f }, rotAt( i ), { child } } );
+		}
+		return balls;
+	}
+	// per actor recursion of the engines, local matrix times the parent's world matrix
+	void recurse_IO( const std::vector<Node>& nodes, const Mat4x4& parent,
+		std::vector<Mat4x4>& world )
+	{
+		for ( const auto& node : nodes )
+		{
+			const Mat4x4 transform = rotSclPosToMat4x4( node.rot, node.scl, node.pos ) * parent;
+			world.push_back( transform );
+			recurse_IO( node.children, transform, world );
+		}
+	}
+	// level by level, so that all balls come before their children
+	TransformBatch batch( const std::vector<Node>& nodes )
+	{
+		TransformBatch b;
+		for ( const auto& node : nodes )
+		{
+			push_IO( b, node.pos, node.rot, node.scl );
+		}
+		for ( UInt32 i = 0; i < nodes.size( ); ++i )
+		{
+			for ( const auto& child : nodes[i].children )
+			{
+				push_IO( b, child.pos, child.rot, child.scl, i );
+			}
+		}
+		return b;
+	}
+}
+
+// world matrices of 4096 balls with a child each, matrices per second
+HP_BENCHMARK( transformBatch )
+{
+	const auto nodes = scene( );
+	const auto b = batch( nodes );
+	const UInt32 count = size( b );
+	std::vector<Mat4x4> world;
+	world.reserve( count );
+	reportRate_IO( "recursion", count, count * 1e9 / measureNs_IO( [&nodes, &world]
+	{
+		world.clear( );
+		recurse_IO( nodes, Mat4x4::identity, world );
+	} ) );
+	world.resize( count );
+	reportRate_IO( "batch scalar", count, count * 1e9 / measureNs_IO( [&b, &world]
+	{
+		worldTransformsScalar_IO( b, world.data( ) );
+	} ) );
+	reportRate_IO( "batch", count, count * 1e9 / measureNs_IO( [&b, &world]
+	{
+		worldTransforms_IO( b, world.data( ) );
+	} ) );
+}
@@ -0,0 +1,66 @@
+#include <pch/pch.hpp>
+#include <array>
+#include <functional>
+#include <utils/inplaceFn.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const UInt32 count = 4096;
+	// closure of Size bytes, typical S closures capture 16 to 64 bytes
+	template<UInt32 Size>
+	struct Closure
+	{
+		std::array<float, Size / sizeof( float )> vals;
+		float operator () ( const float deltaMs ) const
+		{
+			return vals[0] + deltaMs;
+		}
+	};
+	template<typename Fn, UInt32 Size>
+	void measure_IO( const char* copyName, const char* callName )
+	{
+		Closure<Size> closure;
+		closure.vals.fill( 1.0f );
+		const Fn fn( closure );
+		std::vector<Fn> fns( count, fn );
+		report_IO( copyName, Size, measureNs_IO( [&]
+		{
+			for ( auto& f : fns )
+			{
+				f.~Fn( );
+				new ( &f ) Fn( fn );
+			}
+		} ) / count );
+		float sum = 0.0f;
+		report_IO( callName, Size, measureNs_IO( [&]
+		{
+			for ( auto& f : fns )
+			{
+				sum += f( 1.0f );
+			}
+		} ) / count );
+		if ( sum == 0.0f )
+		{
+			printf( "  unexpected sum\n" );
+		}
+	}
+	template<UInt32 Size>
+	void measureSize_IO( )
+	{
+		measure_IO<std::function<float( const float )>, Size>( "std::function copy",
+			"std::function call" );
+		measure_IO<InplaceFn<float( const float )>, Size>( "InplaceFn copy", "InplaceFn call" );
+		measure_IO<SharedFn<float( const float )>, Size>( "SharedFn copy", "SharedFn call" );
+	}
+}
+
+// count column is the closure size in bytes
+HP_BENCHMARK( inplaceFn )
+{
+	measureSize_IO<8>( );
+	measureSize_IO<32>( );
+	measureSize_IO<64>( );
+	measureSize_IO<128>( );
+}
@@ -0,0 +1,175 @@
+#include <pch/pch.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <adt/list.hpp>
+#include <adt/vector.hpp>
+#include <utils/pool.hpp>
+#include "../benchmark.hpp"
+using namespace hp_fp;
+
+namespace
+{
+	const UInt32 frameItems = 1000;
+	// list items as List allocated them before, make_shared with atomic count
+	struct SharedItem
+	{
+		SharedItem( const Int32 val, const std::shared_ptr<const SharedItem>& next )
+			: val( val ), next( next )
+		{ }
+		Int32 val;
+		std::shared_ptr<const SharedItem> next;
+	};
+	template<typename RefCount>
+	void pushFrame_IO( const List<Int32, RefCount>& base )
+	{
+		List<Int32, RefCount> l = base;
+		for ( UInt32 i = 0; i < frameItems; ++i )
+		{
+			const Int32 a = i;
+			l = l.push( a );
+		}
+	}
+	template<typename RefCount>
+	void copyFrame_IO( const List<Int32, RefCount>& base )
+	{
+		for ( UInt32 i = 0; i < frameItems; ++i )
+		{
+			const List<Int32, RefCount> copy = base;
+		}
+	}
+	const UInt32 vectorSize = 4096;
+	// atomic operations of CountedRefCount, benchmarks run on one thread
+	UInt64 countedAtomics = 0;
+	// AtomicRefCount which counts its atomic operations
+	struct CountedRefCount
+	{
+		void increment( )
+		{
+			++countedAtomics;
+			count.increment( );
+		}
+		bool decrement( )
+		{
+			++countedAtomics;
+			return count.decrement( );
+		}
+		UInt32 get( ) const
+		{
+			return count.get( );
+		}
+		AtomicRefCount count;
+	};
+	template<typename RefCount>
+	Vector<Int32, RefCount> vectorOf( )
+	{
+		std::vector<Int32> vals( vectorSize );
+		for ( UInt32 i = 0; i < vectorSize; ++i )
+		{
+			vals[i] = i;
+		}
+		return Vector<Int32, RefCount>( vals.begin( ), vals.end( ) );
+	}
+	// one value of each of frameItems actors spread over the whole vector
+	template<typename RefCount>
+	void updateFrame_IO( Vector<Int32, RefCount>& v )
+	{
+		for ( UInt32 i = 0; i < frameItems; ++i )
+		{
+			const UInt32 j = i * 37 % vectorSize;
+			v = v.update( j, v[j] + 1 );
+		}
+	}
+	// atomic operations, of the counts and of the pool depot, and system allocations per item
+	// of a frame, the frames before warm up the pool
+	void reportFrameEvents_IO( const char* variant, const std::function<void( )>& frame )
+	{
+		const UInt32 frames = 100;
+		frame( );
+		const PoolStats before = poolStats_IO( );
+		const UInt64 atomicsBefore = countedAtomics;
+		for ( UInt32 i = 0; i < frames; ++i )
+		{
+			frame( );
+		}
+		const PoolStats after = poolStats_IO( );
+		const double items = static_cast<double>( frames ) * frameItems;
+		reportEvents_IO( variant, frameItems, ( countedAtomics - atomicsBefore +
+			after.depotTrips - before.depotTrips ) / items, "atomics" );
+		reportEvents_IO( variant, frameItems,
+			( after.systemAllocations - before.systemAllocations ) / items, "system allocations" );
+	}
+}
+
+// count column is the number of items pushed or copies made per frame, times and allocations
+// are per item, a frame which drops all it pushes allocates nothing once the slabs exist
+HP_BENCHMARK( poolListFrame )
+{
+	const List<Int32> local{ 1, 2, 3 };
+	const List<Int32, AtomicRefCount> atomic{ 1, 2, 3 };
+	const auto shared = std::make_shared<const SharedItem>( 1, nullptr );
+	auto sharedPush = [&shared]
+	{
+		std::shared_ptr<const SharedItem> l = shared;
+		for ( UInt32 i = 0; i < frameItems; ++i )
+		{
+			l = std::make_shared<const SharedItem>( static_cast<Int32>( i ), l );
+		}
+	};
+	auto localPush = [&local]
+	{
+		pushFrame_IO( local );
+	};
+	auto atomicPush = [&atomic]
+	{
+		pushFrame_IO( atomic );
+	};
+	report_IO( "make_shared push", frameItems, measureNs_IO( sharedPush ) / frameItems );
+	reportAllocations_IO( "make_shared push", frameItems,
+		measureAllocations_IO( sharedPush ) / frameItems );
+	report_IO( "pool local push", frameItems, measureNs_IO( localPush ) / frameItems );
+	reportAllocations_IO( "pool local push", frameItems,
+		measureAllocations_IO( localPush ) / frameItems );
+	report_IO( "pool atomic push", frameItems, measureNs_IO( atomicPush ) / frameItems );
+	reportAllocations_IO( "pool atomic push", frameItems,
+		measureAllocations_IO( atomicPush ) / frameItems );
+	report_IO( "shared_ptr copy", frameItems, measureNs_IO( [&shared]
+	{
+		for ( UInt32 i = 0; i < frameItems; ++i )
+		{
+			const std::shared_ptr<const SharedItem> copy = shared;
+		}
+	} ) / frameItems );
+	report_IO( "local copy", frameItems, measureNs_IO( [&local]
+	{
+		copyFrame_IO( local );
+	} ) / frameItems );
+	report_IO( "atomic copy", frameItems, measureNs_IO( [&atomic]
+	{
+		copyFrame_IO( atomic );
+	} ) / frameItems );
+}
+
+// count column is the number of vector elements updated per frame, each update copies the
+// path to its leaf, which the next update of the same leaf frees again
+HP_BENCHMARK( poolVectorFrame )
+{
+	auto local = vectorOf<LocalRefCount>( );
+	auto atomic = vectorOf<CountedRefCount>( );
+	auto localUpdate = [&local]
+	{
+		updateFrame_IO( local );
+	};
+	auto atomicUpdate = [&atomic]
+	{
+		updateFrame_IO( atomic );
+	};
+	report_IO( "local update", frameItems, measureNs_IO( localUpdate ) / frameItems );
+	reportAllocations_IO( "local update", frameItems,
+		measureAllocations_IO( localUpdate ) / frameItems );
+	reportFrameEvents_IO( "local update", localUpdate );
+	report_IO( "atomic update", frameItems, measureNs_IO( atomicUpdate ) / frameItems );
+	reportAllocations_IO( "atomic update", frameItems,
+		measureAllocations_IO( atomicUpdate ) / frameItems );
+	reportFrameEvents_IO( "atomic update", atomicUpdate );
+}
@@ -272,38 +272,56 @@ float ab( const float& a )
 {
 	return abs( a );
 }
-SF<ActorInput, ActorOutput> bouncingBall( )
-{
-	return SF < ActorInput, ActorOutput >
-	{
-		[]( const S<ActorInput>& input ) -> S < ActorOutput >
-		{
-			static const float rotSpeed = 0.003f;
-			auto state = arr( getState ) < input;
-			auto gi = arr( getGameInput ) < input;
-			S<FQuat> rot = mul( arr( getRot ) < state ) < arr( eulerRadToQuat<float> )
-				< arrAlt<float, FVec3>( conFVec3fromY( ) )
-				< integral<float>( ) < rotSpeed;
-			//S<float> velY = arr( getY ) < arr( getVel ) < state;
-			S<float> velY =
-				// add last velY
-				add( arr( getY ) < arr( getVel ) < state )
-				// add gravity
-				< integral<float>( ) < -0.00000981f;
-			S<float> velY2 =
-				// set velY to zero if posY is lower than 0.45f
-				mul( arrAlt<bool, float>( ifElse( -1.0f, 1.0f ) )
-				< and( arrAlt<float, bool>( lte( 0.45f ) )
-				< arr( getY ) < arr( getPos ) < state )
-				< arrAlt<float, bool>( lt( 0.0f ) ) < velY ) < velY;
-			S<FVec3> vel = arrAlt<float, FVec3>( conFVec3fromY( ) ) < velY2;
-			S<FVec3> pos = arrAlt<FVec3, FVec3>( minY( 0.45f ) )
-				< add( integral<FVec3>( ) < vel )
-				< arr( getPos ) < state;
-			return arr( conActorOutput ) < setRot( rot ) < setVel( vel )
-				< setPos( pos ) < state;
-		}
-	};
+ActorState withPos( const FVec3& pos, const ActorState& state )
+{
+	auto newState = state;
+	newState.pos = pos;
+	return newState;
+}
+ActorState withVel( const FVec3& vel, const ActorState& state )
+{
+	auto newState = state;
+	newState.vel = vel;
+	return newState;
+}
+ActorState withRot( const FQuat& rot, const ActorState& state )
+{
+	auto newState = state;
+	newState.rot = rot;
+	return newState;
+}
+bool both( const bool a, const bool b )
+{
+	return a && b;
+}
+BatchSF<ActorInput, ActorOutput> bouncingBall( )
+{
+	// network is built once on the input slot, all balls share its batch tape
+	static const float rotSpeed = 0.003f;
+	auto input = fused::input<ActorInput>( );
+	auto state = fused::member( &ActorInput::state ) < input;
+	auto rot = fused::mul( fused::member( &ActorState::rot ) < state )
+		< fused::arr( eulerRadToQuat<float> )
+		< fused::arr( conFVec3fromY( ) )
+		< fused::integral( ) < rotSpeed;
+	auto velY =
+		// add last velY
+		fused::add( fused::arr( getY ) < fused::member( &ActorState::vel ) < state )
+		// add gravity
+		< fused::integral( ) < -0.00000981f;
+	auto velY2 =
+		// set velY to zero if posY is lower than 0.45f
+		fused::mul( fused::arr( ifElse( -1.0f, 1.0f ) )
+		< fused::lift2( both, fused::arr( lte( 0.45f ) )
+		< fused::arr( getY ) < fused::member( &ActorState::pos ) < state )
+		< fused::arr( lt( 0.0f ) ) < velY ) < velY;
+	auto vel = fused::arr( conFVec3fromY( ) ) < velY2;
+	auto pos = fused::arr( minY( 0.45f ) )
+		< fused::add( fused::integral( ) < vel )
+		< fused::member( &ActorState::pos ) < state;
+	return fused::batch( input, fused::arr( conActorOutput )
+		< fused::lift2( withRot, rot ) < fused::lift2( withVel, vel )
+		< fused::lift2( withPos, pos ) < state );
 }
 SF<ActorInput, ActorOutput> ball( )
 {
@@ -317,10 +335,11 @@ SF<ActorInput, ActorOutput> ball( )
 			static const float minPosX = 0.45f;
 			static const float gravity = -0.00000981f;
 			static const float cor = -0.5f; // coefficient of restitution
-			auto state = arr( getState ) < input;
-			auto gi = arr( getGameInput ) < input;
-			S<bool> onTheGround = arrAlt<float, bool>( eq( minPosX ) )
-				< arr( getY ) < arr( getPos ) < state;
+			// signals sampled by several consumers are shared to be evaluated once per tick
+			auto state = share( arr( getState ) < input );
+			auto gi = share( arr( getGameInput ) < input );
+			S<float> posY = share( arr( getY ) < arr( getPos ) < state );
+			S<bool> onTheGround = share( arrAlt<float, bool>( eq( minPosX ) ) < posY );
 			S<float> accZForward = arrAlt<bool, float>( ifElse( acceleration, 0.0f ) )
 				< and( onTheGround )
 				< arrAlt<GameInput, bool>( getInputState( Key::W ) ) < gi;
@@ -341,9 +360,9 @@ SF<ActorInput, ActorOutput> ball( )
 				< and( onTheGround )
 				< arrAlt<GameInput, bool>( getInputState( Key::Space ) ) < gi;
 			// rotation
-			S<FQuat> rot = mul( arr( getRot ) < state ) < arr( eulerRadToQuat<float> )
+			S<FQuat> rot = share( mul( arr( getRot ) < state ) < arr( eulerRadToQuat<float> )
 				< arrAlt<float, FVec3>( conFVec3fromY( ) )
-				< integral<float>( ) < add( angVelZLeft ) < angVelZRight;
+				< integral<float>( ) < add( angVelZLeft ) < angVelZRight );
 			// acceleration
 			S<FVec3> accZ = arrAlt<float, FVec3>( conFVec3fromZ( ) )
 				< add( accZForward ) < accZBackward;
@@ -392,33 +411,32 @@ SF<ActorInput, ActorOutput> ball( )
 
 			//auto ball = sw(fallingBall, bouncingBall); */
 
-			S<float> velY =
+			S<float> velY = share(
 				// add last velY
 				add( arr( getY ) < arr( getVel ) < state )
 				// add gravity and jump
-				< add( velYUp ) < integral<float>( ) < gravity;
-			S<float> velY2 =
+				< add( velYUp ) < integral<float>( ) < gravity );
+			S<bool> belowGround = share( arrAlt<float, bool>( lte( minPosX ) ) < posY );
+			S<float> velY2 = share(
 				// set velY to zero if posY is lower than minPosX
 				mul( arrAlt<bool, float>( ifElse( cor, 1.0f ) )
-				< and( arrAlt<float, bool>( lte( minPosX ) )
-				< arr( getY ) < arr( getPos ) < state )
-				< arrAlt<float, bool>( lt( 0.0f ) ) < velY ) < velY;
+				< and( belowGround )
+				< arrAlt<float, bool>( lt( 0.0f ) ) < velY ) < velY );
 			// stop ball from jumping when velocity is low
 			S<float> velY3 = mul( arrAlt<bool, float>( ifElse( 0.0f, 1.0f ) )
-				< and( arrAlt<float, bool>( lte( minPosX ) )
-				< arr( getY ) < arr( getPos ) < state )
+				< and( belowGround )
 				< arrAlt<float, bool>( lt( 0.001f ) ) < arr( ab ) < velY2 ) < velY2;
 
 			// add integral of acceleration to velocity, then damp and clamp it
-			S<FVec3> vel = setY( velY3 ) < clampMag( 0.01f ) < mul<FVec3>( 0.999f )
-				< add( integral<FVec3>( ) < acc ) < arr( getVel ) < state;
+			S<FVec3> vel = share( setY( velY3 ) < clampMag( 0.01f ) < mul<FVec3>( 0.999f )
+				< add( integral<FVec3>( ) < acc ) < arr( getVel ) < state );
 			// add oriented integral of velocity to position
 			S<FVec3> pos = arrAlt<FVec3, FVec3>( minY( minPosX ) )
 				< add( rotate( rot ) < integral<FVec3>( ) < vel )
 				< arr( getPos ) < state;
 
-			auto newState = setRot( rot ) < setVel( vel )
-				< setPos( pos ) < state;
+			auto newState = share( setRot( rot ) < setVel( vel )
+				< setPos( pos ) < state );
 			// model rotation
 			auto modelRot = mul( arr( getModelRot ) < newState ) < arr( rollBall )
 				< integral<FVec3>( ) < vel;
@@ -523,13 +541,6 @@ SF<ActorInput, ActorOutput> ball( )
 //		return ActorOutput{ state };
 //	} );
 //}
-SF<ActorInput, ActorOutput> staticActor( )
-{
-	return arr<ActorInput, ActorOutput>( []( const ActorInput& input )
-	{
-		return ActorOutput{ input.state };
-	} );
-}
 InitCamRenderFn initCameraRenderFn( )
 {
 	return []( const ActorCameraDef& cameraDef, const WindowConfig& windowConfig )
@@ -621,6 +632,7 @@ int main( )
 	};
 	//const int I = 64;
 	//const int I_HALF = 32;
+	//const auto bouncingBallSF = bouncingBall( );
 	//for ( int i = 0; i < I; ++i )
 	//{
 	//	float y = ( abs( i - I_HALF ) / static_cast<float>( I_HALF ) );
@@ -645,8 +657,9 @@ int main( )
 	//			FQuat::identity, // rot
 	//			FQuat::identity // modelRot
 	//		},
-	//		bouncingBall( ), // sf
-	//		{ } // children
+	//		bouncingBallSF.sf, // sf
+	//		{ }, // children
+	//		bouncingBallSF.tape // batch
 	//	} );
 	//}
 
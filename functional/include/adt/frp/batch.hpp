@@ -0,0 +1,655 @@
+#pragma once
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <xmmintrin.h>
+#if defined( __AVX__ )
+#include <immintrin.h>
+#endif
+#include "tape.hpp"
+#include "../../utils/inplaceFn.hpp"
+// Evaluation of one fused signal network over many actors at once. Every value of the
+// network is an array with one lane per actor, so each op runs over whole arrays.
+// Arithmetic on float and FVec3 lanes runs 4 ( SSE ) floats at a time, or 8 when the compiler
+// targets AVX. The vs2013 projects do not enable AVX, so they build the 4 wide path.
+// Members of the input selected with fused::member get arrays of their own, members of a
+// type shared by all actors, and values computed only from them, are single uniform values.
+namespace hp_fp
+{
+	// lanes evaluated by one pass over the ops
+	const UInt32 BATCH_CHUNK_SIZE = 256;
+	// floats per SIMD instruction of the lane arithmetic
+#if defined( __AVX__ )
+	const UInt32 BATCH_SIMD_WIDTH = 8;
+#else
+	const UInt32 BATCH_SIMD_WIDTH = 4;
+#endif
+	struct BatchOp
+	{
+		void( *eval )( const BatchOp& op, UInt8* const* lanes, const UInt32 count,
+			const float deltaMs );
+		// slot indices
+		UInt32 out;
+		UInt32 fn;
+		UInt32 a;
+		UInt32 b;
+		// evaluated once for all lanes
+		bool uniform;
+	};
+	struct BatchSlot
+	{
+		UInt32 size;
+		UInt32 align;
+		// single value shared by all lanes, e.g. function object of an op
+		bool uniform;
+		std::function<void( UInt8* lanes, const UInt32 count )> construct;
+		void( *destroy )( UInt8* lanes, const UInt32 count );
+	};
+	// values of an input member stride bytes apart, a stride of 0 repeats one value
+	struct BatchView
+	{
+		const UInt8* first;
+		size_t stride;
+	};
+	// member of the tape input at offset, loaded into the lanes of slot
+	struct BatchInput
+	{
+		UInt32 slot;
+		UInt32 offset;
+		UInt32 size;
+		void( *load )( const BatchView& view, UInt8* lanes, const UInt32 count );
+	};
+	// view of the input member at offset of size bytes for all lanes of a sample
+	typedef InplaceFn<BatchView( const UInt32 offset, const UInt32 size )> BatchSource;
+	// members of a shared type are the same for all lanes and loaded once per sample,
+	// e.g. the game input of actors
+	template<typename A>
+	struct IsBatchShared : std::false_type
+	{ };
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  0  ][  0  ][  0  ][  0  ]
+	template<typename A, typename B>
+	struct BatchTape
+	{
+		BatchTape( std::vector<BatchOp>&& ops, std::vector<BatchSlot>&& slots,
+			std::vector<BatchInput>&& inputs, const UInt32 output )
+			: ops( std::move( ops ) ), slots( std::move( slots ) ), inputs( std::move( inputs ) ),
+			lanes( this->slots.size( ) ), views( this->inputs.size( ) ), output( output ),
+			capacity( 0 )
+		{ }
+		BatchTape( const BatchTape& ) = delete;
+		BatchTape operator = ( const BatchTape& ) = delete;
+		~BatchTape( )
+		{
+			if ( values.empty( ) )
+			{
+				return;
+			}
+			for ( UInt32 i = 0; i < slots.size( ); ++i )
+			{
+				slots[i].destroy( lanes[i], slots[i].uniform ? 1 : capacity );
+			}
+		}
+		std::vector<BatchOp> ops;
+		std::vector<BatchSlot> slots;
+		std::vector<BatchInput> inputs;
+		// first lane of every slot
+		std::vector<UInt8*> lanes;
+		// view of every input in the current sample
+		std::vector<BatchView> views;
+		std::vector<UInt64> values;
+		UInt32 output;
+		// lanes of every slot which is not uniform
+		UInt32 capacity;
+	};
+	// type-erased SF for the scalar path together with the batch tape of the same network,
+	// actors sharing the tape are evaluated together
+	template<typename A, typename B>
+	struct BatchSF
+	{
+		SF<A, B> sf;
+		std::shared_ptr<BatchTape<A, B>> tape;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	namespace fused
+	{
+		struct AddLanes
+		{
+			static __m128 sse( const __m128 a, const __m128 b )
+			{
+				return _mm_add_ps( a, b );
+			}
+#if defined( __AVX__ )
+			static __m256 avx( const __m256 a, const __m256 b )
+			{
+				return _mm256_add_ps( a, b );
+			}
+#endif
+			static float scalar( const float a, const float b )
+			{
+				return a + b;
+			}
+		};
+		struct SubLanes
+		{
+			static __m128 sse( const __m128 a, const __m128 b )
+			{
+				return _mm_sub_ps( a, b );
+			}
+#if defined( __AVX__ )
+			static __m256 avx( const __m256 a, const __m256 b )
+			{
+				return _mm256_sub_ps( a, b );
+			}
+#endif
+			static float scalar( const float a, const float b )
+			{
+				return a - b;
+			}
+		};
+		struct MulLanes
+		{
+			static __m128 sse( const __m128 a, const __m128 b )
+			{
+				return _mm_mul_ps( a, b );
+			}
+#if defined( __AVX__ )
+			static __m256 avx( const __m256 a, const __m256 b )
+			{
+				return _mm256_mul_ps( a, b );
+			}
+#endif
+			static float scalar( const float a, const float b )
+			{
+				return a * b;
+			}
+		};
+		// c[i] = op( a[i], b[i] ) over count floats
+		template<typename Op>
+		void zipLanes( const float* a, const float* b, float* c, const UInt32 count )
+		{
+			UInt32 i = 0;
+#if defined( __AVX__ )
+			for ( ; i + 8 <= count; i += 8 )
+			{
+				_mm256_storeu_ps( c + i, Op::avx( _mm256_loadu_ps( a + i ),
+					_mm256_loadu_ps( b + i ) ) );
+			}
+#endif
+			for ( ; i + 4 <= count; i += 4 )
+			{
+				_mm_storeu_ps( c + i, Op::sse( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) ) );
+			}
+			for ( ; i < count; ++i )
+			{
+				c[i] = Op::scalar( a[i], b[i] );
+			}
+		}
+		// b[i] = a[i] * s over count floats
+		inline void scaleLanes( const float* a, const float s, float* b, const UInt32 count )
+		{
+			UInt32 i = 0;
+#if defined( __AVX__ )
+			const __m256 s8 = _mm256_set1_ps( s );
+			for ( ; i + 8 <= count; i += 8 )
+			{
+				_mm256_storeu_ps( b + i, _mm256_mul_ps( _mm256_loadu_ps( a + i ), s8 ) );
+			}
+#endif
+			const __m128 s4 = _mm_set1_ps( s );
+			for ( ; i + 4 <= count; i += 4 )
+			{
+				_mm_storeu_ps( b + i, _mm_mul_ps( _mm_loadu_ps( a + i ), s4 ) );
+			}
+			for ( ; i < count; ++i )
+			{
+				b[i] = a[i] * s;
+			}
+		}
+		template<typename A>
+		inline void storeLane( A* lane, const A& a )
+		{
+			lane->~A( );
+			new ( lane ) A( a );
+		}
+		template<typename Fn, typename A, typename B>
+		void arrLanes( const Fn& fn, const A* a, B* b, const UInt32 count )
+		{
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				storeLane( b + i, fn( a[i] ) );
+			}
+		}
+		template<typename Fn, typename A, typename B, typename C>
+		void lift2Lanes( const Fn& fn, const A* a, const B* b, C* c, const UInt32 count )
+		{
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				storeLane( c + i, fn( a[i], b[i] ) );
+			}
+		}
+		inline void lift2Lanes( const Plus&, const float* a, const float* b, float* c,
+			const UInt32 count )
+		{
+			zipLanes<AddLanes>( a, b, c, count );
+		}
+		inline void lift2Lanes( const Plus&, const FVec3* a, const FVec3* b, FVec3* c,
+			const UInt32 count )
+		{
+			zipLanes<AddLanes>( &a->x, &b->x, &c->x, count * 3 );
+		}
+		inline void lift2Lanes( const Minus&, const float* a, const float* b, float* c,
+			const UInt32 count )
+		{
+			zipLanes<SubLanes>( a, b, c, count );
+		}
+		inline void lift2Lanes( const Minus&, const FVec3* a, const FVec3* b, FVec3* c,
+			const UInt32 count )
+		{
+			zipLanes<SubLanes>( &a->x, &b->x, &c->x, count * 3 );
+		}
+		inline void lift2Lanes( const Times&, const float* a, const float* b, float* c,
+			const UInt32 count )
+		{
+			zipLanes<MulLanes>( a, b, c, count );
+		}
+		template<typename A, typename B>
+		void integralLanes( const A* a, B* b, const UInt32 count, const float deltaMs )
+		{
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				storeLane( b + i, a[i] * deltaMs );
+			}
+		}
+		inline void integralLanes( const float* a, float* b, const UInt32 count,
+			const float deltaMs )
+		{
+			scaleLanes( a, deltaMs, b, count );
+		}
+		inline void integralLanes( const FVec3* a, FVec3* b, const UInt32 count,
+			const float deltaMs )
+		{
+			scaleLanes( &a->x, deltaMs, &b->x, count * 3 );
+		}
+		template<typename Fn, typename A, typename B>
+		void evalArrBatch( const BatchOp& op, UInt8* const* lanes, const UInt32 count,
+			const float deltaMs )
+		{
+			arrLanes( *reinterpret_cast<const Fn*>( lanes[op.fn] ),
+				reinterpret_cast<const A*>( lanes[op.a] ), reinterpret_cast<B*>( lanes[op.out] ),
+				count );
+		}
+		template<typename Fn, typename A, typename B, typename C>
+		void evalLift2Batch( const BatchOp& op, UInt8* const* lanes, const UInt32 count,
+			const float deltaMs )
+		{
+			lift2Lanes( *reinterpret_cast<const Fn*>( lanes[op.fn] ),
+				reinterpret_cast<const A*>( lanes[op.a] ), reinterpret_cast<const B*>( lanes[op.b] ),
+				reinterpret_cast<C*>( lanes[op.out] ), count );
+		}
+		template<typename A, typename B>
+		void evalIntegralBatch( const BatchOp& op, UInt8* const* lanes, const UInt32 count,
+			const float deltaMs )
+		{
+			integralLanes( reinterpret_cast<const A*>( lanes[op.a] ),
+				reinterpret_cast<B*>( lanes[op.out] ), count, deltaMs );
+		}
+		// copies of a uniform value for every lane
+		template<typename A>
+		void evalBroadcastBatch( const BatchOp& op, UInt8* const* lanes, const UInt32 count,
+			const float deltaMs )
+		{
+			const A& a = *reinterpret_cast<const A*>( lanes[op.a] );
+			A* b = reinterpret_cast<A*>( lanes[op.out] );
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				storeLane( b + i, a );
+			}
+		}
+		template<typename A>
+		void copyLanes( const BatchView& view, A* a, const UInt32 count, std::false_type )
+		{
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				storeLane( a + i, *reinterpret_cast<const A*>( view.first + i * view.stride ) );
+			}
+		}
+		// contiguous trivially copyable values are copied at once
+		template<typename A>
+		void copyLanes( const BatchView& view, A* a, const UInt32 count, std::true_type )
+		{
+			if ( view.stride == sizeof( A ) )
+			{
+				memcpy( a, view.first, count * sizeof( A ) );
+			}
+			else
+			{
+				copyLanes( view, a, count, std::false_type( ) );
+			}
+		}
+		template<typename A>
+		void loadLanes( const BatchView& view, UInt8* lanes, const UInt32 count )
+		{
+			copyLanes( view, reinterpret_cast<A*>( lanes ), count, std::is_trivially_copyable<A>( ) );
+		}
+		template<typename A>
+		void destroyLanes( UInt8* lanes, const UInt32 count )
+		{
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				reinterpret_cast<A*>( lanes )[i].~A( );
+			}
+		}
+		// slot holding a per lane copy of a, or a single copy when uniform
+		template<typename A>
+		UInt32 addBatchSlot( std::vector<BatchSlot>& slots, const A& a, const bool uniform )
+		{
+			static_assert( std::alignment_of<A>::value <= sizeof( UInt64 ),
+				"Batch values can be at most 8 byte aligned." );
+			BatchSlot slot{ sizeof( A ), std::alignment_of<A>::value, uniform,
+				[a]( UInt8* lanes, const UInt32 count )
+			{
+				for ( UInt32 i = 0; i < count; ++i )
+				{
+					new ( reinterpret_cast<A*>( lanes ) +i ) A( a );
+				}
+			}, &destroyLanes<A> };
+			slots.push_back( std::move( slot ) );
+			return static_cast<UInt32>( slots.size( ) - 1 );
+		}
+		template<typename A>
+		UInt32 addBatchSlot( std::vector<BatchSlot>& slots, const bool uniform = false )
+		{
+			return addBatchSlot( slots, A( ), uniform );
+		}
+		template<typename A, typename M>
+		UInt32 memberOffset( M A::* member )
+		{
+			// offsetof for member pointers, the storage is never read
+			typename std::aligned_storage<sizeof( A ), std::alignment_of<A>::value>::type a;
+			return static_cast<UInt32>( reinterpret_cast<const UInt8*>(
+				&( reinterpret_cast<const A*>( &a )->*member ) ) -
+				reinterpret_cast<const UInt8*>( &a ) );
+		}
+		// [const][cop-c][cop-a][mov-c][mov-a]
+		// [  +  ][  0  ][  0  ][  0  ][  0  ]
+		struct BatchBuilder
+		{
+			BatchBuilder( const void* inputSlot ) : inputSlot( inputSlot )
+			{ }
+			BatchBuilder( const BatchBuilder& ) = delete;
+			BatchBuilder operator = ( const BatchBuilder& ) = delete;
+			std::vector<BatchOp> ops;
+			std::vector<BatchSlot> slots;
+			std::vector<BatchInput> inputs;
+			// compiled nodes keyed like those of a tape, by the tape eval of the same op
+			std::vector<TapeNode> nodes;
+			const void* inputSlot;
+		};
+		// member of the tape input, uniform when it is a shared value or a member of one
+		struct InputPath
+		{
+			UInt32 offset;
+			bool uniform;
+		};
+		// nodes selecting members of the input only
+		template<typename F>
+		struct IsInputPath : std::false_type
+		{ };
+		template<typename A>
+		struct IsInputPath<InputNode<A>> : std::true_type
+		{ };
+		template<typename A, typename M, typename F>
+		struct IsInputPath<ArrNode<Member<A, M>, F>> : IsInputPath < F >
+		{ };
+		template<typename A>
+		UInt32 compileBatchNode( BatchBuilder& builder, const ConstantNode<A>& node )
+		{
+			TapeNode constant = { nullptr, &destroySlot<A>, 0, 0, { }, 0 };
+			const bool comparable = nodeBytes( node.a, constant.bytes );
+			return compileOnce( builder, std::move( constant ), comparable, [&builder, &node]
+			{
+				return addBatchSlot( builder.slots, node.a, false );
+			} );
+		}
+		template<typename A>
+		InputPath inputPath( const BatchBuilder& builder, const InputNode<A>& node )
+		{
+			// network can be compiled only with its own input
+			assert( builder.inputSlot == node.slot.get( ) );
+			return InputPath{ 0, IsBatchShared<A>::value };
+		}
+		template<typename A, typename M, typename F>
+		InputPath inputPath( const BatchBuilder& builder, const ArrNode<Member<A, M>, F>& node )
+		{
+			const InputPath path = inputPath( builder, node.a );
+			return InputPath{ path.offset + memberOffset( node.fn.member ),
+				path.uniform || IsBatchShared<M>::value };
+		}
+		// one slot per input member, loaded by sample_IO
+		template<typename A>
+		UInt32 compileBatchInput( BatchBuilder& builder, const InputPath& path )
+		{
+			for ( const auto& input : builder.inputs )
+			{
+				if ( input.offset == path.offset && input.load == &loadLanes<A> )
+				{
+					return input.slot;
+				}
+			}
+			const BatchInput input = { addBatchSlot<A>( builder.slots, path.uniform ), path.offset,
+				sizeof( A ), &loadLanes<A> };
+			builder.inputs.push_back( input );
+			return input.slot;
+		}
+		// slot with a value per lane, uniform ones are broadcast by an op
+		template<typename A>
+		UInt32 perLane( BatchBuilder& builder, const UInt32 slot )
+		{
+			if ( !builder.slots[slot].uniform )
+			{
+				return slot;
+			}
+			const BatchOp op = { &evalBroadcastBatch<A>, addBatchSlot<A>( builder.slots ), 0, slot,
+				0, false };
+			builder.ops.push_back( op );
+			return op.out;
+		}
+		template<typename A>
+		UInt32 compileBatchNode( BatchBuilder& builder, const InputNode<A>& node )
+		{
+			return compileBatchInput<A>( builder, inputPath( builder, node ) );
+		}
+		template<typename Fn, typename F>
+		UInt32 compileArrNode( BatchBuilder& builder, const ArrNode<Fn, F>& node )
+		{
+			typedef typename Sample<F>::type A;
+			typedef typename Sample<ArrNode<Fn, F>>::type B;
+			const UInt32 a = compileBatchNode( builder, node.a );
+			TapeNode arr = { &evalArr<Fn, A, B>, nullptr, a, 0, { }, 0 };
+			const bool comparable = nodeBytes( node.fn, arr.bytes );
+			return compileOnce( builder, std::move( arr ), comparable, [&builder, &node, a]
+			{
+				const bool uniform = builder.slots[a].uniform;
+				const UInt32 fn = addBatchSlot( builder.slots, node.fn, true );
+				const BatchOp op = { &evalArrBatch<Fn, A, B>,
+					addBatchSlot<B>( builder.slots, uniform ), fn, a, 0, uniform };
+				builder.ops.push_back( op );
+				return op.out;
+			} );
+		}
+		template<typename Fn, typename F>
+		UInt32 compileBatchNode( BatchBuilder& builder, const ArrNode<Fn, F>& node )
+		{
+			return compileArrNode( builder, node );
+		}
+		template<typename A, typename M, typename F>
+		UInt32 compileMemberNode( BatchBuilder& builder, const ArrNode<Member<A, M>, F>& node,
+			std::true_type )
+		{
+			return compileBatchInput<M>( builder, inputPath( builder, node ) );
+		}
+		template<typename A, typename M, typename F>
+		UInt32 compileMemberNode( BatchBuilder& builder, const ArrNode<Member<A, M>, F>& node,
+			std::false_type )
+		{
+			return compileArrNode( builder, node );
+		}
+		// members of the input are loaded directly into slots of their own
+		template<typename A, typename M, typename F>
+		UInt32 compileBatchNode( BatchBuilder& builder, const ArrNode<Member<A, M>, F>& node )
+		{
+			return compileMemberNode( builder, node, IsInputPath<F>( ) );
+		}
+		template<typename Fn, typename FA, typename FB>
+		UInt32 compileBatchNode( BatchBuilder& builder, const Lift2Node<Fn, FA, FB>& node )
+		{
+			typedef typename Sample<FA>::type A;
+			typedef typename Sample<FB>::type B;
+			typedef typename Sample<Lift2Node<Fn, FA, FB>>::type C;
+			const UInt32 a = compileBatchNode( builder, node.a );
+			const UInt32 b = compileBatchNode( builder, node.b );
+			// keyed by the slots before broadcast
+			TapeNode lift2 = { &evalLift2<Fn, A, B, C>, nullptr, a, b, { }, 0 };
+			const bool comparable = nodeBytes( node.fn, lift2.bytes );
+			return compileOnce( builder, std::move( lift2 ), comparable, [&builder, &node, a, b]
+			{
+				const bool uniform = builder.slots[a].uniform && builder.slots[b].uniform;
+				const UInt32 laneA = uniform ? a : perLane<A>( builder, a );
+				const UInt32 laneB = uniform ? b : perLane<B>( builder, b );
+				const UInt32 fn = addBatchSlot( builder.slots, node.fn, true );
+				const BatchOp op = { &evalLift2Batch<Fn, A, B, C>,
+					addBatchSlot<C>( builder.slots, uniform ), fn, laneA, laneB, uniform };
+				builder.ops.push_back( op );
+				return op.out;
+			} );
+		}
+		template<typename F>
+		UInt32 compileBatchNode( BatchBuilder& builder, const IntegralNode<F>& node )
+		{
+			typedef typename Sample<F>::type A;
+			typedef typename Sample<IntegralNode<F>>::type B;
+			const UInt32 a = compileBatchNode( builder, node.a );
+			TapeNode integral = { &evalIntegral<A, B>, nullptr, a, 0, { }, 0 };
+			return compileOnce( builder, std::move( integral ), true, [&builder, a]
+			{
+				const bool uniform = builder.slots[a].uniform;
+				const BatchOp op = { &evalIntegralBatch<A, B>,
+					addBatchSlot<B>( builder.slots, uniform ), 0, a, 0, uniform };
+				builder.ops.push_back( op );
+				return op.out;
+			} );
+		}
+		// compile signal network built on top of the input to a batch tape
+		template<typename A, typename F>
+		std::shared_ptr<BatchTape<A, typename Sample<F>::type>> compileBatch(
+			const S<InputNode<A>>& in, const S<F>& out )
+		{
+			BatchBuilder builder( in.f.slot.get( ) );
+			const UInt32 output = compileBatchNode( builder, out.f );
+			return std::make_shared<BatchTape<A, typename Sample<F>::type>>(
+				std::move( builder.ops ), std::move( builder.slots ), std::move( builder.inputs ),
+				output );
+		}
+		// scalar SF sampling a tape and batch tape of the same network
+		template<typename A, typename F>
+		BatchSF<A, typename Sample<F>::type> batch( const S<InputNode<A>>& in, const S<F>& out )
+		{
+			return BatchSF < A, typename Sample<F>::type > { compileSF( in, out ),
+				compileBatch( in, out ) };
+		}
+	}
+	// allocate lanes for at least count actors, the slots keep their lanes while count does not
+	// grow
+	template<typename A, typename B>
+	void reserve_IO( BatchTape<A, B>& tape, const UInt32 count )
+	{
+		if ( count <= tape.capacity )
+		{
+			return;
+		}
+		std::vector<UInt32> offsets( tape.slots.size( ) );
+		UInt32 size = 0;
+		for ( UInt32 i = 0; i < tape.slots.size( ); ++i )
+		{
+			const BatchSlot& slot = tape.slots[i];
+			if ( !tape.values.empty( ) )
+			{
+				slot.destroy( tape.lanes[i], slot.uniform ? 1 : tape.capacity );
+			}
+			// start every slot on 16 bytes for SIMD loads
+			offsets[i] = ( size + 15 ) / 16 * 16;
+			size = offsets[i] + slot.size * ( slot.uniform ? 1 : count );
+		}
+		tape.capacity = count;
+		tape.values.assign( ( size + 16 + sizeof( UInt64 ) - 1 ) / sizeof( UInt64 ), 0 );
+		// align buffer start to 16 bytes
+		UInt8* values = reinterpret_cast<UInt8*>( tape.values.data( ) );
+		values += ( 16 - reinterpret_cast<size_t>( values ) % 16 ) % 16;
+		for ( UInt32 i = 0; i < tape.slots.size( ); ++i )
+		{
+			tape.lanes[i] = values + offsets[i];
+			tape.slots[i].construct( tape.lanes[i], tape.slots[i].uniform ? 1 : count );
+		}
+	}
+	// sample count lanes in chunks of BATCH_CHUNK_SIZE, so that values of all ops stay in cache
+	// while the chunk is evaluated, the input members are read from the views of source
+	template<typename A, typename B>
+	void sample_IO( BatchTape<A, B>& tape, BatchSource source, B* outputs, const UInt32 count,
+		const float deltaMs )
+	{
+		if ( count == 0 )
+		{
+			return;
+		}
+		reserve_IO( tape, count < BATCH_CHUNK_SIZE ? count : BATCH_CHUNK_SIZE );
+		for ( UInt32 i = 0; i < tape.inputs.size( ); ++i )
+		{
+			const BatchInput& input = tape.inputs[i];
+			tape.views[i] = source( input.offset, input.size );
+			if ( tape.slots[input.slot].uniform )
+			{
+				input.load( tape.views[i], tape.lanes[input.slot], 1 );
+			}
+		}
+		const B* output = reinterpret_cast<const B*>( tape.lanes[tape.output] );
+		const bool uniformOutput = tape.slots[tape.output].uniform;
+		for ( UInt32 first = 0; first < count; first += tape.capacity )
+		{
+			const UInt32 lanes = count - first < tape.capacity ? count - first : tape.capacity;
+			for ( UInt32 i = 0; i < tape.inputs.size( ); ++i )
+			{
+				const BatchInput& input = tape.inputs[i];
+				if ( !tape.slots[input.slot].uniform )
+				{
+					const BatchView view = { tape.views[i].first + first * tape.views[i].stride,
+						tape.views[i].stride };
+					input.load( view, tape.lanes[input.slot], lanes );
+				}
+			}
+			for ( const auto& op : tape.ops )
+			{
+				op.eval( op, tape.lanes.data( ), op.uniform ? 1 : lanes, deltaMs );
+			}
+			for ( UInt32 i = 0; i < lanes; ++i )
+			{
+				fused::storeLane( outputs + first + i, output[uniformOutput ? 0 : i] );
+			}
+		}
+	}
+	// sample count inputs, members of shared types are read from the first one
+	template<typename A, typename B>
+	void sample_IO( BatchTape<A, B>& tape, const A* inputs, B* outputs, const UInt32 count,
+		const float deltaMs )
+	{
+		sample_IO( tape, BatchSource( [inputs]( const UInt32 offset, const UInt32 )
+		{
+			return BatchView{ reinterpret_cast<const UInt8*>( inputs ) + offset, sizeof( A ) };
+		} ), outputs, count, deltaMs );
+	}
+}
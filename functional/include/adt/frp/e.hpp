@@ -7,12 +7,12 @@ namespace hp_fp
 	template<typename A>
 	E<A> e( A&& a )
 	{
-		return E<A>( std::move( a ) );
+		return just( std::move( a ) );
 	}
 	template<typename A>
 	E<A> noE( )
 	{
-		return E<A>( );
+		return nothing<A>( );
 	}
 }
 
@@ -0,0 +1,473 @@
+#pragma once
+#include <memory>
+#include <tuple>
+#include <utility>
+#include "e.hpp"
+#include "sf.hpp"
+#include "../../math/vec3.hpp"
+#include "../../math/quat.hpp"
+// Signals and signal functions with concrete closure types. Composing them builds
+// a single nested type which the compiler can inline into one function, unlike
+// std::function based S and SF. Use erase to get S/SF at actor boundaries.
+namespace hp_fp
+{
+	namespace fused
+	{
+		template<typename F>
+		struct S
+		{
+			F f;
+			auto operator () ( const float deltaMs ) const -> decltype( f( deltaMs ) )
+			{
+				return f( deltaMs );
+			}
+			auto operator < ( const float deltaMs ) const -> decltype( f( deltaMs ) )
+			{
+				return f( deltaMs );
+			}
+		};
+		template<typename F>
+		struct Sample
+		{
+			typedef typename std::decay<decltype( std::declval<const F&>( )( 0.0f ) )>::type type;
+		};
+		template<typename A>
+		struct ConstantNode
+		{
+			A a;
+			A operator () ( const float deltaMs ) const
+			{
+				return a;
+			}
+		};
+		// mutable input slot of a signal network which is built once and sampled many times
+		template<typename A>
+		struct InputNode
+		{
+			std::shared_ptr<const A*> slot;
+			A operator () ( const float deltaMs ) const
+			{
+				return **slot;
+			}
+		};
+		template<typename G>
+		struct SF;
+		template<typename A>
+		struct IsFused : std::false_type
+		{ };
+		template<typename F>
+		struct IsFused<S<F>> : std::true_type
+		{ };
+		template<typename G>
+		struct IsFused<SF<G>> : std::true_type
+		{ };
+		// constant signal type, defined only for plain values
+		template<typename A, bool = IsFused<A>::value>
+		struct ConstantS
+		{
+			typedef S<ConstantNode<A>> type;
+		};
+		template<typename A>
+		struct ConstantS < A, true >
+		{ };
+		template<typename Fst, typename Snd>
+		struct Compose
+		{
+			Fst fst;
+			Snd snd;
+			template<typename F>
+			auto operator () ( const S<F>& a ) const -> decltype( snd( fst( a ) ) )
+			{
+				return snd( fst( a ) );
+			}
+		};
+		template<typename G>
+		struct SF
+		{
+			G g;
+			// apply signal to SF
+			template<typename F>
+			auto operator () ( const S<F>& a ) const -> decltype( g( a ) )
+			{
+				return g( a );
+			}
+			// apply signal to SF
+			template<typename F>
+			auto operator < ( const S<F>& a ) const -> decltype( g( a ) )
+			{
+				return g( a );
+			}
+			// compose two SF ( this <<< sf )
+			template<typename H>
+			SF<Compose<H, G>> operator < ( const SF<H>& sf ) const
+			{
+				return SF < Compose<H, G> > { Compose < H, G > { sf.g, g } };
+			}
+			// apply constant value to SF
+			template<typename A>
+			auto operator < ( const A& a ) const
+				-> decltype( g( std::declval<typename ConstantS<A>::type>( ) ) )
+			{
+				return g( typename ConstantS<A>::type{ ConstantNode < A > { a } } );
+			}
+		};
+		template<typename Fn, typename F>
+		struct ArrNode
+		{
+			Fn fn;
+			F a;
+			auto operator () ( const float deltaMs ) const -> decltype( fn( a( deltaMs ) ) )
+			{
+				return fn( a( deltaMs ) );
+			}
+		};
+		template<typename Fn>
+		struct Arr
+		{
+			Fn fn;
+			template<typename F>
+			S<ArrNode<Fn, F>> operator () ( const S<F>& a ) const
+			{
+				return S < ArrNode<Fn, F> > { ArrNode < Fn, F > { fn, a.f } };
+			}
+		};
+		// fn( a, b ) sampled from the bound signal a and the input signal b
+		template<typename Fn, typename FA, typename FB>
+		struct Lift2Node
+		{
+			Fn fn;
+			FA a;
+			FB b;
+			auto operator () ( const float deltaMs ) const
+				-> decltype( fn( a( deltaMs ), b( deltaMs ) ) )
+			{
+				return fn( a( deltaMs ), b( deltaMs ) );
+			}
+		};
+		template<typename Fn, typename FA>
+		struct Lift2
+		{
+			Fn fn;
+			FA a;
+			template<typename FB>
+			S<Lift2Node<Fn, FA, FB>> operator () ( const S<FB>& b ) const
+			{
+				return S < Lift2Node<Fn, FA, FB> > { Lift2Node < Fn, FA, FB > { fn, a, b.f } };
+			}
+		};
+		template<typename F>
+		struct IntegralNode
+		{
+			F a;
+			auto operator () ( const float deltaMs ) const -> decltype( a( deltaMs ) * deltaMs )
+			{
+				return a( deltaMs ) * deltaMs;
+			}
+		};
+		struct Integral
+		{
+			template<typename F>
+			S<IntegralNode<F>> operator () ( const S<F>& a ) const
+			{
+				return S < IntegralNode<F> > { IntegralNode < F > { a.f } };
+			}
+		};
+		struct Plus
+		{
+			template<typename A, typename B>
+			auto operator () ( const A& a, const B& b ) const -> decltype( a + b )
+			{
+				return a + b;
+			}
+		};
+		struct Minus
+		{
+			template<typename A, typename B>
+			auto operator () ( const A& a, const B& b ) const -> decltype( a - b )
+			{
+				return a - b;
+			}
+		};
+		struct Times
+		{
+			template<typename A, typename B>
+			auto operator () ( const A& a, const B& b ) const -> decltype( a * b )
+			{
+				return a * b;
+			}
+		};
+		struct Divide
+		{
+			template<typename A, typename B>
+			auto operator () ( const A& a, const B& b ) const -> decltype( a / b )
+			{
+				return a / b;
+			}
+		};
+		struct Rotate
+		{
+			template<typename A>
+			Vec3<A> operator () ( const Quat<A>& rot, const Vec3<A>& vec ) const
+			{
+				return hp_fp::rotate( vec, rot );
+			}
+		};
+		// value a signal holds before it is sampled, events are empty
+		template<typename A>
+		struct InitialValue
+		{
+			static A get( )
+			{
+				return A( );
+			}
+		};
+		template<typename A>
+		struct InitialValue < E<A> >
+		{
+			static E<A> get( )
+			{
+				return noE<A>( );
+			}
+		};
+		template<typename... As>
+		struct InitialValue < std::tuple<As...> >
+		{
+			static std::tuple<As...> get( )
+			{
+				return std::tuple<As...>( InitialValue<As>::get( )... );
+			}
+		};
+		// event value of a switch, latched at its event
+		template<typename C>
+		struct SwitchLatch
+		{
+			C value;
+			bool switched;
+		};
+		// signal of the latched event value, the switched in network is built on top of it
+		template<typename C>
+		struct LatchNode
+		{
+			std::shared_ptr<SwitchLatch<C>> latch;
+			C operator () ( const float deltaMs ) const
+			{
+				return latch->value;
+			}
+		};
+		// subject until its event, then the network built on top of the event value from the
+		// event tick on, subject is not sampled any more
+		template<typename C, typename FS, typename FN>
+		struct SwitchNode
+		{
+			FS subject;
+			FN next;
+			std::shared_ptr<SwitchLatch<C>> latch;
+			typename Sample<FN>::type operator () ( const float deltaMs ) const
+			{
+				if ( !latch->switched )
+				{
+					auto out = subject( deltaMs );
+					SwitchLatch<C>& l = *latch;
+					l.switched = ifThenElse( std::get<1>( out ), [&l]( const C& c )
+					{
+						l.value = c;
+						return true;
+					}, []
+					{
+						return false;
+					} );
+					if ( !l.switched )
+					{
+						return std::get<0>( out );
+					}
+				}
+				return next( deltaMs );
+			}
+		};
+		// k builds the switched in SF of the signal of the event value
+		template<typename C, typename G, typename K>
+		struct Switch
+		{
+			SF<G> sf;
+			K k;
+			template<typename F>
+			auto operator () ( const S<F>& a ) const -> S<SwitchNode<C, decltype( sf( a ).f ),
+				decltype( k( std::declval<const S<LatchNode<C>>&>( ) )( a ).f )>>
+			{
+				typedef decltype( sf( a ).f ) FS;
+				typedef decltype( k( std::declval<const S<LatchNode<C>>&>( ) )( a ).f ) FN;
+				auto latch = std::make_shared<SwitchLatch<C>>( SwitchLatch < C > {
+					InitialValue<C>::get( ), false } );
+				const S<LatchNode<C>> value{ LatchNode < C > { latch } };
+				return S < SwitchNode<C, FS, FN> > {
+					SwitchNode < C, FS, FN > { sf( a ).f, k( value )( a ).f, latch } };
+			}
+		};
+		// member of a value, batch tapes read members of their input without the rest of it
+		template<typename A, typename M>
+		struct Member
+		{
+			M A::* member;
+			M operator () ( const A& a ) const
+			{
+				return a.*member;
+			}
+		};
+		/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+		template<typename A>
+		S<ConstantNode<A>> constant( const A& a )
+		{
+			return S < ConstantNode<A> > { ConstantNode < A > { a } };
+		}
+		template<typename Fn>
+		SF<Arr<Fn>> arr( Fn fn )
+		{
+			return SF < Arr<Fn> > { Arr < Fn > { fn } };
+		}
+		template<typename G, typename H>
+		SF<Compose<G, H>> compose( const SF<G>& fst, const SF<H>& snd )
+		{
+			return SF < Compose<G, H> > { Compose < G, H > { fst.g, snd.g } };
+		}
+		template<typename Fn, typename FA>
+		SF<Lift2<Fn, FA>> lift2( Fn fn, const S<FA>& a )
+		{
+			return SF < Lift2<Fn, FA> > { Lift2 < Fn, FA > { fn, a.f } };
+		}
+		template<typename FA>
+		SF<Lift2<Plus, FA>> add( const S<FA>& a )
+		{
+			return lift2( Plus( ), a );
+		}
+		template<typename A>
+		SF<Lift2<Plus, ConstantNode<A>>> add( const A& a )
+		{
+			return lift2( Plus( ), fused::constant( a ) );
+		}
+		template<typename FA>
+		SF<Lift2<Minus, FA>> sub( const S<FA>& a )
+		{
+			return lift2( Minus( ), a );
+		}
+		template<typename A>
+		SF<Lift2<Minus, ConstantNode<A>>> sub( const A& a )
+		{
+			return lift2( Minus( ), fused::constant( a ) );
+		}
+		template<typename FA>
+		SF<Lift2<Times, FA>> mul( const S<FA>& a )
+		{
+			return lift2( Times( ), a );
+		}
+		template<typename A>
+		SF<Lift2<Times, ConstantNode<A>>> mul( const A& a )
+		{
+			return lift2( Times( ), fused::constant( a ) );
+		}
+		template<typename FA>
+		SF<Lift2<Divide, FA>> div( const S<FA>& a )
+		{
+			return lift2( Divide( ), a );
+		}
+		template<typename A>
+		SF<Lift2<Divide, ConstantNode<A>>> div( const A& a )
+		{
+			return lift2( Divide( ), fused::constant( a ) );
+		}
+		inline SF<Integral> integral( )
+		{
+			return SF < Integral > { Integral( ) };
+		}
+		template<typename F>
+		SF<Lift2<Rotate, F>> rotate( const S<F>& rot )
+		{
+			return lift2( Rotate( ), rot );
+		}
+		inline SF<Lift2<Rotate, ConstantNode<FQuat>>> rotate( const FQuat& rot )
+		{
+			return lift2( Rotate( ), fused::constant( rot ) );
+		}
+		// sf outputs a value and an event of C, from the event on the output is the one of
+		// k( signal of the event value ) applied to the same input, as the sw of sfs.hpp
+		template<typename C, typename G, typename K>
+		SF<Switch<C, G, K>> sw( const SF<G>& sf, K k )
+		{
+			return SF < Switch<C, G, K> > { Switch < C, G, K > { sf, k } };
+		}
+		template<typename A, typename M>
+		SF<Arr<Member<A, M>>> member( M A::* member )
+		{
+			return arr( Member < A, M > { member } );
+		}
+		template<typename A>
+		S<InputNode<A>> input( )
+		{
+			return S < InputNode<A> > { InputNode < A > { std::make_shared<const A*>( nullptr ) } };
+		}
+		// write input to the slot and sample output signal built on top of it
+		template<typename A, typename F>
+		typename Sample<F>::type sample_IO( const S<InputNode<A>>& in, const S<F>& out,
+			const A& a, const float deltaMs )
+		{
+			const Sampling sampling;
+			*in.f.slot = &a;
+			auto b = out( deltaMs );
+			*in.f.slot = nullptr;
+			return b;
+		}
+		// type-erase signal network built on top of the input to SF
+		template<typename A, typename F>
+		hp_fp::SF<A, typename Sample<F>::type> erase( const S<InputNode<A>>& in, const S<F>& out )
+		{
+			typedef typename Sample<F>::type B;
+			// fused networks can be larger than the inline capacity of type-erased signals
+			auto node = std::make_shared<const S<F>>( out );
+			return hp_fp::SF < A, B > {
+				[in, node]( const hp_fp::S<A>& a ) -> hp_fp::S < B >
+				{
+					return hp_fp::S < B > {
+						[in, node, a]( const float deltaMs )
+						{
+							const A val = a( deltaMs );
+							const A* prev = *in.f.slot;
+							*in.f.slot = &val;
+							B b = ( *node )( deltaMs );
+							*in.f.slot = prev;
+							return b;
+						}
+					};
+				}
+			};
+		}
+		// lift type-erased signal, e.g. actor input
+		template<typename A>
+		S<hp_fp::S<A>> signal( const hp_fp::S<A>& a )
+		{
+			return S < hp_fp::S<A> > { a };
+		}
+		// type-erase fused signal at actor boundary
+		template<typename F>
+		hp_fp::S<typename Sample<F>::type> erase( const S<F>& a )
+		{
+			auto node = std::make_shared<const S<F>>( a );
+			return hp_fp::S < typename Sample<F>::type > {
+				[node]( const float deltaMs )
+				{
+					return ( *node )( deltaMs );
+				}
+			};
+		}
+		// type-erase fused SF at actor boundary
+		template<typename A, typename B, typename G>
+		hp_fp::SF<A, B> erase( const SF<G>& sf )
+		{
+			return hp_fp::SF < A, B > {
+				[sf]( const hp_fp::S<A>& a ) -> hp_fp::S < B >
+				{
+					return erase( sf < signal( a ) );
+				}
+			};
+		}
+	}
+}
@@ -1,39 +1,123 @@
 #pragma once
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include "../../utils/inplaceFn.hpp"
+#include "../../utils/threadLocal.hpp"
 namespace hp_fp
 {
+	// tick of the sample the calling thread is in, zero before its first one
+	struct Epoch
+	{
+		UInt64 tick;
+		UInt32 depth;
+	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  0  ][  0  ][  0  ][  0  ]
+	// scope of one sample, a sample which is not nested in another one starts a new tick, so
+	// that shared signals and stateful arrows are evaluated once per outermost sample
+	struct Sampling
+	{
+		Sampling( );
+		Sampling( const Sampling& ) = delete;
+		Sampling operator = ( const Sampling& ) = delete;
+		~Sampling( );
+		Epoch& epoch;
+	};
 	template<typename A>
 	struct S
 	{
-		S( std::function<A( const float )> f ) : f( f )
+		template<typename F, typename = typename std::enable_if<
+			!std::is_same<typename std::decay<F>::type, S>::value &&
+			IsCallable<typename std::decay<F>::type, A( const float )>::value>::type>
+		S( F&& f ) : f( std::forward<F>( f ) )
 		{ }
 		S( const S& s ) : f( s.f )
 		{ }
 		S( S&& s ) : f( std::move( s.f ) )
 		{ }
-		S operator = ( const S& s )
+		S& operator = ( const S& s )
 		{
-			return S{ s };
+			f = s.f;
+			return *this;
 		}
-		S operator = ( S&& s )
+		S& operator = ( S&& s )
 		{
-			return S{ std::move( s ) };
+			f = std::move( s.f );
+			return *this;
 		}
-		std::function<A( const float )> f;
+		SharedFn<A( const float )> f;
 		A operator () ( const float deltaMs ) const
 		{
+			const Sampling sampling;
 			return f( deltaMs );
 		}
 		A operator < ( const float deltaMs ) const
 		{
-			return f( deltaMs );
+			return ( *this )( deltaMs );
 		}
 		A apply( const float deltaMs ) const
 		{
-			return f( deltaMs );
+			return ( *this )( deltaMs );
 		}
 	};
+	// per node counters of a shared signal
+	struct ShareCounters
+	{
+		UInt32 samples;
+		UInt32 evaluations;
+	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  0  ][  0  ][  0  ][  0  ]
+	template<typename A>
+	struct SharedNode
+	{
+		SharedNode( const S<A>& s, const std::shared_ptr<ShareCounters>& counters )
+			: s( s ), counters( counters ), tick( 0 ), engaged( false )
+		{ }
+		SharedNode( const SharedNode& ) = delete;
+		SharedNode operator = ( const SharedNode& ) = delete;
+		~SharedNode( )
+		{
+			if ( engaged )
+			{
+				reinterpret_cast<A*>( &val )->~A( );
+			}
+		}
+		const S<A> s;
+		const std::shared_ptr<ShareCounters> counters;
+		UInt64 tick;
+		bool engaged;
+		typename std::aligned_storage<sizeof( A ), std::alignment_of<A>::value>::type val;
+	};
 	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
 
+	// plain data, so that it can be thread local on every compiler
+	inline Epoch& epoch_IO( )
+	{
+		static HP_THREAD_LOCAL Epoch epoch;
+		return epoch;
+	}
+	// ticks are unique over all threads, a network sampled by one thread and later by another
+	// never sees an old tick again
+	UInt64 newTick_IO( );
+	inline Sampling::Sampling( ) : epoch( epoch_IO( ) )
+	{
+		if ( epoch.depth++ == 0 )
+		{
+			epoch.tick = newTick_IO( );
+		}
+	}
+	inline Sampling::~Sampling( )
+	{
+		--epoch.depth;
+	}
+	// current tick of the calling thread
+	inline UInt64 tick_IO( )
+	{
+		return epoch_IO( ).tick;
+	}
+
 	template<typename A>
 	S<A> constant( const A& a )
 	{
@@ -45,5 +129,42 @@ namespace hp_fp
 			}
 		};
 	}
+	// memoize signal so that all its consumers share a single evaluation per tick
+	template<typename A>
+	S<A> share( const S<A>& a, const std::shared_ptr<ShareCounters>& counters )
+	{
+		auto node = std::make_shared<SharedNode<A>>( a, counters );
+		return S < A >
+		{
+			[node]( const float deltaMs ) -> A
+			{
+				if ( node->counters )
+				{
+					++node->counters->samples;
+				}
+				if ( !node->engaged || node->tick != tick_IO( ) )
+				{
+					A val = node->s( deltaMs );
+					if ( node->engaged )
+					{
+						reinterpret_cast<A*>( &node->val )->~A( );
+					}
+					new ( &node->val ) A( std::move( val ) );
+					node->engaged = true;
+					node->tick = tick_IO( );
+					if ( node->counters )
+					{
+						++node->counters->evaluations;
+					}
+				}
+				return *reinterpret_cast<const A*>( &node->val );
+			}
+		};
+	}
+	template<typename A>
+	S<A> share( const S<A>& a )
+	{
+		return share( a, nullptr );
+	}
 }
 
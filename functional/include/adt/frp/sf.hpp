@@ -1,35 +1,56 @@
 #pragma once
 #include <functional>
+#include <memory>
+#include <tuple>
 #include "s.hpp"
+#include "state.hpp"
 namespace hp_fp
 {
+	// what is known about an SF without sampling it, lets the engine skip actors whose SF
+	// never changes their state
+	enum struct SFKind : UInt8
+	{
+		Signal,
+		// output is the input, for actors the output state is the input state
+		Identity,
+		// output does not depend on the input nor on time
+		Constant
+	};
 	template<typename A, typename B>
 	struct SF
 	{
-		SF( std::function<S<B>( const S<A>& a )> f ) : f( f )
+		template<typename F, typename = typename std::enable_if<
+			!std::is_same<typename std::decay<F>::type, SF>::value &&
+			IsCallable<typename std::decay<F>::type, S<B>( const S<A>& )>::value>::type>
+		SF( F&& f, const SFKind kind = SFKind::Signal ) : f( std::forward<F>( f ) ), kind( kind )
 		{ }
-		SF( const SF& sf ) : f( sf.f )
+		SF( const SF& sf ) : f( sf.f ), kind( sf.kind )
 		{ }
-		SF( SF&& sf ) : f( std::move( sf.f ) )
+		SF( SF&& sf ) : f( std::move( sf.f ) ), kind( sf.kind )
 		{ }
-		SF operator = ( const SF& sf )
+		SF& operator = ( const SF& sf )
 		{
-			return SF{ sf };
+			f = sf.f;
+			kind = sf.kind;
+			return *this;
 		}
-		SF operator = ( SF&& sf )
+		SF& operator = ( SF&& sf )
 		{
-			return SF{ std::move( sf ) };
+			f = std::move( sf.f );
+			kind = sf.kind;
+			return *this;
 		}
-		std::function<S<B>( const S<A>& a )> f;
+		SharedFn<S<B>( const S<A>& a )> f;
+		SFKind kind;
 		template<typename C>
 		// compose two SF ( this >>> sf )
-		SF<A, C> operator > ( SF<B, C>& sf ) const
+		SF<A, C> operator > ( const SF<B, C>& sf ) const
 		{
 			return compose( *this, sf );
 		}
 		template<typename C>
 		// compose two SF ( this <<< sf )
-		SF<C, B> operator < ( SF<C, A>& sf ) const
+		SF<C, B> operator < ( const SF<C, A>& sf ) const
 		{
 			return compose( sf, *this );
 		}
@@ -65,6 +86,16 @@ namespace hp_fp
 			return compose( *this, sf );
 		}
 	};
+	// SF applied once to a mutable input slot, so that its signal network is built
+	// a single time and then only sampled each tick
+	template<typename A, typename B>
+	struct SFInstance
+	{
+		std::shared_ptr<const A*> input;
+		S<B> output;
+		// state of all stateful arrows of the network
+		std::shared_ptr<StateBlock> state;
+	};
 	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
 
 	template<typename A, typename B>
@@ -114,8 +145,174 @@ namespace hp_fp
 			[fst, snd]( const S<A>& a ) -> S < C >
 			{
 				return snd.f( fst.f( a ) );
+			},
+			snd.kind == SFKind::Constant || fst.kind == SFKind::Identity ? snd.kind :
+				snd.kind == SFKind::Identity ? fst.kind : SFKind::Signal
+		};
+	}
+	template<typename A>
+	SF<A, A> identity( )
+	{
+		return SF < A, A > {
+			[]( const S<A>& a ) -> S < A >
+			{
+				return a;
+			},
+			SFKind::Identity
+		};
+	}
+	// SF whose output is b whatever its input is
+	template<typename A, typename B>
+	SF<A, B> constantSF( const B& b )
+	{
+		return SF < A, B > {
+			[b]( const S<A>& ) -> S < B >
+			{
+				return constant( b );
+			},
+			SFKind::Constant
+		};
+	}
+	// arr of a function of two values, applied to a tuple signal
+	template<typename A, typename B, typename C>
+	SF<std::tuple<A, B>, C> arr( C( *f )( const A&, const B& ) )
+	{
+		return SF < std::tuple<A, B>, C > {
+			[f]( const S<std::tuple<A, B>>& ab ) -> S < C >
+			{
+				return S < C > {
+					[f, ab]( const float deltaMs )
+					{
+						const auto t = ab( deltaMs );
+						return f( std::get<0>( t ), std::get<1>( t ) );
+					}
+				};
+			}
+		};
+	}
+	// arr of a function of three values, applied to a tuple signal
+	template<typename A, typename B, typename C, typename D>
+	SF<std::tuple<A, B, C>, D> arr( D( *f )( const A&, const B&, const C& ) )
+	{
+		return SF < std::tuple<A, B, C>, D > {
+			[f]( const S<std::tuple<A, B, C>>& abc ) -> S < D >
+			{
+				return S < D > {
+					[f, abc]( const float deltaMs )
+					{
+						const auto t = abc( deltaMs );
+						return f( std::get<0>( t ), std::get<1>( t ), std::get<2>( t ) );
+					}
+				};
 			}
 		};
 	}
+	template<typename A, typename B>
+	S<A> fst( const S<std::tuple<A, B>>& ab )
+	{
+		return S < A > {
+			[ab]( const float deltaMs )
+			{
+				return std::get<0>( ab( deltaMs ) );
+			}
+		};
+	}
+	template<typename A, typename B>
+	S<B> snd( const S<std::tuple<A, B>>& ab )
+	{
+		return S < B > {
+			[ab]( const float deltaMs )
+			{
+				return std::get<1>( ab( deltaMs ) );
+			}
+		};
+	}
+	template<typename A, typename B>
+	S<std::tuple<A, B>> zip( const S<A>& a, const S<B>& b )
+	{
+		return S < std::tuple<A, B> > {
+			[a, b]( const float deltaMs )
+			{
+				return std::make_tuple( a( deltaMs ), b( deltaMs ) );
+			}
+		};
+	}
+	// sf applied to the first element of a tuple, input is evaluated once per tick
+	// for both elements
+	template<typename A, typename B, typename C>
+	SF<std::tuple<A, C>, std::tuple<B, C>> first( const SF<A, B>& sf )
+	{
+		return SF < std::tuple<A, C>, std::tuple<B, C> > {
+			[sf]( const S<std::tuple<A, C>>& ac ) -> S < std::tuple<B, C> >
+			{
+				const auto shared = share( ac );
+				return zip( sf( fst( shared ) ), snd( shared ) );
+			}
+		};
+	}
+	// sf applied to the second element of a tuple
+	template<typename A, typename B, typename C>
+	SF<std::tuple<C, A>, std::tuple<C, B>> second( const SF<A, B>& sf )
+	{
+		return SF < std::tuple<C, A>, std::tuple<C, B> > {
+			[sf]( const S<std::tuple<C, A>>& ca ) -> S < std::tuple<C, B> >
+			{
+				const auto shared = share( ca );
+				return zip( fst( shared ), sf( snd( shared ) ) );
+			}
+		};
+	}
+	// f *** g, f and g applied to the elements of a tuple
+	template<typename A, typename B, typename C, typename D>
+	SF<std::tuple<A, C>, std::tuple<B, D>> split( const SF<A, B>& f, const SF<C, D>& g )
+	{
+		return SF < std::tuple<A, C>, std::tuple<B, D> > {
+			[f, g]( const S<std::tuple<A, C>>& ac ) -> S < std::tuple<B, D> >
+			{
+				const auto shared = share( ac );
+				return zip( f( fst( shared ) ), g( snd( shared ) ) );
+			}
+		};
+	}
+	// f &&& g, f and g applied to the same input, which is evaluated once per sample
+	template<typename A, typename B, typename C>
+	SF<A, std::tuple<B, C>> fanout( const SF<A, B>& f, const SF<A, C>& g )
+	{
+		return SF < A, std::tuple<B, C> > {
+			[f, g]( const S<A>& a ) -> S < std::tuple<B, C> >
+			{
+				const auto shared = share( a );
+				return zip( f( shared ), g( shared ) );
+			}
+		};
+	}
+	template<typename A, typename B>
+	SFInstance<A, B> instantiate( const SF<A, B>& sf )
+	{
+		auto input = std::make_shared<const A*>( nullptr );
+		return withStateBlock_IO( [&sf, &input]( const std::shared_ptr<StateBlock>& state )
+		{
+			return SFInstance < A, B > {
+				input,
+				sf( S < A > {
+					[input]( const float deltaMs ) -> A
+					{
+						return **input;
+					}
+				} ),
+				state
+			};
+		} );
+	}
+	// write input to the slot and sample output of the already built signal network,
+	// each sample is a new tick for shared signals
+	template<typename A, typename B>
+	B sample_IO( SFInstance<A, B>& instance, const A& a, const float deltaMs )
+	{
+		*instance.input = &a;
+		B b = instance.output( deltaMs );
+		*instance.input = nullptr;
+		return b;
+	}
 }
 
@@ -66,7 +66,7 @@ namespace hp_fp
 					{
 						return a - b( deltaMs );
 					}
-				}
+				};
 			}
 		};
 	}
@@ -166,6 +166,7 @@ namespace hp_fp
 			}
 		};
 	}
+	// integral of a over the last tick only
 	template<typename A>
 	SF<A, A> integral( )
 	{
@@ -183,27 +184,251 @@ namespace hp_fp
 			}
 		};
 	}
+	// integral of a accumulated since init, stateful arrows advance once per sample
+	template<typename A>
+	SF<A, A> integral( const A& init )
+	{
+		return SF < A, A >
+		{
+			[init]( const S<A>& a ) -> S < A >
+			{
+				auto state = reserveState_IO( TickedValue < A > { 0, init } );
+				return S < A >
+				{
+					[state, a]( const float deltaMs ) -> A
+					{
+						if ( advance_IO( *state ) )
+						{
+							state->val = state->val + a( deltaMs ) * deltaMs;
+						}
+						return state->val;
+					}
+				};
+			}
+		};
+	}
+	// a delayed by N ticks, init until then
+	template<UInt32 N, typename A>
+	SF<A, A> delay( const A& init )
+	{
+		static_assert( N > 0, "Delay has to be at least one tick." );
+		return SF < A, A >
+		{
+			[init]( const S<A>& a ) -> S < A >
+			{
+				auto state = reserveState_IO( delayState<A, N>( init ) );
+				return S < A >
+				{
+					[state, a]( const float deltaMs ) -> A
+					{
+						if ( advance_IO( *state ) )
+						{
+							auto& val = state->vals[state->next];
+							state->out = val;
+							val = a( deltaMs );
+							state->next = ( state->next + 1 ) % N;
+						}
+						return state->out;
+					}
+				};
+			}
+		};
+	}
+	// a of the previous tick, init in the first one
+	template<typename A>
+	SF<A, A> iPre( const A& init )
+	{
+		return delay<1>( init );
+	}
+	// value of the last event, init until the first one
+	template<typename A>
+	SF<E<A>, A> hold( const A& init )
+	{
+		return SF < E<A>, A >
+		{
+			[init]( const S<E<A>>& e ) -> S < A >
+			{
+				auto state = reserveState_IO( TickedValue < A > { 0, init } );
+				return S < A >
+				{
+					[state, e]( const float deltaMs ) -> A
+					{
+						if ( advance_IO( *state ) )
+						{
+							ifThenElse( e( deltaMs ), [&state]( const A& a )
+							{
+								state->val = a;
+								return true;
+							}, []
+							{
+								return false;
+							} );
+						}
+						return state->val;
+					}
+				};
+			}
+		};
+	}
+	// output of body fed back to it in the next tick, init in the first one
+	template<typename A, typename B>
+	SF<A, B> loop( const B& init,
+		std::function<S<B>( const S<A>& input, const S<B>& feedback )> body )
+	{
+		return SF < A, B >
+		{
+			[init, body]( const S<A>& a ) -> S < B >
+			{
+				auto state = reserveState_IO( TickedValue < B > { 0, init } );
+				const S<B> out = body( a, S < B > {
+					[state]( const float deltaMs ) -> B
+					{
+						return state->val;
+					}
+				} );
+				return S < B >
+				{
+					[state, out]( const float deltaMs ) -> B
+					{
+						if ( advance_IO( *state ) )
+						{
+							state->val = out( deltaMs );
+						}
+						return state->val;
+					}
+				};
+			}
+		};
+	}
 	SF<FVec3, FVec3> rotate( const S<FQuat>& rot );
 	SF<FVec3, FVec3> rotate( const FQuat& rot );
 
+	// subject runs until its event, then f of the event value runs for good, it is switched
+	// in at the event tick or, when delayed, at the tick after
+	template<typename A, typename B, typename C>
+	SF<A, B> switchOnEvent( const SF<A, std::tuple<B, E<C>>>& sf,
+		const SharedFn<SF<A, B>( C )>& f, const bool delayed )
+	{
+		return SF < A, B > {
+			[sf, f, delayed]( const S<A>& a ) -> S < B >
+			{
+				// subject network is built once and sampled once per tick
+				const S<std::tuple<B, E<C>>> subject = sf < a;
+				auto state = reserveState_IO( SwitchState < B > { } );
+				return S < B >
+				{
+					[subject, f, delayed, a, state]( const float deltaMs ) -> B
+					{
+						if ( state->current )
+						{
+							return ( *state->current )( deltaMs );
+						}
+						auto out = subject( deltaMs );
+						return ifThenElse( std::get<1>( out ),
+							[&f, &a, &state, &out, delayed, deltaMs]( const C& c ) -> B
+						{
+							state->current = std::make_shared<const S<B>>( f( c ) < a );
+							return delayed ? std::move( std::get<0>( out ) )
+								: ( *state->current )( deltaMs );
+						}, [&out]( ) -> B
+						{
+							return std::move( std::get<0>( out ) );
+						} );
+					}
+				};
+			}
+		};
+	}
 	template<typename A, typename B, typename C>
 	SF<A, B> sw( const SF<A, std::tuple<B, E<C>>>& sf, std::function<SF<A, B>( C )> f )
 	{
+		return switchOnEvent<A, B, C>( sf, f, false );
+	}
+	// switch whose event tick still outputs the subject
+	template<typename A, typename B, typename C>
+	SF<A, B> dSwitch( const SF<A, std::tuple<B, E<C>>>& sf, std::function<SF<A, B>( C )> f )
+	{
+		return switchOnEvent<A, B, C>( sf, f, true );
+	}
+	// runs sf and switches to every SF which comes with the input
+	template<typename A, typename B>
+	SF<std::tuple<A, E<SF<A, B>>>, B> rSwitch( const SF<A, B>& sf )
+	{
+		return SF < std::tuple<A, E<SF<A, B>>>, B > {
+			[sf]( const S<std::tuple<A, E<SF<A, B>>>>& in ) -> S < B >
+			{
+				// the running SF reads only the A part of the input
+				auto slot = std::make_shared<const A*>( nullptr );
+				const S<A> a{ [slot]( const float deltaMs ) -> A
+				{
+					return **slot;
+				} };
+				const S<B> initial = sf < a;
+				auto state = reserveState_IO( SwitchState < B > { } );
+				return S < B >
+				{
+					[in, slot, a, initial, state]( const float deltaMs ) -> B
+					{
+						auto input = in( deltaMs );
+						ifThenElse( std::get<1>( input ), [&a, &state]( const SF<A, B>& next )
+						{
+							state->current = std::make_shared<const S<B>>( next < a );
+							return true;
+						}, []
+						{
+							return false;
+						} );
+						*slot = &std::get<0>( input );
+						B b = state->current ? ( *state->current )( deltaMs ) : initial( deltaMs );
+						*slot = nullptr;
+						return b;
+					}
+				};
+			}
+		};
+	}
+	// switch whose event observes input and output of the subject, k gets the running
+	// subject as SF so that it can continue it
+	template<typename A, typename B, typename C>
+	SF<A, B> kSwitch( const SF<A, B>& sf, const SF<std::tuple<A, B>, E<C>>& test,
+		std::function<SF<A, B>( const SF<A, B>&, const C& )> k )
+	{
+		// shared so that the per instance closure stays small
+		const SharedFn<SF<A, B>( const SF<A, B>&, const C& )> next( std::move( k ) );
 		return SF < A, B > {
-			[sf, f]( const S<A>& a )
+			[sf, test, next]( const S<A>& a ) -> S < B >
 			{
+				const S<A> input = share( a );
+				const S<B> subject = share( sf < input );
+				const S<E<C>> event = test < S < std::tuple<A, B> > {
+					[input, subject]( const float deltaMs )
+					{
+						return std::make_tuple( input( deltaMs ), subject( deltaMs ) );
+					}
+				};
+				// applied to the same input, continues the subject with its state
+				const SF<A, B> continuation{ [subject]( const S<A>& ) -> S < B >
+				{
+					return subject;
+				} };
+				auto state = reserveState_IO( SwitchState < B > { } );
 				return S < B >
 				{
-					[sf, f, a]( const float deltaMs ) -> B
+					[input, subject, event, continuation, next, state]( const float deltaMs ) -> B
 					{
-						return ifThenElse( std::get<1>( sf < a < deltaMs ),
-							[f, a, deltaMs]( const C& c )
+						if ( state->current )
+						{
+							return ( *state->current )( deltaMs );
+						}
+						return ifThenElse( event( deltaMs ),
+							[&next, &continuation, &input, &state, deltaMs]( const C& c ) -> B
 						{
-							return f( c ) < a < deltaMs;
-						},
-							[sf, a, deltaMs]( )
+							state->current = std::make_shared<const S<B>>(
+								next( continuation, c ) < input );
+							return ( *state->current )( deltaMs );
+						}, [&subject, deltaMs]( ) -> B
 						{
-							return std::get<0>( sf < a < deltaMs );
+							return subject( deltaMs );
 						} );
 					}
 				};
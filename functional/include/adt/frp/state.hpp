@@ -0,0 +1,182 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <new>
+#include <vector>
+#include "s.hpp"
+#include "../../utils/threadLocal.hpp"
+// Persistent state of stateful arrows. All state of one signal network instance lives in
+// a single block laid out when the network is instantiated, the network's closures only
+// reference their part of the block. Initial values are copied into the block as soon as
+// they are reserved.
+namespace hp_fp
+{
+	// state of one arrow at offset of the block
+	struct StateEntry
+	{
+		UInt32 offset;
+		// copy constructs the state at a from the one at b
+		void( *construct )( UInt8* a, const void* b );
+		void( *destroy )( UInt8* a );
+	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  0  ][  0  ][  0  ][  0  ]
+	struct StateBlock : std::enable_shared_from_this<StateBlock>
+	{
+		StateBlock( ) : size( 0 ), allocated( false )
+		{ }
+		StateBlock( const StateBlock& ) = delete;
+		StateBlock operator = ( const StateBlock& ) = delete;
+		~StateBlock( )
+		{
+			for ( const auto& entry : entries )
+			{
+				entry.destroy( reinterpret_cast<UInt8*>( values.data( ) ) + entry.offset );
+			}
+		}
+		std::vector<UInt64> values;
+		std::vector<StateEntry> entries;
+		UInt32 size;
+		// true once the layout is done and values has its final size
+		bool allocated;
+	};
+	template<typename A>
+	struct StateRef
+	{
+		std::shared_ptr<StateBlock> block;
+		UInt32 offset;
+		A& operator * ( ) const
+		{
+			return *reinterpret_cast<A*>( reinterpret_cast<UInt8*>( block->values.data( ) ) +
+				offset );
+		}
+		A* operator -> ( ) const
+		{
+			return &**this;
+		}
+	};
+	// value of a stateful arrow together with the tick it was last updated in
+	template<typename A>
+	struct TickedValue
+	{
+		UInt64 tick;
+		A val;
+	};
+	template<typename A, UInt32 N>
+	struct DelayState
+	{
+		UInt64 tick;
+		UInt32 next;
+		A out;
+		std::array<A, N> vals;
+	};
+	// signal switched in by a switch, empty until the switch happens
+	template<typename A>
+	struct SwitchState
+	{
+		std::shared_ptr<const S<A>> current;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	// block laid out by the network being instantiated on this thread, owned by
+	// withStateBlock_IO
+	inline StateBlock*& stateBlock_IO( )
+	{
+		static HP_THREAD_LOCAL StateBlock* block = nullptr;
+		return block;
+	}
+	template<typename A>
+	void constructState( UInt8* a, const void* b )
+	{
+		new ( a ) A( *static_cast<const A*>( b ) );
+	}
+	template<typename A>
+	void destroyState( UInt8* a )
+	{
+		reinterpret_cast<A*>( a )->~A( );
+	}
+	// copy all state of block to new values of words
+	inline void relocateState_IO( StateBlock& block, const size_t words )
+	{
+		std::vector<UInt64> values( words, 0 );
+		UInt8* from = reinterpret_cast<UInt8*>( block.values.data( ) );
+		UInt8* to = reinterpret_cast<UInt8*>( values.data( ) );
+		for ( const auto& entry : block.entries )
+		{
+			entry.construct( to + entry.offset, from + entry.offset );
+			entry.destroy( from + entry.offset );
+		}
+		block.values.swap( values );
+	}
+	// trim values of block to its size
+	inline void allocateState_IO( StateBlock& block )
+	{
+		const size_t words = ( block.size + sizeof( UInt64 ) - 1 ) / sizeof( UInt64 );
+		if ( block.values.size( ) != words )
+		{
+			relocateState_IO( block, words );
+		}
+		block.allocated = true;
+	}
+	// reserve state initialized to init in the block being laid out, arrows applied outside
+	// of instantiate get a block of their own
+	template<typename A>
+	StateRef<A> reserveState_IO( const A& init )
+	{
+		static_assert( std::alignment_of<A>::value <= sizeof( UInt64 ),
+			"State can be at most 8 byte aligned." );
+		StateBlock* const laidOut = stateBlock_IO( );
+		const auto block = laidOut ? laidOut->shared_from_this( ) :
+			std::make_shared<StateBlock>( );
+		const UInt32 align = std::alignment_of<A>::value;
+		const UInt32 offset = ( block->size + align - 1 ) / align * align;
+		block->size = offset + sizeof( A );
+		const size_t words = ( block->size + sizeof( UInt64 ) - 1 ) / sizeof( UInt64 );
+		if ( words > block->values.size( ) )
+		{
+			// grows geometrically while the block is laid out
+			relocateState_IO( *block, std::max( words, 2 * block->values.size( ) ) );
+		}
+		const StateEntry entry = { offset, &constructState<A>, &destroyState<A> };
+		entry.construct( reinterpret_cast<UInt8*>( block->values.data( ) ) + offset, &init );
+		block->entries.push_back( entry );
+		if ( !laidOut )
+		{
+			allocateState_IO( *block );
+		}
+		return StateRef < A > { block, offset };
+	}
+	// lay out state of all stateful arrows applied by build in one block
+	template<typename F>
+	auto withStateBlock_IO( F build ) -> decltype( build( std::shared_ptr<StateBlock>( ) ) )
+	{
+		StateBlock* const outer = stateBlock_IO( );
+		const auto block = std::make_shared<StateBlock>( );
+		stateBlock_IO( ) = block.get( );
+		auto result = build( block );
+		allocateState_IO( *block );
+		stateBlock_IO( ) = outer;
+		return result;
+	}
+	// true in the first evaluation of a stateful arrow in the current outermost sample, so that
+	// each step of the network, by sample_IO or by sampling its output directly, advances the
+	// state exactly once
+	template<typename A>
+	bool advance_IO( A& state )
+	{
+		if ( state.tick == tick_IO( ) )
+		{
+			return false;
+		}
+		state.tick = tick_IO( );
+		return true;
+	}
+	template<typename A, UInt32 N>
+	DelayState<A, N> delayState( const A& init )
+	{
+		DelayState<A, N> state{ 0, 0, init, { } };
+		state.vals.fill( init );
+		return state;
+	}
+}
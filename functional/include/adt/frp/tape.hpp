@@ -0,0 +1,416 @@
+#pragma once
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "fused.hpp"
+// Compiler of fused signal networks to a flat tape of primitive ops. Ops are stored in
+// topological order and read/write values in one contiguous buffer, so sampling the
+// tape is a single loop without closures, recursion or allocation. Fused networks copy
+// shared signals into every consumer, the compiler gives equal nodes one op, so a shared
+// signal is evaluated once per sample. Only fused networks compile, SFs of the combinators
+// of sfs.hpp are closures which cannot be looked into. A fused sw is one op which runs the
+// sub-tape of its subject until the event, latched in the value buffer, and the sub-tape of
+// the switched in network from then on.
+namespace hp_fp
+{
+	struct TapeOp
+	{
+		void( *eval )( const TapeOp& op, UInt8* values, const float deltaMs );
+		UInt32 out;
+		UInt32 fn;
+		UInt32 a;
+		UInt32 b;
+	};
+	struct TapeSlot
+	{
+		UInt32 offset;
+		void( *destroy )( UInt8* values, const UInt32 offset );
+	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  0  ][  0  ][  +  ][  0  ]
+	template<typename A, typename B>
+	struct Tape
+	{
+		Tape( std::vector<TapeOp>&& ops, std::vector<TapeSlot>&& slots,
+			std::vector<UInt64>&& values, const UInt32 input, const UInt32 output )
+			: ops( std::move( ops ) ), slots( std::move( slots ) ), values( std::move( values ) ),
+			input( input ), output( output )
+		{ }
+		Tape( const Tape& ) = delete;
+		Tape( Tape&& t ) : ops( std::move( t.ops ) ), slots( std::move( t.slots ) ),
+			values( std::move( t.values ) ), input( t.input ), output( t.output )
+		{
+			t.slots.clear( );
+		}
+		Tape operator = ( const Tape& ) = delete;
+		~Tape( )
+		{
+			for ( const auto& slot : slots )
+			{
+				slot.destroy( reinterpret_cast<UInt8*>( values.data( ) ), slot.offset );
+			}
+		}
+		std::vector<TapeOp> ops;
+		std::vector<TapeSlot> slots;
+		// 8 byte aligned value buffer
+		std::vector<UInt64> values;
+		UInt32 input;
+		UInt32 output;
+	};
+	// sub-tapes of a switch op and the slots they use
+	struct TapeSwitch
+	{
+		std::vector<TapeOp> subject;
+		std::vector<TapeOp> next;
+		UInt32 event;
+		UInt32 nextOut;
+		UInt32 value;
+		UInt32 switched;
+	};
+	// switch compiled to out, its latched event value is in value
+	struct TapeLatch
+	{
+		const void* latch;
+		UInt32 value;
+		UInt32 out;
+	};
+	// compiled node, ops are pure so equal nodes have equal values
+	struct TapeNode
+	{
+		// eval of an op, nullptr for constants
+		void( *eval )( const TapeOp& op, UInt8* values, const float deltaMs );
+		// type of a constant, nullptr for ops
+		void( *destroy )( UInt8* values, const UInt32 offset );
+		UInt32 a;
+		UInt32 b;
+		// function object of an op or value of a constant
+		std::vector<UInt8> bytes;
+		UInt32 out;
+	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  0  ][  0  ][  0  ][  0  ]
+	struct TapeBuilder
+	{
+		TapeBuilder( const void* inputSlot ) : size( 0 ), input( 0 ), inputSlot( inputSlot )
+		{ }
+		TapeBuilder( const TapeBuilder& ) = delete;
+		TapeBuilder operator = ( const TapeBuilder& ) = delete;
+		std::vector<TapeOp> ops;
+		std::vector<TapeSlot> slots;
+		std::vector<std::function<void( UInt8* values )>> constructors;
+		std::vector<TapeNode> nodes;
+		std::vector<TapeLatch> latches;
+		UInt32 size;
+		UInt32 input;
+		const void* inputSlot;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	namespace fused
+	{
+		template<typename A>
+		inline const A& load( const UInt8* values, const UInt32 offset )
+		{
+			return *reinterpret_cast<const A*>( values + offset );
+		}
+		template<typename A>
+		inline void store( UInt8* values, const UInt32 offset, const A& a )
+		{
+			A* val = reinterpret_cast<A*>( values + offset );
+			val->~A( );
+			new ( val ) A( a );
+		}
+		template<typename A>
+		void destroySlot( UInt8* values, const UInt32 offset )
+		{
+			reinterpret_cast<A*>( values + offset )->~A( );
+		}
+		template<typename A>
+		UInt32 addSlot( TapeBuilder& builder, const A& a )
+		{
+			static_assert( std::alignment_of<A>::value <= sizeof( UInt64 ),
+				"Tape values can be at most 8 byte aligned." );
+			const UInt32 align = std::alignment_of<A>::value;
+			const UInt32 offset = ( builder.size + align - 1 ) / align * align;
+			builder.size = offset + sizeof( A );
+			builder.slots.push_back( TapeSlot{ offset, &destroySlot<A> } );
+			builder.constructors.push_back( [a, offset]( UInt8* values )
+			{
+				new ( values + offset ) A( a );
+			} );
+			return offset;
+		}
+		template<typename A>
+		UInt32 addSlot( TapeBuilder& builder )
+		{
+			return addSlot( builder, InitialValue<A>::get( ) );
+		}
+		inline void run_IO( const std::vector<TapeOp>& ops, UInt8* values, const float deltaMs )
+		{
+			for ( const auto& op : ops )
+			{
+				op.eval( op, values, deltaMs );
+			}
+		}
+		// bytes of a, equal bytes are equal values, false when values of A do not compare this way
+		template<typename A>
+		bool nodeBytes( const A& a, std::vector<UInt8>& bytes )
+		{
+			if ( !std::is_trivially_copyable<A>::value )
+			{
+				return false;
+			}
+			// empty types have padding only
+			if ( !std::is_empty<A>::value )
+			{
+				bytes.resize( sizeof( A ) );
+				memcpy( bytes.data( ), &a, sizeof( A ) );
+			}
+			return true;
+		}
+		// slot of a node equal to node compiled before, or else add compiles it, builder is any
+		// builder with nodes, e.g. TapeBuilder
+		template<typename Builder, typename Add>
+		UInt32 compileOnce( Builder& builder, TapeNode&& node, const bool comparable,
+			const Add& add )
+		{
+			if ( comparable )
+			{
+				for ( const auto& n : builder.nodes )
+				{
+					if ( n.eval == node.eval && n.destroy == node.destroy && n.a == node.a &&
+						n.b == node.b && n.bytes == node.bytes )
+					{
+						return n.out;
+					}
+				}
+			}
+			const UInt32 out = add( );
+			if ( comparable )
+			{
+				node.out = out;
+				builder.nodes.push_back( std::move( node ) );
+			}
+			return out;
+		}
+		template<typename Fn, typename A, typename B>
+		void evalArr( const TapeOp& op, UInt8* values, const float deltaMs )
+		{
+			const B b = load<Fn>( values, op.fn )( load<A>( values, op.a ) );
+			store( values, op.out, b );
+		}
+		template<typename Fn, typename A, typename B, typename C>
+		void evalLift2( const TapeOp& op, UInt8* values, const float deltaMs )
+		{
+			const C c = load<Fn>( values, op.fn )( load<A>( values, op.a ),
+				load<B>( values, op.b ) );
+			store( values, op.out, c );
+		}
+		template<typename A, typename B>
+		void evalIntegral( const TapeOp& op, UInt8* values, const float deltaMs )
+		{
+			const B b = load<A>( values, op.a ) * deltaMs;
+			store( values, op.out, b );
+		}
+		template<typename A>
+		UInt32 compileNode( TapeBuilder& builder, const ConstantNode<A>& node )
+		{
+			TapeNode constant = { nullptr, &destroySlot<A>, 0, 0, { }, 0 };
+			const bool comparable = nodeBytes( node.a, constant.bytes );
+			return compileOnce( builder, std::move( constant ), comparable, [&builder, &node]
+			{
+				return addSlot( builder, node.a );
+			} );
+		}
+		template<typename B, typename C>
+		void evalSwitch( const TapeOp& op, UInt8* values, const float deltaMs )
+		{
+			const TapeSwitch& sw = load<TapeSwitch>( values, op.fn );
+			bool switched = load<bool>( values, sw.switched );
+			if ( !switched )
+			{
+				run_IO( sw.subject, values, deltaMs );
+				const auto& out = load<std::tuple<B, E<C>>>( values, sw.event );
+				switched = ifThenElse( std::get<1>( out ), [values, &sw]( const C& c )
+				{
+					store( values, sw.value, c );
+					store( values, sw.switched, true );
+					return true;
+				}, []
+				{
+					return false;
+				} );
+				if ( !switched )
+				{
+					store( values, op.out, std::get<0>( out ) );
+				}
+			}
+			if ( switched )
+			{
+				run_IO( sw.next, values, deltaMs );
+				store( values, op.out, load<B>( values, sw.nextOut ) );
+			}
+		}
+		template<typename A>
+		UInt32 compileNode( TapeBuilder& builder, const InputNode<A>& node )
+		{
+			// network can be compiled only with its own input
+			assert( builder.inputSlot == node.slot.get( ) );
+			return builder.input;
+		}
+		template<typename Fn, typename F>
+		UInt32 compileNode( TapeBuilder& builder, const ArrNode<Fn, F>& node )
+		{
+			typedef typename Sample<F>::type A;
+			typedef typename Sample<ArrNode<Fn, F>>::type B;
+			const UInt32 a = compileNode( builder, node.a );
+			TapeNode arr = { &evalArr<Fn, A, B>, nullptr, a, 0, { }, 0 };
+			const bool comparable = nodeBytes( node.fn, arr.bytes );
+			return compileOnce( builder, std::move( arr ), comparable, [&builder, &node, a]
+			{
+				const UInt32 fn = addSlot( builder, node.fn );
+				const TapeOp op = { &evalArr<Fn, A, B>, addSlot<B>( builder ), fn, a, 0 };
+				builder.ops.push_back( op );
+				return op.out;
+			} );
+		}
+		template<typename Fn, typename FA, typename FB>
+		UInt32 compileNode( TapeBuilder& builder, const Lift2Node<Fn, FA, FB>& node )
+		{
+			typedef typename Sample<FA>::type A;
+			typedef typename Sample<FB>::type B;
+			typedef typename Sample<Lift2Node<Fn, FA, FB>>::type C;
+			const UInt32 a = compileNode( builder, node.a );
+			const UInt32 b = compileNode( builder, node.b );
+			TapeNode lift2 = { &evalLift2<Fn, A, B, C>, nullptr, a, b, { }, 0 };
+			const bool comparable = nodeBytes( node.fn, lift2.bytes );
+			return compileOnce( builder, std::move( lift2 ), comparable, [&builder, &node, a, b]
+			{
+				const UInt32 fn = addSlot( builder, node.fn );
+				const TapeOp op = { &evalLift2<Fn, A, B, C>, addSlot<C>( builder ), fn, a, b };
+				builder.ops.push_back( op );
+				return op.out;
+			} );
+		}
+		template<typename F>
+		UInt32 compileNode( TapeBuilder& builder, const IntegralNode<F>& node )
+		{
+			typedef typename Sample<F>::type A;
+			typedef typename Sample<IntegralNode<F>>::type B;
+			const UInt32 a = compileNode( builder, node.a );
+			TapeNode integral = { &evalIntegral<A, B>, nullptr, a, 0, { }, 0 };
+			return compileOnce( builder, std::move( integral ), true, [&builder, a]
+			{
+				const TapeOp op = { &evalIntegral<A, B>, addSlot<B>( builder ), 0, a, 0 };
+				builder.ops.push_back( op );
+				return op.out;
+			} );
+		}
+		// compile node to ops of their own, nodes compiled there are not reused outside as
+		// the ops do not run on every sample
+		template<typename F>
+		UInt32 compileApart( TapeBuilder& builder, const F& node, std::vector<TapeOp>& ops )
+		{
+			const size_t nodes = builder.nodes.size( );
+			const size_t latches = builder.latches.size( );
+			std::swap( ops, builder.ops );
+			const UInt32 out = compileNode( builder, node );
+			std::swap( ops, builder.ops );
+			builder.nodes.erase( builder.nodes.begin( ) + nodes, builder.nodes.end( ) );
+			builder.latches.erase( builder.latches.begin( ) + latches, builder.latches.end( ) );
+			return out;
+		}
+		template<typename C>
+		UInt32 compileNode( TapeBuilder& builder, const LatchNode<C>& node )
+		{
+			for ( const auto& latch : builder.latches )
+			{
+				if ( latch.latch == node.latch.get( ) )
+				{
+					return latch.value;
+				}
+			}
+			// network can be compiled only with the switch of the latch
+			assert( false );
+			return 0;
+		}
+		template<typename C, typename FS, typename FN>
+		UInt32 compileNode( TapeBuilder& builder, const SwitchNode<C, FS, FN>& node )
+		{
+			typedef typename Sample<SwitchNode<C, FS, FN>>::type B;
+			// copies of a switch share its latch and its op
+			for ( const auto& latch : builder.latches )
+			{
+				if ( latch.latch == node.latch.get( ) )
+				{
+					return latch.out;
+				}
+			}
+			TapeSwitch sw;
+			sw.event = compileApart( builder, node.subject, sw.subject );
+			sw.value = addSlot<C>( builder );
+			sw.switched = addSlot( builder, false );
+			const size_t latch = builder.latches.size( );
+			builder.latches.push_back( TapeLatch{ node.latch.get( ), sw.value, 0 } );
+			sw.nextOut = compileApart( builder, node.next, sw.next );
+			const UInt32 out = addSlot<B>( builder );
+			const TapeOp op = { &evalSwitch<B, C>, out, addSlot( builder, sw ), 0, 0 };
+			builder.ops.push_back( op );
+			builder.latches[latch].out = out;
+			return out;
+		}
+		// compile signal network built on top of the input to a tape
+		template<typename A, typename F>
+		Tape<A, typename Sample<F>::type> compile( const S<InputNode<A>>& in, const S<F>& out )
+		{
+			TapeBuilder builder( in.f.slot.get( ) );
+			builder.input = addSlot<A>( builder );
+			const UInt32 output = compileNode( builder, out.f );
+			std::vector<UInt64> values( ( builder.size + sizeof( UInt64 ) - 1 ) / sizeof( UInt64 ) );
+			for ( const auto& construct : builder.constructors )
+			{
+				construct( reinterpret_cast<UInt8*>( values.data( ) ) );
+			}
+			return Tape < A, typename Sample<F>::type > { std::move( builder.ops ),
+				std::move( builder.slots ), std::move( values ), builder.input, output };
+		}
+	}
+	// write input to the tape and run all its ops
+	template<typename A, typename B>
+	B sample_IO( Tape<A, B>& tape, const A& a, const float deltaMs )
+	{
+		UInt8* values = reinterpret_cast<UInt8*>( tape.values.data( ) );
+		fused::store( values, tape.input, a );
+		fused::run_IO( tape.ops, values, deltaMs );
+		return fused::load<B>( values, tape.output );
+	}
+	namespace fused
+	{
+		// type-erase signal network built on top of the input to SF sampling a tape of it,
+		// every instance compiles a tape of its own
+		template<typename A, typename F>
+		hp_fp::SF<A, typename Sample<F>::type> compileSF( const S<InputNode<A>>& in,
+			const S<F>& out )
+		{
+			typedef typename Sample<F>::type B;
+			auto node = std::make_shared<const S<F>>( out );
+			return hp_fp::SF < A, B > {
+				[in, node]( const hp_fp::S<A>& a ) -> hp_fp::S < B >
+				{
+					auto tape = std::make_shared<Tape<A, B>>( compile( in, *node ) );
+					return hp_fp::S < B > {
+						[tape, a]( const float deltaMs )
+						{
+							return hp_fp::sample_IO( *tape, a( deltaMs ), deltaMs );
+						}
+					};
+				}
+			};
+		}
+	}
+}
@@ -1,42 +1,46 @@
 // inspired by http://bartoszmilewski.com/2013/11/13/functional-data-structures-in-c-lists/
 #pragma once
 #include <cassert>
+#include <functional>
 #include <initializer_list>
-#include <memory>
+#include <iterator>
+#include "../utils/refPtr.hpp"
+// Items are pool allocated and intrusively counted, RefCount is LocalRefCount for lists used by
+// one thread, AtomicRefCount for lists shared across threads.
 namespace hp_fp
 {
-	template<typename A>
+	template<typename A, typename RefCount = LocalRefCount>
 	struct List
 	{
 	private:
-		struct Item
+		struct Item : RefCounted < RefCount >
 		{
-			Item( A v, std::shared_ptr<const Item> const & tail ) : _val( v ), _next( tail )
+			Item( A v, RefPtr<const Item> const & tail ) : _val( v ), _next( tail )
 			{ }
 			A _val;
-			std::shared_ptr<const Item> _next;
+			RefPtr<const Item> _next;
 		};
 		friend Item;
-		explicit List( Item const * items ) : _head( items )
+		explicit List( RefPtr<const Item> const & items ) : _head( items )
 		{ }
-		std::shared_ptr<const Item> _head;
+		RefPtr<const Item> _head;
 	public:
 		List( )
 		{ }
-		List( A v, List tail ) : _head( std::make_shared<Item>( v, tail._head ) )
+		List( A v, List tail ) : _head( makeRef<const Item>( v, tail._head ) )
 		{ }
-		List( A&& v, List tail ) : _head( std::make_shared<Item>( v, tail._head ) )
+		List( A&& v, List tail ) : _head( makeRef<const Item>( v, tail._head ) )
 		{ }
 		List( std::initializer_list<A> init )
 		{
-			for ( auto it = std::rbegin( init ); it != std::rend( init ); ++it )
+			for ( auto it = init.end( ); it != init.begin( ); )
 			{
-				_head = std::make_shared<Item>( *it, _head );
+				_head = makeRef<const Item>( *--it, _head );
 			}
 		}
 		bool isEmpty( ) const
 		{
-			return _head == nullptr;
+			return !_head;
 		}
 		A head( ) const
 		{
@@ -69,41 +73,41 @@ namespace hp_fp
 			}
 		}
 	};
-	template<typename A>
-	List<A> concat( List<A> a, List<A> b )
+	template<typename A, typename R>
+	List<A, R> concat( List<A, R> a, List<A, R> b )
 	{
 		if ( a.isEmpty( ) )
 		{
 			return b;
 		}
-		return List<A>( a.head( ), concat( a.tail( ), b ) );
+		return List<A, R>( a.head( ), concat( a.tail( ), b ) );
 	}
-	template<typename A, typename B>
-	auto fmap( B f, List<A> lst ) -> List < decltype( f( lst.head( ) ) ) >
+	template<typename A, typename R, typename B>
+	auto fmap( B f, List<A, R> lst ) -> List < decltype( f( lst.head( ) ) ), R >
 	{
 		static_assert( std::is_convertible<B, std::function<B( A )>>::value, "fmap requires a function type B(A)" );
 		if ( lst.isEmpty( ) )
 		{
-			return List<decltype( f( lst.front( ) ) )>( );
+			return List<decltype( f( lst.head( ) ) ), R>( );
 		}
-		return List<decltype( f( lst.front( ) ) )>( f( lst.head( ) ), fmap<U>( f, lst.tail( ) ) );
+		return List<decltype( f( lst.head( ) ) ), R>( f( lst.head( ) ), fmap( f, lst.tail( ) ) );
 	}
-	template<typename A, typename B>
-	List<A> filter( B p, List<A> lst )
+	template<typename A, typename R, typename B>
+	List<A, R> filter( B p, List<A, R> lst )
 	{
 		static_assert( std::is_convertible<B, std::function<bool( A )>>::value, "filter requires a function type bool(A)" );
 		if ( lst.isEmpty( ) )
 		{
-			return List<A>( );
+			return List<A, R>( );
 		}
 		if ( p( lst.head( ) ) )
 		{
-			return List<A>( lst.head( ), filter( p, lst.tail( ) ) );
+			return List<A, R>( lst.head( ), filter( p, lst.tail( ) ) );
 		}
 		return filter( p, lst.tail( ) );
 	}
-	template<typename A, typename B, typename C>
-	B foldr( C f, B acc, List<A> lst )
+	template<typename A, typename R, typename B, typename C>
+	B foldr( C f, B acc, List<A, R> lst )
 	{
 		static_assert( std::is_convertible<C, std::function<B( A, B )>>::value, "foldr requires a function type B(A, B)" );
 		if ( lst.isEmpty( ) )
@@ -112,8 +116,8 @@ namespace hp_fp
 		}
 		return f( lst.head( ), foldr( f, acc, lst.tail( ) ) );
 	}
-	template<typename A, typename B, typename C>
-	B foldl( C f, B acc, List<A> lst )
+	template<typename A, typename R, typename B, typename C>
+	B foldl( C f, B acc, List<A, R> lst )
 	{
 		static_assert( std::is_convertible<C, std::function<B( B, A )>>::value, "foldl requires a function type B(B, A)" );
 		if ( lst.isEmpty( ) )
@@ -122,8 +126,8 @@ namespace hp_fp
 		}
 		return foldl( f, f( acc, lst.head( ) ), lst.tail( ) );
 	}
-	template<typename A, typename B>
-	void forEach( List<A> lst, B f )
+	template<typename A, typename R, typename B>
+	void forEach( List<A, R> lst, B f )
 	{
 		static_assert( std::is_convertible<B, std::function<void( A )>>::value, "forEach requires a function type void(A)" );
 		if ( !lst.isEmpty( ) )
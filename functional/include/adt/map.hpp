@@ -1,10 +1,399 @@
 #pragma once
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+#include "maybe.hpp"
+#include "../utils/refPtr.hpp"
+// Persistent hash map, a hash array mapped trie. Every node consumes 5 bits of the 32 bit key
+// hash, two bitmaps tell which of its 32 slots hold an entry and which a subnode, both are
+// stored compactly in slot order. Keys with equal hashes end up in a collision node below
+// the last level. Every change copies only the path to the changed entry, all other nodes
+// are shared with the original. A transient changes the nodes it created in place. RefCount
+// is the count of the nodes, as for Vector.
 namespace hp_fp
 {
+	const UInt32 MAP_BITS = 5;
+	const UInt32 MAP_MASK = ( 1 << MAP_BITS ) - 1;
+	// nodes at or below this shift are collision nodes
+	const UInt32 MAP_HASH_BITS = 32;
+	inline UInt32 mapPopCount( const UInt32 bits )
+	{
+#if defined( _MSC_VER )
+		return __popcnt( bits );
+#else
+		return __builtin_popcount( bits );
+#endif
+	}
+	// owner of nodes created by a transient, nodes of persistent maps have 0
+	inline UInt64 newMapEdit_IO( )
+	{
+		static std::atomic<UInt64> edit( 0 );
+		return ++edit;
+	}
 	template<typename A, typename B>
+	struct MapEntry
+	{
+		UInt32 hash;
+		A key;
+		B val;
+	};
+	// collision nodes keep only entries
+	template<typename A, typename B, typename RefCount>
+	struct MapNode : RefCounted < RefCount >
+	{
+		explicit MapNode( const UInt64 edit ) : dataMap( 0 ), nodeMap( 0 ), edit( edit )
+		{ }
+		UInt32 dataMap;
+		UInt32 nodeMap;
+		UInt64 edit;
+		std::vector<MapEntry<A, B>> entries;
+		std::vector<RefPtr<MapNode>> nodes;
+	};
+	template<typename A, typename B, typename Hash, typename RefCount>
+	struct MapTransient;
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	template<typename A, typename B, typename Hash = std::hash<A>,
+		typename RefCount = LocalRefCount>
 	struct Map
 	{
-
+	private:
+		typedef MapEntry<A, B> Entry;
+		typedef MapNode<A, B, RefCount> Node;
+		typedef RefPtr<Node> NodePtr;
+		Map( const NodePtr& root, const UInt32 size ) : _root( root ), _size( size )
+		{ }
+		NodePtr _root;
+		UInt32 _size;
+	public:
+		Map( ) : _size( 0 )
+		{ }
+		Map( std::initializer_list<std::pair<A, B>> init ) : _size( 0 )
+		{
+			MapTransient<A, B, Hash, RefCount> t( *this );
+			for ( const auto& kv : init )
+			{
+				t.insert_IO( kv.first, kv.second );
+			}
+			*this = t.persistent_IO( );
+		}
+		bool isEmpty( ) const
+		{
+			return _size == 0;
+		}
+		UInt32 size( ) const
+		{
+			return _size;
+		}
+		// value of key a, nullptr if there is none, valid as long as this map lives
+		const B* find( const A& a ) const
+		{
+			return _root ? findNode( _root.get( ), hashOf( a ), a ) : nullptr;
+		}
+		bool contains( const A& a ) const
+		{
+			return find( a ) != nullptr;
+		}
+		// map with b as the value of a, replaced if a is present already
+		Map insert( const A& a, const B& b ) const
+		{
+			bool added = false;
+			const Entry e = { hashOf( a ), a, b };
+			auto root = insertNode( _root ? _root : makeRef<Node>( 0 ), 0, e, 0, added );
+			return Map( root, added ? _size + 1 : _size );
+		}
+		Map erase( const A& a ) const
+		{
+			if ( !_root )
+			{
+				return *this;
+			}
+			bool removed = false;
+			auto root = eraseNode( _root, 0, hashOf( a ), a, 0, removed );
+			return removed ? Map( root, _size - 1 ) : *this;
+		}
+		// calls f with key and value of each entry, in no particular order
+		template<typename F>
+		void forEach( F f ) const
+		{
+			if ( _root )
+			{
+				forEachNode( *_root, f );
+			}
+		}
+		friend struct MapTransient<A, B, Hash, RefCount>;
+	private:
+		static UInt32 hashOf( const A& a )
+		{
+			const UInt64 h = Hash( )( a );
+			return static_cast<UInt32>( h ^ ( h >> 32 ) );
+		}
+		static UInt32 slot( const UInt32 hash, const UInt32 shift )
+		{
+			return 1u << ( ( hash >> shift ) & MAP_MASK );
+		}
+		// position of slot among the set bits of bitmap
+		static UInt32 index( const UInt32 bitmap, const UInt32 bit )
+		{
+			return mapPopCount( bitmap & ( bit - 1 ) );
+		}
+		// node itself when it belongs to edit, its copy belonging to edit otherwise
+		static NodePtr editable( const NodePtr& node, const UInt64 edit )
+		{
+			if ( edit != 0 && node->edit == edit )
+			{
+				return node;
+			}
+			auto copy = makeRef<Node>( *node );
+			copy->edit = edit;
+			return copy;
+		}
+		static const B* findNode( const Node* node, const UInt32 hash, const A& a )
+		{
+			for ( UInt32 shift = 0; shift < MAP_HASH_BITS; shift += MAP_BITS )
+			{
+				const UInt32 bit = slot( hash, shift );
+				if ( node->dataMap & bit )
+				{
+					const Entry& e = node->entries[index( node->dataMap, bit )];
+					return e.key == a ? &e.val : nullptr;
+				}
+				if ( !( node->nodeMap & bit ) )
+				{
+					return nullptr;
+				}
+				node = node->nodes[index( node->nodeMap, bit )].get( );
+			}
+			for ( const auto& e : node->entries )
+			{
+				if ( e.key == a )
+				{
+					return &e.val;
+				}
+			}
+			return nullptr;
+		}
+		// node at shift holding both entries
+		static NodePtr mergeEntries( const Entry& a, const Entry& b, const UInt32 shift,
+			const UInt64 edit )
+		{
+			auto n = makeRef<Node>( edit );
+			if ( shift >= MAP_HASH_BITS )
+			{
+				n->entries.push_back( a );
+				n->entries.push_back( b );
+				return n;
+			}
+			const UInt32 bitA = slot( a.hash, shift );
+			const UInt32 bitB = slot( b.hash, shift );
+			if ( bitA == bitB )
+			{
+				n->nodeMap = bitA;
+				n->nodes.push_back( mergeEntries( a, b, shift + MAP_BITS, edit ) );
+				return n;
+			}
+			n->dataMap = bitA | bitB;
+			n->entries.push_back( bitA < bitB ? a : b );
+			n->entries.push_back( bitA < bitB ? b : a );
+			return n;
+		}
+		static NodePtr insertNode( const NodePtr& node, const UInt32 shift, const Entry& e,
+			const UInt64 edit, bool& added )
+		{
+			auto n = editable( node, edit );
+			if ( shift >= MAP_HASH_BITS )
+			{
+				for ( auto& x : n->entries )
+				{
+					if ( x.key == e.key )
+					{
+						x.val = e.val;
+						return n;
+					}
+				}
+				n->entries.push_back( e );
+				added = true;
+				return n;
+			}
+			const UInt32 bit = slot( e.hash, shift );
+			if ( n->dataMap & bit )
+			{
+				const UInt32 i = index( n->dataMap, bit );
+				if ( n->entries[i].key == e.key )
+				{
+					n->entries[i].val = e.val;
+					return n;
+				}
+				auto sub = mergeEntries( n->entries[i], e, shift + MAP_BITS, edit );
+				n->entries.erase( n->entries.begin( ) + i );
+				n->dataMap ^= bit;
+				n->nodeMap |= bit;
+				n->nodes.insert( n->nodes.begin( ) + index( n->nodeMap, bit ), sub );
+				added = true;
+			}
+			else if ( n->nodeMap & bit )
+			{
+				NodePtr& child = n->nodes[index( n->nodeMap, bit )];
+				child = insertNode( child, shift + MAP_BITS, e, edit, added );
+			}
+			else
+			{
+				n->dataMap |= bit;
+				n->entries.insert( n->entries.begin( ) + index( n->dataMap, bit ), e );
+				added = true;
+			}
+			return n;
+		}
+		// node itself if a is not in it, subnodes left with a single entry are inlined into
+		// their parent so that the trie stays as deep as if a was never inserted
+		static NodePtr eraseNode( const NodePtr& node, const UInt32 shift, const UInt32 hash,
+			const A& a, const UInt64 edit, bool& removed )
+		{
+			if ( shift >= MAP_HASH_BITS )
+			{
+				for ( UInt32 i = 0; i < node->entries.size( ); ++i )
+				{
+					if ( node->entries[i].key == a )
+					{
+						auto n = editable( node, edit );
+						n->entries.erase( n->entries.begin( ) + i );
+						removed = true;
+						return n;
+					}
+				}
+				return node;
+			}
+			const UInt32 bit = slot( hash, shift );
+			if ( node->dataMap & bit )
+			{
+				const UInt32 i = index( node->dataMap, bit );
+				if ( !( node->entries[i].key == a ) )
+				{
+					return node;
+				}
+				auto n = editable( node, edit );
+				n->entries.erase( n->entries.begin( ) + i );
+				n->dataMap ^= bit;
+				removed = true;
+				return n;
+			}
+			if ( !( node->nodeMap & bit ) )
+			{
+				return node;
+			}
+			const UInt32 i = index( node->nodeMap, bit );
+			auto child = eraseNode( node->nodes[i], shift + MAP_BITS, hash, a, edit, removed );
+			if ( !removed )
+			{
+				return node;
+			}
+			auto n = editable( node, edit );
+			if ( child->nodes.empty( ) && child->entries.size( ) == 1 )
+			{
+				n->nodes.erase( n->nodes.begin( ) + i );
+				n->nodeMap ^= bit;
+				n->dataMap |= bit;
+				n->entries.insert( n->entries.begin( ) + index( n->dataMap, bit ),
+					child->entries[0] );
+			}
+			else
+			{
+				n->nodes[i] = child;
+			}
+			return n;
+		}
+		template<typename F>
+		static void forEachNode( const Node& node, F& f )
+		{
+			for ( const auto& e : node.entries )
+			{
+				f( e.key, e.val );
+			}
+			for ( const auto& child : node.nodes )
+			{
+				forEachNode( *child, f );
+			}
+		}
 	};
-}
+	// Batch builder, changes its own nodes in place instead of copying them, e.g. for filling
+	// a map with thousands of entries at startup. Maps it was created from or handed out are
+	// never changed by it.
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  0  ][  0  ][  0  ][  0  ]
+	template<typename A, typename B, typename Hash = std::hash<A>,
+		typename RefCount = LocalRefCount>
+	struct MapTransient
+	{
+	private:
+		typedef Map<A, B, Hash, RefCount> M;
+	public:
+		explicit MapTransient( const M& map = M( ) ) : _root( map._root ), _size( map._size ),
+			_edit( newMapEdit_IO( ) )
+		{ }
+		MapTransient( const MapTransient& ) = delete;
+		MapTransient operator = ( const MapTransient& ) = delete;
+		UInt32 size( ) const
+		{
+			return _size;
+		}
+		const B* find( const A& a ) const
+		{
+			return _root ? M::findNode( _root.get( ), M::hashOf( a ), a ) : nullptr;
+		}
+		void insert_IO( const A& a, const B& b )
+		{
+			bool added = false;
+			const typename M::Entry e = { M::hashOf( a ), a, b };
+			_root = M::insertNode( _root ? _root : makeRef<typename M::Node>( _edit ),
+				0, e, _edit, added );
+			_size += added ? 1 : 0;
+		}
+		void erase_IO( const A& a )
+		{
+			if ( _root )
+			{
+				bool removed = false;
+				_root = M::eraseNode( _root, 0, M::hashOf( a ), a, _edit, removed );
+				_size -= removed ? 1 : 0;
+			}
+		}
+		// map of the entries so far, the transient copies its nodes again on later changes
+		M persistent_IO( )
+		{
+			_edit = newMapEdit_IO( );
+			return M( _root, _size );
+		}
+	private:
+		typename M::NodePtr _root;
+		UInt32 _size;
+		UInt64 _edit;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
 
+	template<typename A, typename B, typename H, typename R>
+	Maybe<B> lookup( const Map<A, B, H, R>& map, const A& a )
+	{
+		const B* b = map.find( a );
+		return b ? just( B( *b ) ) : nothing<B>( );
+	}
+	template<typename A, typename B, typename H, typename R, typename C>
+	void forEach( const Map<A, B, H, R>& map, C f )
+	{
+		map.forEach( f );
+	}
+	template<typename A, typename B, typename H, typename R, typename C, typename D>
+	D foldl( C f, D acc, const Map<A, B, H, R>& map )
+	{
+		map.forEach( [&f, &acc]( const A& a, const B& b )
+		{
+			acc = f( acc, a, b );
+		} );
+		return acc;
+	}
+}
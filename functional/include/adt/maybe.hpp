@@ -1,33 +1,103 @@
 #pragma once
+#include <new>
+#include <type_traits>
+#include <utility>
 namespace hp_fp
 {
+	// value stored inline, trivially copyable values can be copied
+	template<typename A, bool Copyable = std::is_trivially_copyable<A>::value>
+	struct MaybeStorage
+	{
+		MaybeStorage( ) : engaged( false )
+		{ }
+		MaybeStorage( A&& a ) : engaged( true )
+		{
+			new ( &val ) A( std::move( a ) );
+		}
+		MaybeStorage( const MaybeStorage& ) = delete;
+		MaybeStorage( MaybeStorage&& m ) : engaged( m.engaged )
+		{
+			if ( engaged )
+			{
+				new ( &val ) A( std::move( m.get( ) ) );
+				m.get( ).~A( );
+				m.engaged = false;
+			}
+		}
+		MaybeStorage& operator = ( const MaybeStorage& ) = delete;
+		// like the move constructor m is left empty
+		MaybeStorage& operator = ( MaybeStorage&& m )
+		{
+			if ( this != &m )
+			{
+				if ( engaged )
+				{
+					get( ).~A( );
+				}
+				engaged = m.engaged;
+				if ( engaged )
+				{
+					new ( &val ) A( std::move( m.get( ) ) );
+					m.get( ).~A( );
+					m.engaged = false;
+				}
+			}
+			return *this;
+		}
+		~MaybeStorage( )
+		{
+			if ( engaged )
+			{
+				get( ).~A( );
+			}
+		}
+		A& get( ) const
+		{
+			return *const_cast<A*>( reinterpret_cast<const A*>( &val ) );
+		}
+		typename std::aligned_storage<sizeof( A ), std::alignment_of<A>::value>::type val;
+		bool engaged;
+	};
 	template<typename A>
-	struct Maybe
+	struct MaybeStorage < A, true >
 	{
-		template<typename B> friend Maybe<B> just( B&& b );
-		template<typename B> friend Maybe<B> nothing( );
-		template<typename B, typename C, typename D> friend auto ifThenElse( const Maybe<B>& maybe, C ifJust, D ifNothing ) -> decltype( ifJust( *maybe._a ) );
-		Maybe( const Maybe<A>& ) = delete;
-		Maybe( Maybe&& m ) : _a( std::move( m._a ) )
+		MaybeStorage( ) : engaged( false )
+		{ }
+		MaybeStorage( A&& a ) : engaged( true )
 		{
-			m._a = nullptr;
+			new ( &val ) A( std::move( a ) );
 		}
-		Maybe<A> operator = ( const Maybe<A>& ) = delete;
-		Maybe<A> operator = ( Maybe<A>&& m )
+		A& get( ) const
 		{
-			return Maybe<A>( std::move( m ) );
+			return *const_cast<A*>( reinterpret_cast<const A*>( &val ) );
 		}
-		~Maybe( )
+		typename std::aligned_storage<sizeof( A ), std::alignment_of<A>::value>::type val;
+		bool engaged;
+	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  *  ][  *  ][  +  ][  +  ]  * only trivially copyable A
+	template<typename A>
+	struct Maybe
+	{
+		template<typename B> friend Maybe<B> just( B&& b );
+		template<typename B> friend Maybe<B> nothing( );
+		template<typename B, typename C, typename D> friend auto ifThenElse( const Maybe<B>& maybe, C ifJust, D ifNothing ) -> decltype( ifJust( std::declval<B&>( ) ) );
+		Maybe( const Maybe<A>& m ) = default;
+		Maybe( Maybe&& m ) : _a( std::move( m._a ) )
+		{ }
+		Maybe<A>& operator = ( const Maybe<A>& m ) = default;
+		Maybe<A>& operator = ( Maybe<A>&& m )
 		{
-			HP_DELETE( _a );
+			_a = std::move( m._a );
+			return *this;
 		}
 	private:
-		Maybe( A&& a ) : _a( HP_NEW A( std::move( a ) ) )
+		Maybe( A&& a ) : _a( std::move( a ) )
 		{ }
-		Maybe( ) : _a( nullptr )
+		Maybe( ) : _a( )
 		{ }
 	private:
-		A* _a;
+		MaybeStorage<A> _a;
 	};
 	template<typename A>
 	Maybe<A> just( A&& a )
@@ -40,16 +110,15 @@ namespace hp_fp
 		return Maybe<A>( );
 	}
 	template<typename A, typename B, typename C>
-	auto ifThenElse( const Maybe<A>& maybe, B ifJust, C ifNothing ) -> decltype( ifJust( *maybe._a ) )
+	auto ifThenElse( const Maybe<A>& maybe, B ifJust, C ifNothing ) -> decltype( ifJust( std::declval<A&>( ) ) )
 	{
 		//static_assert( std::is_function<B>::value, "ifJust has to be a function." );
 		//static_assert( std::is_function<decltype( ifNothing )>::value, "ifNothing has to be a function." );
-		static_assert( std::is_same<decltype( ifJust( *maybe._a ) ), decltype( ifNothing( ) )>::value, "ifJust and ifNothing functions' return types have to be the same." );
-		if ( maybe._a == nullptr )
+		static_assert( std::is_same<decltype( ifJust( std::declval<A&>( ) ) ), decltype( ifNothing( ) )>::value, "ifJust and ifNothing functions' return types have to be the same." );
+		if ( !maybe._a.engaged )
 		{
 			return ifNothing( );
 		}
-		return ifJust( *maybe._a );
+		return ifJust( maybe._a.get( ) );
 	}
 }
-
@@ -0,0 +1,349 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "vector.hpp"
+// Parallel map, reduce and filter over immutable sequences. A sequence is cut into chunks of
+// grain elements, chunks are spread over the threads of a work-stealing pool and their
+// results are joined in chunk order. Chunk boundaries depend only on the size and the grain,
+// so results are the same for every thread count.
+namespace hp_fp
+{
+	const UInt32 PARALLEL_GRAIN = 1024;
+	// chunks of one thread, the owner pops from the back, thieves steal from the front
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<UInt32> chunks;
+	};
+	// Worker threads plus the calling thread, which works while it waits. Only one run at
+	// a time, runs must not be nested.
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  0  ][  0  ][  0  ][  0  ]
+	struct ThreadPool
+	{
+		explicit ThreadPool( const UInt32 threadCount = defaultThreadCount( ) )
+			: _queues( std::max( threadCount, 1u ) ), _job( nullptr ), _context( nullptr ),
+			_remaining( 0 ), _generation( 0 ), _stop( false )
+		{
+			for ( auto& q : _queues )
+			{
+				q.reset( new WorkQueue( ) );
+			}
+			for ( UInt32 i = 1; i < _queues.size( ); ++i )
+			{
+				_threads.push_back( std::thread( [this, i]
+				{
+					workerLoop_IO( i );
+				} ) );
+			}
+		}
+		ThreadPool( const ThreadPool& ) = delete;
+		ThreadPool operator = ( const ThreadPool& ) = delete;
+		~ThreadPool( )
+		{
+			{
+				std::lock_guard<std::mutex> lock( _mutex );
+				_stop = true;
+			}
+			_wake.notify_all( );
+			for ( auto& t : _threads )
+			{
+				t.join( );
+			}
+		}
+		static UInt32 defaultThreadCount( )
+		{
+			return std::max( std::thread::hardware_concurrency( ), 1u );
+		}
+		// including the calling thread
+		UInt32 threadCount( ) const
+		{
+			return static_cast<UInt32>( _queues.size( ) );
+		}
+		// calls f( chunk ) for each chunk in [0, chunkCount) on any thread, returns when all
+		// calls returned
+		template<typename F>
+		void run_IO( const UInt32 chunkCount, F& f )
+		{
+			if ( chunkCount == 0 )
+			{
+				return;
+			}
+			if ( chunkCount == 1 || _queues.size( ) == 1 )
+			{
+				for ( UInt32 c = 0; c < chunkCount; ++c )
+				{
+					f( c );
+				}
+				return;
+			}
+			assert( _remaining == 0 );
+			_job = &invoke<F>;
+			_context = &f;
+			_remaining = chunkCount;
+			// contiguous ranges, so that neighbouring chunks stay on one thread until stolen
+			const UInt32 n = threadCount( );
+			for ( UInt32 i = 0; i < n; ++i )
+			{
+				std::lock_guard<std::mutex> lock( _queues[i]->mutex );
+				for ( UInt32 c = chunkCount * i / n; c < chunkCount * ( i + 1 ) / n; ++c )
+				{
+					_queues[i]->chunks.push_back( c );
+				}
+			}
+			{
+				std::lock_guard<std::mutex> lock( _mutex );
+				++_generation;
+			}
+			_wake.notify_all( );
+			work_IO( 0 );
+			std::unique_lock<std::mutex> lock( _mutex );
+			_done.wait( lock, [this]
+			{
+				return _remaining == 0;
+			} );
+		}
+	private:
+		template<typename F>
+		static void invoke( void* f, const UInt32 chunk )
+		{
+			( *static_cast<F*>( f ) )( chunk );
+		}
+		bool pop_IO( const UInt32 self, UInt32& chunk )
+		{
+			{
+				WorkQueue& own = *_queues[self];
+				std::lock_guard<std::mutex> lock( own.mutex );
+				if ( !own.chunks.empty( ) )
+				{
+					chunk = own.chunks.back( );
+					own.chunks.pop_back( );
+					return true;
+				}
+			}
+			for ( UInt32 i = 1; i < _queues.size( ); ++i )
+			{
+				WorkQueue& victim = *_queues[( self + i ) % _queues.size( )];
+				std::lock_guard<std::mutex> lock( victim.mutex );
+				if ( !victim.chunks.empty( ) )
+				{
+					chunk = victim.chunks.front( );
+					victim.chunks.pop_front( );
+					return true;
+				}
+			}
+			return false;
+		}
+		// runs chunks until no queue has any, the job of a popped chunk is still current
+		// because the run cannot end before the chunk is done
+		void work_IO( const UInt32 self )
+		{
+			UInt32 chunk;
+			while ( pop_IO( self, chunk ) )
+			{
+				_job( _context, chunk );
+				if ( --_remaining == 0 )
+				{
+					std::lock_guard<std::mutex> lock( _mutex );
+					_done.notify_all( );
+				}
+			}
+		}
+		void workerLoop_IO( const UInt32 self )
+		{
+			UInt64 seen = 0;
+			for ( ;; )
+			{
+				{
+					std::unique_lock<std::mutex> lock( _mutex );
+					_wake.wait( lock, [this, seen]
+					{
+						return _stop || _generation != seen;
+					} );
+					if ( _stop )
+					{
+						return;
+					}
+					seen = _generation;
+				}
+				work_IO( self );
+			}
+		}
+		std::vector<std::unique_ptr<WorkQueue>> _queues;
+		std::vector<std::thread> _threads;
+		void( *_job )( void*, UInt32 );
+		void* _context;
+		std::atomic<UInt32> _remaining;
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		std::condition_variable _done;
+		UInt64 _generation;
+		bool _stop;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	inline UInt32 chunkCount( const UInt32 size, const UInt32 grain )
+	{
+		assert( grain > 0 );
+		return ( size + grain - 1 ) / grain;
+	}
+	// calls f for each element in [first, last)
+	template<typename A, typename F>
+	void forEachIn( const std::vector<A>& v, const UInt32 first, const UInt32 last, F& f )
+	{
+		for ( UInt32 i = first; i < last; ++i )
+		{
+			f( v[i] );
+		}
+	}
+	template<typename A, typename R, typename F>
+	void forEachIn( const Vector<A, R>& v, const UInt32 first, const UInt32 last, F& f )
+	{
+		v.forEach( first, last, std::ref( f ) );
+	}
+	// results of f over each chunk, in chunk order
+	template<typename S, typename F>
+	auto mapChunks( ThreadPool& pool, const S& s, const UInt32 grain, F f )
+		-> std::vector < decltype( f( 0u, 0u ) ) >
+	{
+		typedef decltype( f( 0u, 0u ) ) R;
+		const UInt32 size = static_cast<UInt32>( s.size( ) );
+		std::vector<R> results( chunkCount( size, grain ) );
+		auto chunk = [&results, &f, size, grain]( const UInt32 c )
+		{
+			results[c] = f( c * grain, std::min( size, ( c + 1 ) * grain ) );
+		};
+		pool.run_IO( static_cast<UInt32>( results.size( ) ), chunk );
+		return results;
+	}
+	template<typename A, typename B, typename S>
+	auto parallelMapVals( ThreadPool& pool, B f, const S& s, const UInt32 grain )
+		-> std::vector < decltype( f( std::declval<const A&>( ) ) ) >
+	{
+		typedef decltype( f( std::declval<const A&>( ) ) ) C;
+		auto chunks = mapChunks( pool, s, grain, [&f, &s]( const UInt32 first,
+			const UInt32 last )
+		{
+			std::vector<C> vals;
+			vals.reserve( last - first );
+			auto push = [&f, &vals]( const A& a )
+			{
+				vals.push_back( f( a ) );
+			};
+			forEachIn( s, first, last, push );
+			return vals;
+		} );
+		std::vector<C> vals;
+		vals.reserve( s.size( ) );
+		for ( auto& chunk : chunks )
+		{
+			std::move( chunk.begin( ), chunk.end( ), std::back_inserter( vals ) );
+		}
+		return vals;
+	}
+	template<typename A, typename B, typename S>
+	std::vector<A> parallelFilterVals( ThreadPool& pool, B p, const S& s, const UInt32 grain )
+	{
+		auto chunks = mapChunks( pool, s, grain, [&p, &s]( const UInt32 first,
+			const UInt32 last )
+		{
+			std::vector<A> vals;
+			auto push = [&p, &vals]( const A& a )
+			{
+				if ( p( a ) )
+				{
+					vals.push_back( a );
+				}
+			};
+			forEachIn( s, first, last, push );
+			return vals;
+		} );
+		UInt32 size = 0;
+		for ( const auto& chunk : chunks )
+		{
+			size += static_cast<UInt32>( chunk.size( ) );
+		}
+		std::vector<A> vals;
+		vals.reserve( size );
+		for ( auto& chunk : chunks )
+		{
+			std::move( chunk.begin( ), chunk.end( ), std::back_inserter( vals ) );
+		}
+		return vals;
+	}
+	// op has to be associative with identity as its neutral element, each chunk is folded
+	// from identity and the chunk results are folded left to right, so op takes both
+	// ( B, A ) and ( B, B )
+	template<typename A, typename B, typename C, typename S>
+	B parallelReduceVals( ThreadPool& pool, C op, const B& identity, const S& s,
+		const UInt32 grain )
+	{
+		auto chunks = mapChunks( pool, s, grain, [&op, &identity, &s]( const UInt32 first,
+			const UInt32 last )
+		{
+			B acc = identity;
+			auto step = [&op, &acc]( const A& a )
+			{
+				acc = op( acc, a );
+			};
+			forEachIn( s, first, last, step );
+			return acc;
+		} );
+		B acc = identity;
+		for ( const auto& chunk : chunks )
+		{
+			acc = op( acc, chunk );
+		}
+		return acc;
+	}
+	template<typename A, typename B>
+	auto parallelMap( ThreadPool& pool, B f, const std::vector<A>& v,
+		const UInt32 grain = PARALLEL_GRAIN )
+		-> std::vector < decltype( f( std::declval<const A&>( ) ) ) >
+	{
+		return parallelMapVals<A>( pool, f, v, grain );
+	}
+	template<typename A, typename R, typename B>
+	auto parallelMap( ThreadPool& pool, B f, const Vector<A, R>& v,
+		const UInt32 grain = PARALLEL_GRAIN )
+		-> Vector < decltype( f( std::declval<const A&>( ) ) ), R >
+	{
+		const auto vals = parallelMapVals<A>( pool, f, v, grain );
+		return Vector<decltype( f( std::declval<const A&>( ) ) ), R>( vals.begin( ),
+			vals.end( ) );
+	}
+	template<typename A, typename B>
+	std::vector<A> parallelFilter( ThreadPool& pool, B p, const std::vector<A>& v,
+		const UInt32 grain = PARALLEL_GRAIN )
+	{
+		return parallelFilterVals<A>( pool, p, v, grain );
+	}
+	template<typename A, typename R, typename B>
+	Vector<A, R> parallelFilter( ThreadPool& pool, B p, const Vector<A, R>& v,
+		const UInt32 grain = PARALLEL_GRAIN )
+	{
+		const auto vals = parallelFilterVals<A>( pool, p, v, grain );
+		return Vector<A, R>( vals.begin( ), vals.end( ) );
+	}
+	template<typename A, typename B, typename C>
+	B parallelReduce( ThreadPool& pool, C op, const B& identity, const std::vector<A>& v,
+		const UInt32 grain = PARALLEL_GRAIN )
+	{
+		return parallelReduceVals<A>( pool, op, identity, v, grain );
+	}
+	template<typename A, typename R, typename B, typename C>
+	B parallelReduce( ThreadPool& pool, C op, const B& identity, const Vector<A, R>& v,
+		const UInt32 grain = PARALLEL_GRAIN )
+	{
+		return parallelReduceVals<A>( pool, op, identity, v, grain );
+	}
+}
@@ -0,0 +1,248 @@
+#pragma once
+#include <iterator>
+#include <tuple>
+#include <vector>
+#include "list.hpp"
+#include "vector.hpp"
+// Lazy pull streams. A stream produces its elements one at a time when pulled, fmap, filter,
+// take and zip wrap it into another stream without touching any element, foldl and forEach
+// finally pull them all in one loop. No stage stores elements, so a pipeline allocates nothing
+// and its stages compose into a single pass over the source.
+namespace hp_fp
+{
+	// Source has a Value typedef and pull_IO( sink ), which calls sink with the next element
+	// and returns true or returns false when there are no more elements
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	template<typename Source>
+	struct Stream
+	{
+		typedef typename Source::Value Value;
+		explicit Stream( const Source& source ) : source( source )
+		{ }
+		template<typename F>
+		bool pull_IO( F& sink )
+		{
+			return source.pull_IO( sink );
+		}
+		Source source;
+	};
+	// elements are passed by reference, the range has to outlive the stream
+	template<typename It>
+	struct RangeSource
+	{
+		typedef typename std::iterator_traits<It>::value_type Value;
+		RangeSource( const It first, const It last ) : first( first ), last( last )
+		{ }
+		template<typename F>
+		bool pull_IO( F& sink )
+		{
+			if ( first == last )
+			{
+				return false;
+			}
+			sink( *first );
+			++first;
+			return true;
+		}
+		It first;
+		It last;
+	};
+	template<typename A, typename R>
+	struct ListSource
+	{
+		typedef A Value;
+		explicit ListSource( const List<A, R>& list ) : list( list )
+		{ }
+		template<typename F>
+		bool pull_IO( F& sink )
+		{
+			if ( list.isEmpty( ) )
+			{
+				return false;
+			}
+			sink( list.head( ) );
+			list = list.tail( );
+			return true;
+		}
+		List<A, R> list;
+	};
+	template<typename A>
+	struct VectorSource
+	{
+		typedef A Value;
+		explicit VectorSource( const Vector<A>& vector ) : vector( vector ), i( 0 )
+		{ }
+		template<typename F>
+		bool pull_IO( F& sink )
+		{
+			if ( i == vector.size( ) )
+			{
+				return false;
+			}
+			sink( vector[i++] );
+			return true;
+		}
+		Vector<A> vector;
+		UInt32 i;
+	};
+	template<typename S, typename F>
+	struct MapSource
+	{
+		typedef decltype( std::declval<F&>( )( std::declval<const typename S::Value&>( ) ) ) Value;
+		MapSource( const S& s, const F& f ) : s( s ), f( f )
+		{ }
+		template<typename G>
+		bool pull_IO( G& sink )
+		{
+			F& f = this->f;
+			auto step = [&f, &sink]( const typename S::Value& a )
+			{
+				sink( f( a ) );
+			};
+			return s.pull_IO( step );
+		}
+		S s;
+		F f;
+	};
+	template<typename S, typename P>
+	struct FilterSource
+	{
+		typedef typename S::Value Value;
+		FilterSource( const S& s, const P& p ) : s( s ), p( p )
+		{ }
+		template<typename G>
+		bool pull_IO( G& sink )
+		{
+			P& p = this->p;
+			bool passed = false;
+			auto step = [&p, &sink, &passed]( const Value& a )
+			{
+				if ( p( a ) )
+				{
+					passed = true;
+					sink( a );
+				}
+			};
+			while ( s.pull_IO( step ) )
+			{
+				if ( passed )
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+		S s;
+		P p;
+	};
+	template<typename S>
+	struct TakeSource
+	{
+		typedef typename S::Value Value;
+		TakeSource( const S& s, const UInt32 count ) : s( s ), count( count )
+		{ }
+		template<typename G>
+		bool pull_IO( G& sink )
+		{
+			if ( count == 0 )
+			{
+				return false;
+			}
+			--count;
+			return s.pull_IO( sink );
+		}
+		S s;
+		UInt32 count;
+	};
+	// tuple of references to the elements of both streams, valid during the sink call
+	template<typename S, typename T>
+	struct ZipSource
+	{
+		typedef std::tuple<const typename S::Value&, const typename T::Value&> Value;
+		ZipSource( const S& s, const T& t ) : s( s ), t( t )
+		{ }
+		template<typename G>
+		bool pull_IO( G& sink )
+		{
+			T& t = this->t;
+			bool pulled = false;
+			auto step = [&t, &sink, &pulled]( const typename S::Value& a )
+			{
+				auto both = [&a, &sink]( const typename T::Value& b )
+				{
+					sink( Value( a, b ) );
+				};
+				pulled = t.pull_IO( both );
+			};
+			return s.pull_IO( step ) && pulled;
+		}
+		S s;
+		T t;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	template<typename It>
+	Stream<RangeSource<It>> stream( const It first, const It last )
+	{
+		return Stream<RangeSource<It>>( RangeSource<It>( first, last ) );
+	}
+	template<typename A>
+	Stream<RangeSource<typename std::vector<A>::const_iterator>> stream( const std::vector<A>& v )
+	{
+		return stream( v.begin( ), v.end( ) );
+	}
+	template<typename A, typename R>
+	Stream<ListSource<A, R>> stream( const List<A, R>& list )
+	{
+		return Stream<ListSource<A, R>>( ListSource<A, R>( list ) );
+	}
+	template<typename A>
+	Stream<VectorSource<A>> stream( const Vector<A>& vector )
+	{
+		return Stream<VectorSource<A>>( VectorSource<A>( vector ) );
+	}
+	template<typename S, typename F>
+	Stream<MapSource<Stream<S>, F>> fmap( F f, const Stream<S>& s )
+	{
+		return Stream<MapSource<Stream<S>, F>>( MapSource<Stream<S>, F>( s, f ) );
+	}
+	template<typename S, typename P>
+	Stream<FilterSource<Stream<S>, P>> filter( P p, const Stream<S>& s )
+	{
+		return Stream<FilterSource<Stream<S>, P>>( FilterSource<Stream<S>, P>( s, p ) );
+	}
+	// at most the first count elements
+	template<typename S>
+	Stream<TakeSource<Stream<S>>> take( const UInt32 count, const Stream<S>& s )
+	{
+		return Stream<TakeSource<Stream<S>>>( TakeSource<Stream<S>>( s, count ) );
+	}
+	// ends with the shorter stream
+	template<typename S, typename T>
+	Stream<ZipSource<Stream<S>, Stream<T>>> zip( const Stream<S>& s, const Stream<T>& t )
+	{
+		return Stream<ZipSource<Stream<S>, Stream<T>>>( ZipSource<Stream<S>, Stream<T>>( s, t ) );
+	}
+	template<typename S, typename B, typename C>
+	B foldl( C f, B acc, Stream<S> s )
+	{
+		auto step = [&f, &acc]( const typename S::Value& a )
+		{
+			acc = f( acc, a );
+		};
+		while ( s.pull_IO( step ) )
+		{ }
+		return acc;
+	}
+	template<typename S, typename B>
+	void forEach( Stream<S> s, B f )
+	{
+		auto step = [&f]( const typename S::Value& a )
+		{
+			f( a );
+		};
+		while ( s.pull_IO( step ) )
+		{ }
+	}
+}
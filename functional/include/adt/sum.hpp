@@ -1,110 +1,157 @@
 #pragma once
-#include "../utils/typeId.hpp"
+#include <new>
+#include <type_traits>
+#include <utility>
+// Tagged union. The active type is a small integer tag computed at compile time, copy, move,
+// destruction and match dispatch through a table indexed by the tag.
 namespace hp_fp
 {
-	template<typename TypesHead, typename... TypesTail>
-	struct SumHelper
+	// index of A in Types, compile error if A is not one of them
+	template<typename A, typename... Types>
+	struct SumIndex;
+	template<typename A, typename... Types>
+	struct SumIndex < A, A, Types... >
 	{
-		inline static void destroy( const TypeId id, void * data )
-		{
-			if ( id == typeId<TypesHead>( ) )
-			{
-				reinterpret_cast<TypesHead*>( data )->~TypesHead( );
-			}
-			else
-			{
-				SumHelper<TypesTail...>::destroy( id, data );
-			}
-		}
-		inline static void copy( const TypeId id, const void* oldData, void* newData )
-		{
-			if ( id == typeId<TypesHead>( ) )
-			{
-				new (newData) TypesHead( *reinterpret_cast<const TypesHead*>( oldData ) );
-			}
-			else
-			{
-				SumHelper<TypesTail...>::copy( id, oldData, newData );
-			}
-		}
-		static const size_t val = sizeof( TypesHead ) > SumHelper<TypesTail...>::val ? sizeof( TypesHead ) : SumHelper<TypesTail...>::val;
+		static const UInt8 value = 0;
 	};
-	template<typename Type>
-	struct SumHelper < Type >
+	template<typename A, typename B, typename... Types>
+	struct SumIndex < A, B, Types... >
 	{
-		inline static void destroy( const TypeId id, void * data )
+		static const UInt8 value = 1 + SumIndex<A, Types...>::value;
+	};
+	template<typename A>
+	struct SumOps
+	{
+		static void destroy( void* data )
 		{
-			reinterpret_cast<Type*>( data )->~Type( );
+			static_cast<A*>( data )->~A( );
 		}
-		inline static void copy( const TypeId id, const void* oldData, void* newData )
+		static void copy( const void* from, void* to )
 		{
-
-			const Type* t = reinterpret_cast<const Type*>( oldData );
-			new (newData) Type( *t );
+			new ( to ) A( *static_cast<const A*>( from ) );
+		}
+		static void move( void* from, void* to )
+		{
+			new ( to ) A( std::move( *static_cast<A*>( from ) ) );
 		}
-		static const size_t val = sizeof( Type );
 	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
 	template<typename... Types>
 	struct Sum
 	{
-	public:
-		template<typename Type>
+		static_assert( sizeof...( Types ) < 256, "Sum has at most 255 types." );
+		template<typename Type, typename = typename std::enable_if<
+			!std::is_same<typename std::decay<Type>::type, Sum>::value>::type>
 		explicit Sum( Type&& value )
+			: _tag( SumIndex<typename std::decay<Type>::type, Types...>::value )
 		{
-			new ( &_data ) Type( std::forward<Type>( value ) );
-			_typeId = typeId<Type>( );
+			new ( &_data ) typename std::decay<Type>::type( std::forward<Type>( value ) );
 		}
-		template<typename Type>
-		explicit Sum( const Type& value )
+		Sum( const Sum& s ) : _tag( s._tag )
 		{
-			new ( &_data ) Type( value );
-			_typeId = typeId<Type>( );
+			copy( s );
 		}
-		Sum( const Sum& s ) : _typeId( s._typeId )
+		Sum( Sum&& s ) : _tag( s._tag )
 		{
-			SumHelper<Types...>::copy( s._typeId, &s._data, &_data );
+			move( s );
 		}
-		Sum( Sum&& s ) : _typeId( std::move( s._typeId ) ), _data( std::move( s._data ) )
-		{ }
-		Sum operator = ( const Sum& s )
+		// the current value is destroyed and the one of s constructed in its place, the tag
+		// may change
+		Sum& operator = ( const Sum& s )
 		{
-			return Sum( s );
+			if ( this != &s )
+			{
+				destroy( );
+				_tag = s._tag;
+				copy( s );
+			}
+			return *this;
 		}
-		Sum operator = ( Sum&& s )
+		Sum& operator = ( Sum&& s )
 		{
-			return Sum( std::move( s ) );
+			if ( this != &s )
+			{
+				destroy( );
+				_tag = s._tag;
+				move( s );
+			}
+			return *this;
 		}
 		~Sum( )
 		{
-			SumHelper<Types...>::destroy( _typeId, &_data );
+			destroy( );
 		}
 		template<typename Type>
 		bool is( ) const
 		{
-			return ( _typeId == typeId<Type>( ) );
+			return _tag == SumIndex<Type, Types...>::value;
 		}
 		template<typename Type>
 		Type& get( ) const
 		{
-			return reinterpret_cast<Type&>( _data );
+			return *static_cast<Type*>( data( ) );
+		}
+		UInt8 tag( ) const
+		{
+			return _tag;
+		}
+		void* data( ) const
+		{
+			return const_cast<void*>( static_cast<const void*>( &_data ) );
 		}
 	private:
-		//const static size_t size = SumHelper<Types...>::val;
-		TypeId _typeId;
-	public:
-		std::aligned_union<SumHelper<Types...>::val, Types...> _data;
+		// construct the value of s, whose tag is already set, into this
+		void copy( const Sum& s )
+		{
+			static void( *const copy[] )( const void*, void* ) = { &SumOps<Types>::copy... };
+			copy[_tag]( &s._data, &_data );
+		}
+		void move( Sum& s )
+		{
+			static void( *const move[] )( void*, void* ) = { &SumOps<Types>::move... };
+			move[_tag]( &s._data, &_data );
+		}
+		void destroy( )
+		{
+			static void( *const destroy[] )( void* ) = { &SumOps<Types>::destroy... };
+			destroy[_tag]( &_data );
+		}
+		UInt8 _tag;
+		typename std::aligned_union<0, Types...>::type _data;
 	};
-}
-// TODO: might have to add deleter like so
-//struct placement_deleter
-//{
-//	template <typename T>
-//	void operator () ( T* ptr ) const
-//	{
-//		ptr->~T( );
-//	}
-//};
-//
-//template <typename T>
-//using stack_ptr = std::unique_ptr<T, placement_deleter>;
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
 
+	template<typename R, typename A, typename F>
+	R matchAs( void* data, const void* f )
+	{
+		return ( *static_cast<const F*>( f ) )( *static_cast<A*>( data ) );
+	}
+	template<typename R, typename A, typename V>
+	R visitAs( void* data, V& visitor )
+	{
+		return visitor( *static_cast<A*>( data ) );
+	}
+	// one function per type of the sum in the order of its types, all returning the same type
+	template<typename A, typename... Types, typename F, typename... Fs>
+	auto match( const Sum<A, Types...>& sum, F f, Fs... fs ) -> decltype( f( std::declval<A&>( ) ) )
+	{
+		static_assert( sizeof...( Types ) == sizeof...( Fs ), "match needs one function per type." );
+		typedef decltype( f( std::declval<A&>( ) ) ) R;
+		static R( *const table[] )( void*, const void* ) = {
+			&matchAs<R, A, F>, &matchAs<R, Types, Fs>...
+		};
+		const void* fns[] = { &f, &fs... };
+		return table[sum.tag( )]( sum.data( ), fns[sum.tag( )] );
+	}
+	// visitor with call operator for each type of the sum, all returning the same type
+	template<typename A, typename... Types, typename V>
+	auto visit( const Sum<A, Types...>& sum, V& visitor ) -> decltype( visitor( std::declval<A&>( ) ) )
+	{
+		typedef decltype( visitor( std::declval<A&>( ) ) ) R;
+		static R( *const table[] )( void*, V& ) = {
+			&visitAs<R, A, V>, &visitAs<R, Types, V>...
+		};
+		return table[sum.tag( )]( sum.data( ), visitor );
+	}
+}
@@ -1,22 +1,224 @@
 #pragma once
-#include <adt/list.hpp>
+#include <cassert>
+#include <initializer_list>
+#include <vector>
+#include "vector.hpp"
+// Persistent n-ary tree. Children of a node are kept in a Vector, so that they are stored in
+// chunks of 32 and a single child is replaced by copying only its chunk. Changing a node
+// copies the nodes on its path from the root, all other subtrees are shared. RefCount is
+// the count of the nodes and of their child vectors, as for Vector.
 namespace hp_fp
 {
-	template<typename A>
+	// child indices from the root to a node, empty for the root
+	typedef std::vector<UInt32> TreePath;
+	template<typename A, typename RefCount>
+	struct TreeNode : RefCounted < RefCount >
+	{
+		TreeNode( const A& val, const Vector<RefPtr<const TreeNode>, RefCount>& children,
+			const UInt32 size ) : val( val ), children( children ), size( size )
+		{ }
+		A val;
+		Vector<RefPtr<const TreeNode>, RefCount> children;
+		// number of nodes in the subtree
+		UInt32 size;
+	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	template<typename A, typename RefCount = LocalRefCount>
 	struct Tree
 	{
 	private:
-		struct Item
-		{
-			Item( A v ) : val( v )
-			{ }
-			A _node;
-			List<std::shared_ptr<const Item>> _leaves;
-		};
-		friend Item;
-		List<std::shared_ptr<const Item>> _root;
+		typedef TreeNode<A, RefCount> Node;
+		typedef RefPtr<const Node> NodePtr;
+		explicit Tree( const NodePtr& root ) : _root( root )
+		{ }
+		NodePtr _root;
 	public:
-
+		Tree( )
+		{ }
+		explicit Tree( const A& a ) : _root( makeRef<const Node>( a,
+			Vector<NodePtr, RefCount>( ), 1 ) )
+		{ }
+		Tree( const A& a, const Vector<Tree, RefCount>& children )
+		{
+			std::vector<NodePtr> nodes;
+			nodes.reserve( children.size( ) );
+			UInt32 size = 1;
+			children.forEach( [&nodes, &size]( const Tree& child )
+			{
+				assert( child._root );
+				nodes.push_back( child._root );
+				size += child.size( );
+			} );
+			_root = makeRef<const Node>( a,
+				Vector<NodePtr, RefCount>( nodes.begin( ), nodes.end( ) ), size );
+		}
+		Tree( const A& a, std::initializer_list<Tree> children )
+			: Tree( a, Vector<Tree, RefCount>( children ) )
+		{ }
+		bool isEmpty( ) const
+		{
+			return !_root;
+		}
+		// number of nodes, O(1)
+		UInt32 size( ) const
+		{
+			return _root ? _root->size : 0;
+		}
+		const A& value( ) const
+		{
+			assert( _root );
+			return _root->val;
+		}
+		UInt32 childCount( ) const
+		{
+			return _root ? _root->children.size( ) : 0;
+		}
+		Tree child( const UInt32 i ) const
+		{
+			return Tree( _root->children[i] );
+		}
+		const A& at( const TreePath& path ) const
+		{
+			const Node* node = _root.get( );
+			for ( const auto i : path )
+			{
+				node = node->children[i].get( );
+			}
+			return node->val;
+		}
+		Tree update( const TreePath& path, const A& a ) const
+		{
+			return modify( path, [&a]( const A& )
+			{
+				return a;
+			} );
+		}
+		// node at path replaced by f of its value
+		template<typename F>
+		Tree modify( const TreePath& path, F f ) const
+		{
+			auto replace = [&f]( const Node& n )
+			{
+				return makeRef<const Node>( f( n.val ), n.children, n.size );
+			};
+			return Tree( modifyNode( _root, path, 0, replace ) );
+		}
+		// child appended as last child of the node at path
+		Tree addChild( const TreePath& path, const Tree& child ) const
+		{
+			assert( child._root );
+			auto add = [&child]( const Node& n )
+			{
+				return makeRef<const Node>( n.val, n.children.pushBack( child._root ),
+					n.size + child.size( ) );
+			};
+			return Tree( modifyNode( _root, path, 0, add ) );
+		}
+		// i-th child of the node at path removed with its subtree, copies the child chunks
+		Tree removeChild( const TreePath& path, const UInt32 i ) const
+		{
+			auto remove = [i]( const Node& n )
+			{
+				std::vector<NodePtr> nodes;
+				nodes.reserve( n.children.size( ) - 1 );
+				UInt32 j = 0;
+				n.children.forEach( [&nodes, &j, i]( const NodePtr& c )
+				{
+					if ( j++ != i )
+					{
+						nodes.push_back( c );
+					}
+				} );
+				return makeRef<const Node>( n.val, Vector<NodePtr, RefCount>( nodes.begin( ),
+					nodes.end( ) ), n.size - n.children[i]->size );
+			};
+			return Tree( modifyNode( _root, path, 0, remove ) );
+		}
+		// calls f for each value breadth first, level by level and children in order
+		template<typename F>
+		void forEach( F f ) const
+		{
+			if ( !_root )
+			{
+				return;
+			}
+			std::vector<const Node*> level( 1, _root.get( ) );
+			std::vector<const Node*> next;
+			while ( !level.empty( ) )
+			{
+				for ( const auto node : level )
+				{
+					f( node->val );
+					node->children.forEach( [&next]( const NodePtr& c )
+					{
+						next.push_back( c.get( ) );
+					} );
+				}
+				level.swap( next );
+				next.clear( );
+			}
+		}
+		template<typename B, typename R, typename C>
+		friend auto fmap( C f, const Tree<B, R>& t )
+			-> Tree < decltype( f( std::declval<const B&>( ) ) ), R >;
+		template<typename B, typename R>
+		friend struct Tree;
+	private:
+		template<typename F>
+		static NodePtr modifyNode( const NodePtr& node, const TreePath& path, const UInt32 depth,
+			F& f )
+		{
+			assert( node );
+			if ( depth == path.size( ) )
+			{
+				return f( *node );
+			}
+			const UInt32 i = path[depth];
+			const NodePtr& old = node->children[i];
+			const NodePtr child = modifyNode( old, path, depth + 1, f );
+			return makeRef<const Node>( node->val, node->children.update( i, child ),
+				node->size - old->size + child->size );
+		}
+		template<typename B, typename F>
+		static RefPtr<const TreeNode<B, RefCount>> mapNode( const Node& node, F& f )
+		{
+			std::vector<RefPtr<const TreeNode<B, RefCount>>> nodes;
+			nodes.reserve( node.children.size( ) );
+			node.children.forEach( [&nodes, &f]( const NodePtr& c )
+			{
+				nodes.push_back( mapNode<B>( *c, f ) );
+			} );
+			return makeRef<const TreeNode<B, RefCount>>( f( node.val ),
+				Vector<RefPtr<const TreeNode<B, RefCount>>, RefCount>( nodes.begin( ),
+				nodes.end( ) ), node.size );
+		}
 	};
-}
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
 
+	template<typename A, typename R, typename B>
+	auto fmap( B f, const Tree<A, R>& t ) -> Tree < decltype( f( std::declval<const A&>( ) ) ), R >
+	{
+		typedef decltype( f( std::declval<const A&>( ) ) ) C;
+		if ( t.isEmpty( ) )
+		{
+			return Tree<C, R>( );
+		}
+		return Tree<C, R>( Tree<A, R>::template mapNode<C>( *t._root, f ) );
+	}
+	template<typename A, typename R, typename B>
+	void forEach( const Tree<A, R>& t, B f )
+	{
+		t.forEach( f );
+	}
+	// breadth first
+	template<typename A, typename R, typename B, typename C>
+	B foldl( C f, B acc, const Tree<A, R>& t )
+	{
+		t.forEach( [&f, &acc]( const A& a )
+		{
+			acc = f( acc, a );
+		} );
+		return acc;
+	}
+}
@@ -0,0 +1,671 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "../utils/refPtr.hpp"
+// Persistent vector, a 32-way trie with its last leaf kept aside as tail. Branches built by
+// concat are relaxed, they keep cumulative sizes of their subtrees (RRB-tree). Every change
+// copies only the path to the changed leaf, all other nodes are shared with the original.
+// Nodes are pool allocated and intrusively counted, RefCount is LocalRefCount for vectors
+// used by one thread, AtomicRefCount for vectors shared across threads.
+namespace hp_fp
+{
+	const UInt32 VECTOR_BITS = 5;
+	const UInt32 VECTOR_WIDTH = 1 << VECTOR_BITS;
+	const UInt32 VECTOR_MASK = VECTOR_WIDTH - 1;
+	// base of leaves and branches, so that a branch can hold either
+	template<typename A, typename RefCount>
+	struct VectorNode : RefCounted < RefCount >
+	{
+		explicit VectorNode( const bool isLeaf ) : isLeaf( isLeaf )
+		{ }
+		bool isLeaf;
+	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  0  ][  0  ][  0  ][  0  ]
+	template<typename A, typename RefCount>
+	struct VectorLeaf : VectorNode < A, RefCount >
+	{
+		VectorLeaf( ) : VectorNode<A, RefCount>( true ), count( 0 )
+		{ }
+		VectorLeaf( const VectorLeaf& ) = delete;
+		VectorLeaf operator = ( const VectorLeaf& ) = delete;
+		~VectorLeaf( )
+		{
+			for ( UInt32 i = 0; i < count; ++i )
+			{
+				vals( )[i].~A( );
+			}
+		}
+		A* vals( ) const
+		{
+			return const_cast<A*>( reinterpret_cast<const A*>( &storage ) );
+		}
+		void push_IO( const A& a )
+		{
+			new ( vals( ) + count ) A( a );
+			++count;
+		}
+		UInt32 count;
+		typename std::aligned_storage<sizeof( A ) * VECTOR_WIDTH,
+			std::alignment_of<A>::value>::type storage;
+	};
+	// children are leaves in branches at shift 5 and branches above
+	template<typename A, typename RefCount>
+	struct VectorBranch : VectorNode < A, RefCount >
+	{
+		VectorBranch( ) : VectorNode<A, RefCount>( false ), count( 0 ), relaxed( false )
+		{ }
+		UInt32 count;
+		// relaxed branch can have partial children, sizes are cumulative sizes of children
+		bool relaxed;
+		std::array<RefPtr<const VectorNode<A, RefCount>>, VECTOR_WIDTH> children;
+		std::array<UInt32, VECTOR_WIDTH> sizes;
+	};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	template<typename A, typename RefCount = LocalRefCount>
+	struct Vector
+	{
+	private:
+		typedef VectorLeaf<A, RefCount> Leaf;
+		typedef VectorBranch<A, RefCount> Branch;
+		typedef RefPtr<const VectorNode<A, RefCount>> NodePtr;
+		typedef RefPtr<const Branch> BranchPtr;
+		typedef RefPtr<const Leaf> LeafPtr;
+		Vector( const BranchPtr& root, const LeafPtr& tail, const UInt32 size, const UInt32 shift )
+			: _root( root ), _tail( tail ), _size( size ), _shift( shift )
+		{ }
+		BranchPtr _root;
+		LeafPtr _tail;
+		UInt32 _size;
+		UInt32 _shift;
+	public:
+		Vector( ) : _size( 0 ), _shift( VECTOR_BITS )
+		{ }
+		Vector( std::initializer_list<A> init ) : _size( 0 ), _shift( VECTOR_BITS )
+		{
+			*this = fromRange( init.begin( ), init.end( ) );
+		}
+		template<typename It>
+		Vector( It first, It last ) : _size( 0 ), _shift( VECTOR_BITS )
+		{
+			*this = fromRange( first, last );
+		}
+		bool isEmpty( ) const
+		{
+			return _size == 0;
+		}
+		UInt32 size( ) const
+		{
+			return _size;
+		}
+		const A& operator [] ( const UInt32 i ) const
+		{
+			assert( i < _size );
+			UInt32 idx = i;
+			return leafAt( idx ).vals( )[idx];
+		}
+		Vector pushBack( const A& a ) const
+		{
+			if ( _tail && _tail->count < VECTOR_WIDTH )
+			{
+				auto tail = copyLeaf( *_tail );
+				tail->push_IO( a );
+				return Vector( _root, tail, _size + 1, _shift );
+			}
+			auto tail = makeRef<Leaf>( );
+			tail->push_IO( a );
+			if ( !_tail )
+			{
+				return Vector( _root, tail, _size + 1, _shift );
+			}
+			if ( !_root )
+			{
+				return Vector( newPath( VECTOR_BITS, _tail, false ), tail, _size + 1, VECTOR_BITS );
+			}
+			BranchPtr root = pushLeaf( _root, _shift, _tail, false );
+			if ( root )
+			{
+				return Vector( root, tail, _size + 1, _shift );
+			}
+			return Vector( grow( _root, _shift, _tail, _root->relaxed ), tail, _size + 1,
+				_shift + VECTOR_BITS );
+		}
+		Vector update( const UInt32 i, const A& a ) const
+		{
+			assert( i < _size );
+			if ( i >= tailOffset( ) )
+			{
+				return Vector( _root, copyLeaf( *_tail, i - tailOffset( ), &a ), _size, _shift );
+			}
+			return Vector( staticRefCast<const Branch>(
+				updateNode( _root, _shift, i, a ) ), _tail, _size, _shift );
+		}
+		// calls f for each element in order, leaf by leaf
+		template<typename F>
+		void forEach( F f ) const
+		{
+			if ( _root )
+			{
+				forEachNode( _root.get( ), _shift, f );
+			}
+			if ( _tail )
+			{
+				forEachNode( _tail.get( ), 0, f );
+			}
+		}
+		// calls f for each element in [first, last) in order, one leaf lookup per leaf
+		template<typename F>
+		void forEach( const UInt32 first, const UInt32 last, F f ) const
+		{
+			assert( first <= last && last <= _size );
+			for ( UInt32 i = first; i < last; )
+			{
+				UInt32 idx = i;
+				const Leaf& l = leafAt( idx );
+				const UInt32 n = std::min( l.count - idx, last - i );
+				for ( UInt32 j = idx; j < idx + n; ++j )
+				{
+					f( l.vals( )[j] );
+				}
+				i += n;
+			}
+		}
+		template<typename B, typename R>
+		friend Vector<B, R> concat( const Vector<B, R>& a, const Vector<B, R>& b );
+	private:
+		UInt32 tailOffset( ) const
+		{
+			return _size - ( _tail ? _tail->count : 0 );
+		}
+		// leaf containing element idx, idx is made relative to the leaf
+		const Leaf& leafAt( UInt32& idx ) const
+		{
+			if ( idx >= tailOffset( ) )
+			{
+				idx -= tailOffset( );
+				return *_tail;
+			}
+			const void* node = _root.get( );
+			for ( UInt32 shift = _shift; shift > 0; shift -= VECTOR_BITS )
+			{
+				const UInt32 j = childIndex( *branch( node ), shift, idx );
+				node = branch( node )->children[j].get( );
+			}
+			idx &= VECTOR_MASK;
+			return *leaf( node );
+		}
+		static const Branch* branch( const void* node )
+		{
+			return static_cast<const Branch*>( node );
+		}
+		static const Leaf* leaf( const void* node )
+		{
+			return static_cast<const Leaf*>( node );
+		}
+		// child containing idx, idx is made relative to the child
+		static UInt32 childIndex( const Branch& b, const UInt32 shift, UInt32& idx )
+		{
+			if ( !b.relaxed )
+			{
+				return ( idx >> shift ) & VECTOR_MASK;
+			}
+			UInt32 j = idx >> shift;
+			while ( b.sizes[j] <= idx )
+			{
+				++j;
+			}
+			if ( j > 0 )
+			{
+				idx -= b.sizes[j - 1];
+			}
+			return j;
+		}
+		static UInt32 nodeSize( const void* node, const UInt32 shift )
+		{
+			if ( shift == 0 )
+			{
+				return leaf( node )->count;
+			}
+			const Branch& b = *branch( node );
+			if ( b.relaxed )
+			{
+				return b.sizes[b.count - 1];
+			}
+			return ( ( b.count - 1 ) << shift ) +
+				nodeSize( b.children[b.count - 1].get( ), shift - VECTOR_BITS );
+		}
+		// number of children or elements
+		static UInt32 nodeCount( const void* node, const UInt32 shift )
+		{
+			return shift == 0 ? leaf( node )->count : branch( node )->count;
+		}
+		static RefPtr<Leaf> copyLeaf( const Leaf& l, const UInt32 replace = VECTOR_WIDTH,
+			const A* a = nullptr )
+		{
+			auto copy = makeRef<Leaf>( );
+			for ( UInt32 i = 0; i < l.count; ++i )
+			{
+				copy->push_IO( i == replace ? *a : l.vals( )[i] );
+			}
+			return copy;
+		}
+		static void setSizes_IO( Branch& b, const UInt32 shift )
+		{
+			b.relaxed = true;
+			UInt32 size = 0;
+			for ( UInt32 i = 0; i < b.count; ++i )
+			{
+				size += nodeSize( b.children[i].get( ), shift - VECTOR_BITS );
+				b.sizes[i] = size;
+			}
+		}
+		static void addChild_IO( Branch& b, const NodePtr& child, const UInt32 childSize )
+		{
+			b.children[b.count] = child;
+			if ( b.relaxed )
+			{
+				b.sizes[b.count] = ( b.count > 0 ? b.sizes[b.count - 1] : 0 ) + childSize;
+			}
+			++b.count;
+		}
+		// branch at shift with leaf as its only descendant
+		static BranchPtr newPath( const UInt32 shift, const LeafPtr& l, const bool relaxed )
+		{
+			auto b = makeRef<Branch>( );
+			b->relaxed = relaxed;
+			addChild_IO( *b, shift == VECTOR_BITS ? NodePtr( l )
+				: NodePtr( newPath( shift - VECTOR_BITS, l, relaxed ) ), l->count );
+			return b;
+		}
+		// appends leaf to the rightmost path, nothing if the path is full, relaxed turns the
+		// copied branches into relaxed ones so that the leaf may be partial
+		static BranchPtr pushLeaf( const BranchPtr& b, const UInt32 shift, const LeafPtr& l,
+			const bool relaxed )
+		{
+			RefPtr<Branch> copy;
+			if ( shift > VECTOR_BITS )
+			{
+				auto child = pushLeaf( staticRefCast<const Branch>(
+					b->children[b->count - 1] ), shift - VECTOR_BITS, l, relaxed );
+				if ( child )
+				{
+					copy = makeRef<Branch>( *b );
+					if ( relaxed && !copy->relaxed )
+					{
+						setSizes_IO( *copy, shift );
+					}
+					copy->children[copy->count - 1] = child;
+					if ( copy->relaxed )
+					{
+						copy->sizes[copy->count - 1] += l->count;
+					}
+					return copy;
+				}
+			}
+			if ( b->count == VECTOR_WIDTH )
+			{
+				return nullptr;
+			}
+			copy = makeRef<Branch>( *b );
+			if ( relaxed && !copy->relaxed )
+			{
+				setSizes_IO( *copy, shift );
+			}
+			addChild_IO( *copy, shift == VECTOR_BITS ? NodePtr( l )
+				: NodePtr( newPath( shift - VECTOR_BITS, l, relaxed ) ), l->count );
+			return copy;
+		}
+		// new root one level above full root, with leaf in its second child
+		static BranchPtr grow( const BranchPtr& root, const UInt32 shift, const LeafPtr& l,
+			const bool relaxed )
+		{
+			auto b = makeRef<Branch>( );
+			b->relaxed = relaxed;
+			addChild_IO( *b, root, relaxed ? nodeSize( root.get( ), shift ) : 0 );
+			addChild_IO( *b, newPath( shift, l, relaxed ), l->count );
+			return b;
+		}
+		static NodePtr updateNode( const NodePtr& node, const UInt32 shift, UInt32 idx, const A& a )
+		{
+			if ( shift == 0 )
+			{
+				return copyLeaf( *leaf( node.get( ) ), idx & VECTOR_MASK, &a );
+			}
+			auto copy = makeRef<Branch>( *branch( node.get( ) ) );
+			const UInt32 j = childIndex( *copy, shift, idx );
+			copy->children[j] = updateNode( copy->children[j], shift - VECTOR_BITS, idx, a );
+			return copy;
+		}
+		template<typename F>
+		static void forEachNode( const void* node, const UInt32 shift, F& f )
+		{
+			if ( shift == 0 )
+			{
+				const Leaf& l = *leaf( node );
+				for ( UInt32 i = 0; i < l.count; ++i )
+				{
+					f( l.vals( )[i] );
+				}
+				return;
+			}
+			const Branch& b = *branch( node );
+			for ( UInt32 i = 0; i < b.count; ++i )
+			{
+				forEachNode( b.children[i].get( ), shift - VECTOR_BITS, f );
+			}
+		}
+		// builds full leaves bottom up, the last leaf becomes the tail
+		template<typename It>
+		static Vector fromRange( It first, It last )
+		{
+			std::vector<NodePtr> level;
+			RefPtr<Leaf> l;
+			UInt32 size = 0;
+			for ( ; first != last; ++first, ++size )
+			{
+				if ( !l || l->count == VECTOR_WIDTH )
+				{
+					if ( l )
+					{
+						level.push_back( l );
+					}
+					l = makeRef<Leaf>( );
+				}
+				l->push_IO( *first );
+			}
+			if ( level.empty( ) )
+			{
+				return Vector( nullptr, l, size, VECTOR_BITS );
+			}
+			UInt32 shift = 0;
+			do
+			{
+				shift += VECTOR_BITS;
+				std::vector<NodePtr> parents;
+				for ( UInt32 i = 0; i < level.size( ); i += VECTOR_WIDTH )
+				{
+					auto b = makeRef<Branch>( );
+					for ( UInt32 j = i; j < level.size( ) && j < i + VECTOR_WIDTH; ++j )
+					{
+						addChild_IO( *b, level[j], 0 );
+					}
+					parents.push_back( b );
+				}
+				level.swap( parents );
+			} while ( level.size( ) > 1 );
+			return Vector( staticRefCast<const Branch>( level[0] ), l, size,
+				shift );
+		}
+		// sizes of nodes after redistributing the children of too sparse nodes into their
+		// neighbours, at most 2 more nodes than the optimum are left
+		static std::vector<UInt32> concatPlan( std::vector<UInt32> sizes )
+		{
+			const UInt32 extras = 2;
+			UInt32 total = 0;
+			for ( const auto s : sizes )
+			{
+				total += s;
+			}
+			const UInt32 optimal = ( total + VECTOR_WIDTH - 1 ) / VECTOR_WIDTH;
+			UInt32 i = 0;
+			while ( sizes.size( ) > optimal + extras )
+			{
+				while ( sizes[i] > VECTOR_WIDTH - extras / 2 )
+				{
+					++i;
+				}
+				UInt32 rest = sizes[i];
+				while ( rest > 0 && i + 1 < sizes.size( ) )
+				{
+					const UInt32 s = std::min( rest + sizes[i + 1], VECTOR_WIDTH );
+					sizes[i] = s;
+					rest = rest + sizes[i + 1] - s;
+					++i;
+				}
+				sizes.erase( sizes.begin( ) + i );
+				i = i > 0 ? i - 1 : 0;
+			}
+			return sizes;
+		}
+		// nodes at shift with children taken in order from nodes, sized according to plan,
+		// nodes matching the plan are shared
+		static std::vector<NodePtr> executePlan( const std::vector<NodePtr>& nodes,
+			const std::vector<UInt32>& plan, const UInt32 shift )
+		{
+			std::vector<NodePtr> result;
+			UInt32 k = 0;
+			UInt32 offset = 0;
+			for ( const auto size : plan )
+			{
+				if ( offset == 0 && nodeCount( nodes[k].get( ), shift ) == size )
+				{
+					result.push_back( nodes[k++] );
+					continue;
+				}
+				RefPtr<Leaf> l;
+				RefPtr<Branch> b;
+				if ( shift == 0 )
+				{
+					l = makeRef<Leaf>( );
+				}
+				else
+				{
+					b = makeRef<Branch>( );
+				}
+				for ( UInt32 taken = 0; taken < size; ++taken )
+				{
+					if ( shift == 0 )
+					{
+						l->push_IO( leaf( nodes[k].get( ) )->vals( )[offset] );
+					}
+					else
+					{
+						addChild_IO( *b, branch( nodes[k].get( ) )->children[offset], 0 );
+					}
+					if ( ++offset == nodeCount( nodes[k].get( ), shift ) )
+					{
+						++k;
+						offset = 0;
+					}
+				}
+				if ( b )
+				{
+					setSizes_IO( *b, shift );
+				}
+				result.push_back( shift == 0 ? NodePtr( l ) : NodePtr( b ) );
+			}
+			return result;
+		}
+		// merges children of left without its last, center and right without its first,
+		// returns branch at shift + 5 with one or two children
+		static BranchPtr rebalance( const Branch* left, const Branch& center,
+			const Branch* right, const UInt32 shift )
+		{
+			std::vector<NodePtr> nodes;
+			if ( left )
+			{
+				nodes.insert( nodes.end( ), left->children.begin( ),
+					left->children.begin( ) + left->count - 1 );
+			}
+			nodes.insert( nodes.end( ), center.children.begin( ),
+				center.children.begin( ) + center.count );
+			if ( right )
+			{
+				nodes.insert( nodes.end( ), right->children.begin( ) + 1,
+					right->children.begin( ) + right->count );
+			}
+			std::vector<UInt32> sizes;
+			for ( const auto& node : nodes )
+			{
+				sizes.push_back( nodeCount( node.get( ), shift - VECTOR_BITS ) );
+			}
+			nodes = executePlan( nodes, concatPlan( sizes ), shift - VECTOR_BITS );
+			auto top = makeRef<Branch>( );
+			top->relaxed = true;
+			for ( UInt32 i = 0; i < nodes.size( ); i += VECTOR_WIDTH )
+			{
+				auto b = makeRef<Branch>( );
+				for ( UInt32 j = i; j < nodes.size( ) && j < i + VECTOR_WIDTH; ++j )
+				{
+					addChild_IO( *b, nodes[j], 0 );
+				}
+				setSizes_IO( *b, shift );
+				addChild_IO( *top, b, nodeSize( b.get( ), shift ) );
+			}
+			return top;
+		}
+		// concatenation of two trees as branch at the higher shift + 5
+		static BranchPtr concatTrees( const NodePtr& left, const UInt32 leftShift,
+			const NodePtr& right, const UInt32 rightShift )
+		{
+			if ( leftShift > rightShift )
+			{
+				const Branch& l = *branch( left.get( ) );
+				auto center = concatTrees( l.children[l.count - 1], leftShift - VECTOR_BITS,
+					right, rightShift );
+				return rebalance( &l, *center, nullptr, leftShift );
+			}
+			if ( leftShift < rightShift )
+			{
+				const Branch& r = *branch( right.get( ) );
+				auto center = concatTrees( left, leftShift, r.children[0],
+					rightShift - VECTOR_BITS );
+				return rebalance( nullptr, *center, &r, rightShift );
+			}
+			if ( leftShift == 0 )
+			{
+				auto b = makeRef<Branch>( );
+				b->relaxed = true;
+				addChild_IO( *b, left, leaf( left.get( ) )->count );
+				addChild_IO( *b, right, leaf( right.get( ) )->count );
+				return b;
+			}
+			const Branch& l = *branch( left.get( ) );
+			const Branch& r = *branch( right.get( ) );
+			auto center = concatTrees( l.children[l.count - 1], leftShift - VECTOR_BITS,
+				r.children[0], rightShift - VECTOR_BITS );
+			return rebalance( &l, *center, &r, leftShift );
+		}
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	// children of branches are released as the leaf or branch they are
+	template<typename A, typename RefCount>
+	void releaseRef_IO( VectorNode<A, RefCount>* node )
+	{
+		if ( node->isLeaf )
+		{
+			releaseRef_IO<VectorLeaf<A, RefCount>>( static_cast<VectorLeaf<A, RefCount>*>( node ) );
+		}
+		else
+		{
+			releaseRef_IO<VectorBranch<A, RefCount>>(
+				static_cast<VectorBranch<A, RefCount>*>( node ) );
+		}
+	}
+	// O(log n) for vectors with non-empty trees, b's elements are pushed otherwise
+	template<typename A, typename R>
+	Vector<A, R> concat( const Vector<A, R>& a, const Vector<A, R>& b )
+	{
+		typedef Vector<A, R> V;
+		if ( a.isEmpty( ) )
+		{
+			return b;
+		}
+		if ( !b._root )
+		{
+			V result = a;
+			b.forEach( [&result]( const A& x )
+			{
+				result = result.pushBack( x );
+			} );
+			return result;
+		}
+		// tree of a with its tail as the last, possibly partial, leaf
+		typename V::BranchPtr left;
+		UInt32 leftShift = a._shift;
+		if ( !a._root )
+		{
+			left = V::newPath( VECTOR_BITS, a._tail, true );
+		}
+		else
+		{
+			left = V::pushLeaf( a._root, a._shift, a._tail, true );
+			if ( !left )
+			{
+				left = V::grow( a._root, a._shift, a._tail, true );
+				leftShift += VECTOR_BITS;
+			}
+		}
+		auto root = V::concatTrees( left, leftShift, b._root, b._shift );
+		UInt32 shift = std::max( leftShift, b._shift ) + VECTOR_BITS;
+		while ( shift > VECTOR_BITS && root->count == 1 )
+		{
+			root = staticRefCast<const typename V::Branch>( root->children[0] );
+			shift -= VECTOR_BITS;
+		}
+		return V( root, b._tail, a._size + b._size, shift );
+	}
+	template<typename A, typename R, typename B, typename C>
+	B foldr( C f, B acc, const Vector<A, R>& v )
+	{
+		std::vector<const A*> vals;
+		vals.reserve( v.size( ) );
+		v.forEach( [&vals]( const A& a )
+		{
+			vals.push_back( &a );
+		} );
+		for ( auto it = vals.rbegin( ); it != vals.rend( ); ++it )
+		{
+			acc = f( **it, acc );
+		}
+		return acc;
+	}
+	template<typename A, typename R, typename B, typename C>
+	B foldl( C f, B acc, const Vector<A, R>& v )
+	{
+		v.forEach( [&f, &acc]( const A& a )
+		{
+			acc = f( acc, a );
+		} );
+		return acc;
+	}
+	template<typename A, typename R, typename B>
+	void forEach( const Vector<A, R>& v, B f )
+	{
+		v.forEach( f );
+	}
+	template<typename A, typename R, typename B>
+	auto fmap( B f, const Vector<A, R>& v )
+		-> Vector < decltype( f( std::declval<const A&>( ) ) ), R >
+	{
+		typedef decltype( f( std::declval<const A&>( ) ) ) C;
+		std::vector<C> vals;
+		vals.reserve( v.size( ) );
+		v.forEach( [&f, &vals]( const A& a )
+		{
+			vals.push_back( f( a ) );
+		} );
+		return Vector<C, R>( vals.begin( ), vals.end( ) );
+	}
+	template<typename A, typename R, typename B>
+	Vector<A, R> filter( B p, const Vector<A, R>& v )
+	{
+		std::vector<A> vals;
+		v.forEach( [&p, &vals]( const A& a )
+		{
+			if ( p( a ) )
+			{
+				vals.push_back( a );
+			}
+		} );
+		return Vector<A, R>( vals.begin( ), vals.end( ) );
+	}
+}
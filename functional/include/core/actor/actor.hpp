@@ -1,12 +1,15 @@
 #pragma once
 #include <functional>
 #include <vector>
+#include "../../adt/frp/batch.hpp"
 #include "../../adt/frp/sf.hpp"
+#include "../../adt/sum.hpp"
 #include "../../graphics/material.hpp"
 #include "../../graphics/model.hpp"
 #include "../../graphics/renderer.hpp"
 #include "../../math/mat4x4.hpp"
 #include "../../math/quat.hpp"
+#include "../../utils/inplaceFn.hpp"
 #include "../../window/gameInput.hpp"
 namespace hp_fp
 {
@@ -33,6 +36,10 @@ namespace hp_fp
 		GameInput gameInput;
 		ActorState state;
 	};
+	// all actors of a batch tape see the same game input
+	template<>
+	struct IsBatchShared<GameInput> : std::true_type
+	{ };
 	struct ActorOutput
 	{
 		ActorState state;
@@ -42,7 +49,9 @@ namespace hp_fp
 		ModelDef model;
 		MaterialDef material;
 	};
-	typedef std::function<void( Renderer&, const ActorState&, const Mat4x4& )> CamRenderFn;
+	// render callbacks are stored inline in the actor, copying them never allocates
+	typedef InplaceFn<void( Renderer&, const ActorState&, const Mat4x4& )> RenderFn;
+	typedef RenderFn CamRenderFn;
 	struct ActorCameraDef;
 	typedef CamRenderFn( *InitCamRenderFn )( const ActorCameraDef&, const WindowConfig& );
 	struct ActorCameraDef
@@ -51,51 +60,60 @@ namespace hp_fp
 		float farClipDist;
 		InitCamRenderFn render;
 	};
-	struct ActorTypeDef
-	{
-		template<typename A>
-		bool is( ) const
-		{
-			return ( _typeId == typeId<A>( ) );
-		}
-	private:
-		TypeId _typeId;
-	public:
-		union
-		{
-			ActorModelDef model;
-			ActorCameraDef camera;
-		};
-		friend ActorTypeDef actorModelDef( ActorModelDef&& m );
-		friend ActorTypeDef actorCameraDef( ActorCameraDef&& c );
-	};
+	typedef Sum<ActorModelDef, ActorCameraDef> ActorTypeDef;
 	struct ActorDef
 	{
 		ActorTypeDef type;
 		ActorStartingState startingState;
 		SF<ActorInput, ActorOutput> sf;
 		std::vector<ActorDef> children;
+		// optional batch tape of sf, actors sharing it are evaluated together
+		std::shared_ptr<BatchTape<ActorInput, ActorOutput>> batch;
+	};
+	struct Actor;
+	struct StaticActor;
+	// actors of one level of the hierarchy, the static ones apart so that steps never visit them
+	struct Actors
+	{
+		std::vector<Actor> dynamic;
+		std::vector<StaticActor> statics;
 	};
 	struct Actor
 	{
 		ActorState state;
-		SF<ActorInput, ActorOutput> sf;
-		std::function<void( Renderer&, const ActorState&, const Mat4x4& )> render_IO;
-		std::vector<Actor> children;
+		// state before the last simulation step, rendering interpolates from it to state
+		ActorState previousState;
+		SFInstance<ActorInput, ActorOutput> sf;
+		RenderFn render_IO;
+		Actors children;
+		std::shared_ptr<BatchTape<ActorInput, ActorOutput>> batch;
+	};
+	// actor with an identity or constant SF, it is never sampled and has no SF instance, its
+	// transform is computed once
+	struct StaticActor
+	{
+		ActorState state;
+		RenderFn render_IO;
+		Actors children;
+		Mat4x4 transform;
 	};
 	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
 
 	ActorTypeDef actorModelDef( ActorModelDef&& m );
 	ActorTypeDef actorCameraDef( ActorCameraDef&& c );
-	std::function<void( Renderer&, const ActorState&, const Mat4x4& )>
-		initActorRenderFunction_IO( Renderer& renderer, Resources& resources,
+	RenderFn initActorRenderFunction_IO( Renderer& renderer, Resources& resources,
 		const ActorDef& actorDef );
+	// SF of actors which never move, e.g. level geometry
+	SF<ActorInput, ActorOutput> staticActor( );
+	bool isStatic( const SF<ActorInput, ActorOutput>& sf );
 	Mat4x4 trasformMatFromActorState( const ActorState& actorState );
 	Mat4x4 modelTrasformMatFromActorState( const ActorState& actorState );
+	// previous at alpha = 0, current at alpha = 1
+	ActorState interpolate( const ActorState& previous, const ActorState& current,
+		const float alpha );
 	namespace
 	{
-		std::function<void( Renderer&, const ActorState&, const Mat4x4& )>  renderActor_IO(
-			ActorResources& res );
+		RenderFn renderActor_IO( ActorResources& res );
 	}
 }
 
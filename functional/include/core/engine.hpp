@@ -1,4 +1,5 @@
 #pragma once
+#include <unordered_map>
 #include "actor/actor.hpp"
 #include "../window/gameInput.hpp"
 #include "../window/window.hpp"
@@ -31,18 +32,47 @@ namespace hp_fp
 		EngineState state;
 		GameInput gameInput;
 	};
+	// actors sampled by one batch tape and their states, one array per field of ActorState
+	struct ActorBatch
+	{
+		std::vector<Actor*> actors;
+		std::vector<FVec3> pos;
+		std::vector<FVec3> vel;
+		std::vector<FVec3> scl;
+		std::vector<FQuat> rot;
+		std::vector<FQuat> modelRot;
+		// whole states and inputs, filled only for networks which read them
+		std::vector<ActorState> states;
+		std::vector<ActorInput> inputs;
+		std::vector<ActorOutput> outputs;
+	};
+	// actors are created only at start, so the batches are built once
+	typedef std::unordered_map<BatchTape<ActorInput, ActorOutput>*, ActorBatch> ActorBatches;
 	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
 
+	// most simulation steps in one frame, time beyond them is dropped so that slow frames do
+	// not pile up steps
+	const UInt32 MAX_SIMULATION_STEPS = 5;
 	Engine init( String&& name );
+	// Actors are simulated in fixed steps of simulationStepMs and rendered every frame,
+	// interpolated between their last two states. A step of 0 simulates once per frame with
+	// the frame time.
 	void run_IO( Engine& engine, std::vector<ActorDef>&& actorDefs,
-		const WindowConfig& windowConfig = defaultWindowConfig_IO( ) );
+		const WindowConfig& windowConfig = defaultWindowConfig_IO( ),
+		const float simulationStepMs = 0.0f );
 	namespace
 	{
-		void renderActors_IO( Renderer& renderer, std::vector<Actor>& actors,
-			const GameInput& gameInput, const float deltaMs,
+		void stepActors_IO( Actors& actors, const GameInput& gameInput, const float deltaMs );
+		void renderActors_IO( Renderer& renderer, Actors& actors, const float alpha,
 			const Mat4x4& parentLocalTransform = Mat4x4::identity );
-		std::vector<Actor> initActors_IO( Renderer& renderer, Resources& resources,
-			std::vector<ActorDef>&& actorsDef );
+		ActorState renderedState( const Actor& actor, const float alpha );
+		void sampleBatches_IO( ActorBatches& batches, const GameInput& gameInput,
+			const float deltaMs );
+		BatchView batchView( ActorBatch& batch, const GameInput& gameInput, const UInt32 offset,
+			const UInt32 size );
+		void addBatches_IO( ActorBatches& batches, Actors& actors );
+		Actors initActors_IO( Renderer& renderer, Resources& resources,
+			const GameInput& gameInput, std::vector<ActorDef>&& actorsDef );
 	}
 }
 
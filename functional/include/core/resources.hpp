@@ -1,19 +1,22 @@
 #pragma once
-#include <map>
+#include <memory>
 #include <tuple>
 #include "actor/actor.hpp"
+#include "../adt/map.hpp"
 #include "../graphics/model.hpp"
 #include "../graphics/material.hpp"
 namespace hp_fp
 {
+	// copies are snapshots sharing the loaded models and materials, which keep their
+	// addresses for as long as any snapshot holds them
 	// [const][cop-c][cop-a][mov-c][mov-a]
-	// [  +  ][  0  ][  0  ][  0  ][  0  ]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
 	struct Resources
 	{
-		std::map<LoadedModelDef, Maybe<Model>> loadedModels;
-		std::map<BuiltInModelDef, Maybe<Model>> builtInModels;
-		std::map<MaterialDef, Maybe<Material>> materials;
-		std::map<String, ID3D11ShaderResourceView*> textures;
+		Map<LoadedModelDef, std::shared_ptr<Maybe<Model>>> loadedModels;
+		Map<BuiltInModelDef, std::shared_ptr<Maybe<Model>>> builtInModels;
+		Map<MaterialDef, std::shared_ptr<Maybe<Material>>> materials;
+		Map<String, ID3D11ShaderResourceView*> textures;
 	};
 	struct ActorResources
 	{
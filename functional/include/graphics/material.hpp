@@ -4,6 +4,7 @@
 #include "../math/mat4x4.hpp"
 #include "../math/color.hpp"
 #include "../math/vec2.hpp"
+#include "../utils/hash.hpp"
 namespace hp_fp
 {
 	struct MaterialDef
@@ -241,4 +242,22 @@ namespace hp_fp
 	UInt32 getPassCount( Material& material );
 	void applyPass_IO( Renderer& renderer, Material& material, UInt32 i );
 }
-
+namespace std
+{
+	// filenames are hashed by address, as they are compared
+	template<>
+	struct hash < hp_fp::MaterialDef >
+	{
+		size_t operator () ( const hp_fp::MaterialDef& m ) const
+		{
+			const hash<const char*> h;
+			size_t seed = h( m.diffuseTextureFilename );
+			seed = hp_fp::hashCombine( seed, h( m.specularTextureFilename ) );
+			seed = hp_fp::hashCombine( seed, h( m.bumpTextureFilename ) );
+			seed = hp_fp::hashCombine( seed, h( m.parallaxTextureFilename ) );
+			seed = hp_fp::hashCombine( seed, h( m.evnMapTextureFilename ) );
+			seed = hp_fp::hashCombine( seed, hash<float>( )( m.textureRepeat.x ) );
+			return hp_fp::hashCombine( seed, hash<float>( )( m.textureRepeat.y ) );
+		}
+	};
+}
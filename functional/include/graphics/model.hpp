@@ -5,7 +5,7 @@
 #include "../adt/maybe.hpp"
 #include "../adt/sum.hpp"
 #include "../math/vec3.hpp"
-#include "../utils/typeId.hpp"
+#include "../utils/hash.hpp"
 namespace hp_fp
 {
 	struct Renderer;
@@ -47,25 +47,7 @@ namespace hp_fp
 			return filename < m.filename;
 		}
 	};
-	//typedef Sum<BuiltInModelDef, LoadedModelDef> ModelDef;
-	struct ModelDef
-	{
-		template<typename A>
-		bool is( ) const
-		{
-			return ( _typeId == typeId<A>( ) );
-		}
-	private:
-		TypeId _typeId;
-	public:
-		union
-		{
-			BuiltInModelDef builtIn;
-			LoadedModelDef loaded;
-		};
-		friend ModelDef builtInModelDef( BuiltInModelDef&& m );
-		friend ModelDef loadedModelDef( LoadedModelDef&& m );
-	};
+	typedef Sum<BuiltInModelDef, LoadedModelDef> ModelDef;
 	// [const][cop-c][cop-a][mov-c][mov-a]
 	// [  +  ][  0  ][  0  ][  +  ][  +  ]
 	struct Mesh
@@ -126,4 +108,27 @@ namespace hp_fp
 		Model cubeMesh( const FVec3& dimensions );
 	}
 }
-
+namespace std
+{
+	template<>
+	struct hash < hp_fp::BuiltInModelDef >
+	{
+		size_t operator () ( const hp_fp::BuiltInModelDef& m ) const
+		{
+			const hash<float> h;
+			size_t seed = static_cast<size_t>( m.type );
+			seed = hp_fp::hashCombine( seed, h( m.dimensions.x ) );
+			seed = hp_fp::hashCombine( seed, h( m.dimensions.y ) );
+			return hp_fp::hashCombine( seed, h( m.dimensions.z ) );
+		}
+	};
+	// filename is hashed by address, as it is compared
+	template<>
+	struct hash < hp_fp::LoadedModelDef >
+	{
+		size_t operator () ( const hp_fp::LoadedModelDef& m ) const
+		{
+			return hp_fp::hashCombine( hash<const char*>( )( m.filename ), hash<float>( )( m.scale ) );
+		}
+	};
+}
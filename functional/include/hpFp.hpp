@@ -1,7 +1,18 @@
 #pragma once
 #include <core/engine.hpp>
+#include <adt/map.hpp>
 #include <adt/maybe.hpp>
+#include <adt/parallel.hpp>
+#include <adt/stream.hpp>
 #include <adt/sum.hpp>
+#include <adt/tree.hpp>
+#include <adt/vector.hpp>
 #include <adt/frp/sfs.hpp>
+#include <adt/frp/fused.hpp>
+#include <adt/frp/tape.hpp>
+#include <adt/frp/batch.hpp>
 #include <math/frustum.hpp>
+#include <math/transformBatch.hpp>
+#include <math/vec4A.hpp>
+#include <math/quatA.hpp>
 
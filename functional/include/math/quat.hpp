@@ -1,4 +1,5 @@
 #pragma once
+#include "trig.hpp"
 #include "vec3.hpp"
 namespace hp_fp
 {
@@ -32,16 +33,15 @@ namespace hp_fp
 	template<typename A>
 	Quat<A> eulerRadToQuat( const Vec3<A>& vec )
 	{
-		Quat<A> quat;
-		quat.x = sin( vec.y / 2.0f ) * cos( vec.x / 2.0f ) * sin( vec.z / 2.0f ) +
-			cos( vec.y / 2.0f ) * sin( vec.x / 2.0f ) * cos( vec.z / 2.0f );
-		quat.y = sin( vec.y / 2.0f ) * cos( vec.x / 2.0f ) * cos( vec.z / 2.0f ) -
-			cos( vec.y / 2.0f ) * sin( vec.x / 2.0f ) * sin( vec.z / 2.0f );
-		quat.z = cos( vec.y / 2.0f ) * cos( vec.x / 2.0f ) * sin( vec.z / 2.0f ) -
-			sin( vec.y / 2.0f ) * sin( vec.x / 2.0f ) * cos( vec.z / 2.0f );
-		quat.w = cos( vec.y / 2.0f ) * cos( vec.x / 2.0f ) * cos( vec.z / 2.0f ) +
-			sin( vec.y / 2.0f ) * sin( vec.x / 2.0f ) * sin( vec.z / 2.0f );
-		return quat;
+		float sinX, cosX, sinY, cosY, sinZ, cosZ;
+		sinCos( vec.x / 2.0f, sinX, cosX );
+		sinCos( vec.y / 2.0f, sinY, cosY );
+		sinCos( vec.z / 2.0f, sinZ, cosZ );
+		return Quat<A>(
+			sinY * cosX * sinZ + cosY * sinX * cosZ,
+			sinY * cosX * cosZ - cosY * sinX * sinZ,
+			cosY * cosX * sinZ - sinY * sinX * cosZ,
+			cosY * cosX * cosZ + sinY * sinX * sinZ );
 	}
 	template<typename A>
 	Quat<A> conjugate( const Quat<A>& quat )
@@ -49,10 +49,72 @@ namespace hp_fp
 		return Quat < A > {-quat.x, -quat.y, -quat.z, quat.w};
 	}
 	template<typename A>
+	A dot( const Quat<A>& quat1, const Quat<A>& quat2 )
+	{
+		return quat1.x * quat2.x + quat1.y * quat2.y + quat1.z * quat2.z + quat1.w * quat2.w;
+	}
+	// zero quaternion stays zero
+	template<typename A>
+	Quat<A> normalize( const Quat<A>& quat )
+	{
+		const float len = sqrtf( dot( quat, quat ) );
+		if ( len == 0.0f )
+		{
+			return Quat<A>( 0.0f, 0.0f, 0.0f, 0.0f );
+		}
+		const float scale = 1.0f / len;
+		return Quat<A>( quat.x * scale, quat.y * scale, quat.z * scale, quat.w * scale );
+	}
+	// Normalized component-wise lerp of unit quaternions along the shorter arc, quat1 at t = 0
+	// and quat2 at t = 1. Its angular speed is not constant, it is close to slerp for the small
+	// steps between simulation states.
+	template<typename A>
+	Quat<A> nlerp( const Quat<A>& quat1, const Quat<A>& quat2, const float t )
+	{
+		// q and -q are the same rotation
+		const float t2 = dot( quat1, quat2 ) < 0.0f ? -t : t;
+		const float t1 = 1.0f - t;
+		return normalize( Quat<A>(
+			quat1.x * t1 + quat2.x * t2,
+			quat1.y * t1 + quat2.y * t2,
+			quat1.z * t1 + quat2.z * t2,
+			quat1.w * t1 + quat2.w * t2 ) );
+	}
+	// slerp falls back to nlerp above this cosine, where sin of the angle loses precision
+	const float SLERP_NLERP_COS = 0.9995f;
+	// spherical lerp of unit quaternions along the shorter arc at constant angular speed
+	template<typename A>
+	Quat<A> slerp( const Quat<A>& quat1, const Quat<A>& quat2, const float t )
+	{
+		const float cosAngle = dot( quat1, quat2 );
+		const float absCosAngle = fabsf( cosAngle );
+		if ( absCosAngle > SLERP_NLERP_COS )
+		{
+			return nlerp( quat1, quat2, t );
+		}
+		const float angle = acosf( absCosAngle );
+		const float invSinAngle = 1.0f / sinf( angle );
+		const float t1 = sinf( ( 1.0f - t ) * angle ) * invSinAngle;
+		const float t2 = sinf( t * angle ) * invSinAngle * ( cosAngle < 0.0f ? -1.0f : 1.0f );
+		return Quat<A>(
+			quat1.x * t1 + quat2.x * t2,
+			quat1.y * t1 + quat2.y * t2,
+			quat1.z * t1 + quat2.z * t2,
+			quat1.w * t1 + quat2.w * t2 );
+	}
+	// conjugate( quat ) * vec * quat for a unit quaternion, expanded into two cross products
+	template<typename A>
 	Vec3<A> rotate( const Vec3<A>& vec, const Quat<A>& quat )
 	{
-		auto rotated = conjugate( quat ) * Quat < A > {vec.x, vec.y, vec.z, 1.0f} *quat;
-		return Vec3 < A > {rotated.x, rotated.y, rotated.z};
-	};
+		const Vec3<A> u{ quat.x, quat.y, quat.z };
+		const Vec3<A> t = 2.0f * cross( u, vec );
+		return vec + quat.w * t + cross( u, t );
+	}
+	// quats[i] = eulerRadToQuat( euler[i] ) for i < count, the half-angle sines and cosines
+	// are polynomials within the error bound of accuracy
+	void eulerRadToQuat_IO( const FVec3* euler, const UInt32 count, FQuat* quats,
+		const TrigAccuracy accuracy = TrigAccuracy::Precise );
+	// rotated[i] = rotate( vecs[i], quats[i] ) for i < count
+	void rotate_IO( const FVec3* vecs, const FQuat* quats, const UInt32 count, FVec3* rotated );
 }
 
@@ -0,0 +1,122 @@
+#pragma once
+#include <cmath>
+#include "simd.hpp"
+#include "quat.hpp"
+// 16-byte aligned quaternion held in a SIMD register, lanes are x, y, z, w like FQuat.
+namespace hp_fp
+{
+	struct HP_ALIGN( 16 ) FQuatA
+	{
+#if defined( HP_SIMD_SSE )
+		__m128 v;
+#else
+		float v[4];
+#endif
+		FQuatA operator * ( const FQuatA& q ) const;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	inline FQuatA quatA( const float x, const float y, const float z, const float w )
+	{
+#if defined( HP_SIMD_SSE )
+		return FQuatA{ _mm_setr_ps( x, y, z, w ) };
+#else
+		return FQuatA{ { x, y, z, w } };
+#endif
+	}
+	inline FQuatA load( const FQuat& quat )
+	{
+#if defined( HP_SIMD_SSE )
+		return FQuatA{ _mm_loadu_ps( &quat.x ) };
+#else
+		return quatA( quat.x, quat.y, quat.z, quat.w );
+#endif
+	}
+	inline FQuat storeQuat( const FQuatA& quat )
+	{
+		FQuat result;
+#if defined( HP_SIMD_SSE )
+		_mm_storeu_ps( &result.x, quat.v );
+#else
+		result = FQuat( quat.v[0], quat.v[1], quat.v[2], quat.v[3] );
+#endif
+		return result;
+	}
+	// same product as FQuat, each lane of q is multiplied by one lane of this quaternion and
+	// a sign mask replaces the scalar additions and subtractions
+	inline FQuatA FQuatA::operator * ( const FQuatA& q ) const
+	{
+#if defined( HP_SIMD_SSE )
+		const __m128 x = _mm_shuffle_ps( v, v, HP_SHUFFLE( 0, 0, 0, 0 ) );
+		const __m128 y = _mm_shuffle_ps( v, v, HP_SHUFFLE( 1, 1, 1, 1 ) );
+		const __m128 z = _mm_shuffle_ps( v, v, HP_SHUFFLE( 2, 2, 2, 2 ) );
+		const __m128 w = _mm_shuffle_ps( v, v, HP_SHUFFLE( 3, 3, 3, 3 ) );
+		const __m128 qwzyx = _mm_shuffle_ps( q.v, q.v, HP_SHUFFLE( 3, 2, 1, 0 ) );
+		const __m128 qzwxy = _mm_shuffle_ps( q.v, q.v, HP_SHUFFLE( 2, 3, 0, 1 ) );
+		const __m128 qyxwz = _mm_shuffle_ps( q.v, q.v, HP_SHUFFLE( 1, 0, 3, 2 ) );
+		const __m128 signX = _mm_setr_ps( 0.0f, 0.0f, -0.0f, -0.0f );
+		const __m128 signY = _mm_setr_ps( -0.0f, 0.0f, 0.0f, -0.0f );
+		const __m128 signZ = _mm_setr_ps( 0.0f, -0.0f, 0.0f, -0.0f );
+		__m128 r = _mm_mul_ps( w, q.v );
+		r = _mm_add_ps( r, _mm_xor_ps( _mm_mul_ps( x, qwzyx ), signX ) );
+		r = _mm_add_ps( r, _mm_xor_ps( _mm_mul_ps( y, qzwxy ), signY ) );
+		r = _mm_add_ps( r, _mm_xor_ps( _mm_mul_ps( z, qyxwz ), signZ ) );
+		return FQuatA{ r };
+#else
+		return quatA(
+			v[0] * q.v[3] + v[3] * q.v[0] + v[2] * q.v[1] - v[1] * q.v[2],
+			v[1] * q.v[3] - v[2] * q.v[0] + v[3] * q.v[1] + v[0] * q.v[2],
+			v[2] * q.v[3] + v[1] * q.v[0] - v[0] * q.v[1] + v[3] * q.v[2],
+			v[3] * q.v[3] - v[0] * q.v[0] - v[1] * q.v[1] - v[2] * q.v[2] );
+#endif
+	}
+	inline FQuatA conjugate( const FQuatA& quat )
+	{
+#if defined( HP_SIMD_SSE )
+		return FQuatA{ _mm_xor_ps( quat.v, _mm_setr_ps( -0.0f, -0.0f, -0.0f, 0.0f ) ) };
+#else
+		return quatA( -quat.v[0], -quat.v[1], -quat.v[2], quat.v[3] );
+#endif
+	}
+#if defined( HP_SIMD_SSE )
+	// sum of all four lanes of v1 * v2 in all lanes
+	HP_FORCE_INLINE __m128 dot4( const __m128 v1, const __m128 v2 )
+	{
+		const __m128 m = _mm_mul_ps( v1, v2 );
+		const __m128 s = _mm_add_ps( m, _mm_shuffle_ps( m, m, HP_SHUFFLE( 1, 0, 3, 2 ) ) );
+		return _mm_add_ps( s, _mm_shuffle_ps( s, s, HP_SHUFFLE( 2, 3, 0, 1 ) ) );
+	}
+#endif
+	inline float dot( const FQuatA& quat1, const FQuatA& quat2 )
+	{
+#if defined( HP_SIMD_SSE )
+		return _mm_cvtss_f32( dot4( quat1.v, quat2.v ) );
+#else
+		return quat1.v[0] * quat2.v[0] + quat1.v[1] * quat2.v[1] + quat1.v[2] * quat2.v[2] +
+			quat1.v[3] * quat2.v[3];
+#endif
+	}
+	inline float length( const FQuatA& quat )
+	{
+		return sqrtf( dot( quat, quat ) );
+	}
+	// zero quaternion stays zero
+	inline FQuatA normalize( const FQuatA& quat )
+	{
+#if defined( HP_SIMD_SSE )
+		const __m128 len = _mm_sqrt_ps( dot4( quat.v, quat.v ) );
+		const __m128 nonZero = _mm_cmpneq_ps( len, _mm_setzero_ps( ) );
+		const __m128 scale = _mm_and_ps( _mm_div_ps( _mm_set1_ps( 1.0f ), len ), nonZero );
+		return FQuatA{ _mm_mul_ps( quat.v, scale ) };
+#else
+		const float len = length( quat );
+		if ( len == 0.0f )
+		{
+			return quatA( 0.0f, 0.0f, 0.0f, 0.0f );
+		}
+		const float scale = 1.0f / len;
+		return quatA( quat.v[0] * scale, quat.v[1] * scale, quat.v[2] * scale,
+			quat.v[3] * scale );
+#endif
+	}
+}
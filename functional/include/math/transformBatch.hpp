@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include "mat4x4.hpp"
+// Transforms of a whole hierarchy as structure of arrays, nodes are in topological order so
+// that every parent comes before its children. worldTransforms_IO computes all world matrices
+// in one pass, four nodes per iteration with SSE.
+namespace hp_fp
+{
+	const UInt32 NO_PARENT = 0xFFFFFFFF;
+	struct TransformBatch
+	{
+		std::vector<float> posX, posY, posZ;
+		std::vector<float> rotX, rotY, rotZ, rotW;
+		std::vector<float> sclX, sclY, sclZ;
+		// index of the parent, lower than the index of the node, or NO_PARENT
+		std::vector<UInt32> parents;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	inline UInt32 size( const TransformBatch& batch )
+	{
+		return static_cast<UInt32>( batch.parents.size( ) );
+	}
+	// index of the new node
+	UInt32 push_IO( TransformBatch& batch, const FVec3& pos, const FQuat& rot, const FVec3& scl,
+		const UInt32 parent = NO_PARENT );
+	// world[i] = rotSclPosToMat4x4( rot[i], scl[i], pos[i], world[parents[i]] ), world has to
+	// hold size( batch ) matrices
+	void worldTransforms_IO( const TransformBatch& batch, Mat4x4* world );
+	void worldTransformsScalar_IO( const TransformBatch& batch, Mat4x4* world );
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cmath>
+// Sine and cosine of one angle in one call, and array versions that evaluate polynomials on
+// four angles at a time with SSE.
+namespace hp_fp
+{
+	// max absolute error of the polynomials of sinCos_IO for |rad| up to 8192
+	enum struct TrigAccuracy : UInt8
+	{
+		// 4e-5, one polynomial term less for sine and two less for cosine
+		Fast,
+		// 1e-7, close to sinf and cosf
+		Precise
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	inline void sinCos( const float rad, float& s, float& c )
+	{
+#if defined( __GNUC__ )
+		__builtin_sincosf( rad, &s, &c );
+#else
+		s = sin( rad );
+		c = cos( rad );
+#endif
+	}
+	// s[i] and c[i] are the sine and cosine of rad[i], i < count
+	void sinCos_IO( const float* rad, const UInt32 count, float* s, float* c,
+		const TrigAccuracy accuracy = TrigAccuracy::Precise );
+}
@@ -113,5 +113,14 @@ namespace hp_fp
 		}
 		return vec;
 	}
+	// vec1 at t = 0, vec2 at t = 1
+	template<typename A>
+	Vec3<A> lerp( const Vec3<A>& vec1, const Vec3<A>& vec2, const float t )
+	{
+		return Vec3 < A > {
+			vec1.x * ( 1.0f - t ) + vec2.x * t,
+				vec1.y * ( 1.0f - t ) + vec2.y * t,
+				vec1.z * ( 1.0f - t ) + vec2.z * t };
+	}
 }
 
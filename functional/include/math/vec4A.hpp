@@ -0,0 +1,199 @@
+#pragma once
+#include <cmath>
+#include "simd.hpp"
+#include "vec3.hpp"
+#include "vec4.hpp"
+// 16-byte aligned vector held in a SIMD register. Arithmetic works on all four lanes, dot,
+// cross, length, normalize and clampMag on x, y and z like their FVec3 versions, so FVec3
+// loads with w = 0 and stores back unchanged. Packed types keep their layout, e.g. in Vertex.
+namespace hp_fp
+{
+	struct HP_ALIGN( 16 ) FVec4A
+	{
+#if defined( HP_SIMD_SSE )
+		__m128 v;
+#else
+		float v[4];
+#endif
+		FVec4A operator + ( const FVec4A& vec ) const;
+		FVec4A operator - ( const FVec4A& vec ) const;
+		FVec4A operator - ( ) const;
+		bool operator == ( const FVec4A& vec ) const;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	inline FVec4A vec4A( const float x, const float y, const float z, const float w = 0.0f )
+	{
+#if defined( HP_SIMD_SSE )
+		return FVec4A{ _mm_setr_ps( x, y, z, w ) };
+#else
+		return FVec4A{ { x, y, z, w } };
+#endif
+	}
+	inline FVec4A load( const FVec3& vec )
+	{
+		return vec4A( vec.x, vec.y, vec.z );
+	}
+	inline FVec4A load( const FVec4& vec )
+	{
+#if defined( HP_SIMD_SSE )
+		return FVec4A{ _mm_loadu_ps( &vec.x ) };
+#else
+		return vec4A( vec.x, vec.y, vec.z, vec.w );
+#endif
+	}
+	inline FVec3 storeVec3( const FVec4A& vec )
+	{
+#if defined( HP_SIMD_SSE )
+		HP_ALIGN( 16 ) float v[4];
+		_mm_store_ps( v, vec.v );
+		return FVec3{ v[0], v[1], v[2] };
+#else
+		return FVec3{ vec.v[0], vec.v[1], vec.v[2] };
+#endif
+	}
+	inline FVec4 storeVec4( const FVec4A& vec )
+	{
+		FVec4 result;
+#if defined( HP_SIMD_SSE )
+		_mm_storeu_ps( &result.x, vec.v );
+#else
+		result = FVec4( vec.v[0], vec.v[1], vec.v[2], vec.v[3] );
+#endif
+		return result;
+	}
+	// lane i of vec
+	inline float get( const FVec4A& vec, const UInt32 i )
+	{
+#if defined( HP_SIMD_SSE )
+		HP_ALIGN( 16 ) float v[4];
+		_mm_store_ps( v, vec.v );
+		return v[i];
+#else
+		return vec.v[i];
+#endif
+	}
+	inline FVec4A FVec4A::operator + ( const FVec4A& vec ) const
+	{
+#if defined( HP_SIMD_SSE )
+		return FVec4A{ _mm_add_ps( v, vec.v ) };
+#else
+		return vec4A( v[0] + vec.v[0], v[1] + vec.v[1], v[2] + vec.v[2], v[3] + vec.v[3] );
+#endif
+	}
+	inline FVec4A FVec4A::operator - ( const FVec4A& vec ) const
+	{
+#if defined( HP_SIMD_SSE )
+		return FVec4A{ _mm_sub_ps( v, vec.v ) };
+#else
+		return vec4A( v[0] - vec.v[0], v[1] - vec.v[1], v[2] - vec.v[2], v[3] - vec.v[3] );
+#endif
+	}
+	inline FVec4A FVec4A::operator - ( ) const
+	{
+#if defined( HP_SIMD_SSE )
+		return FVec4A{ _mm_xor_ps( v, _mm_set1_ps( -0.0f ) ) };
+#else
+		return vec4A( -v[0], -v[1], -v[2], -v[3] );
+#endif
+	}
+	inline bool FVec4A::operator == ( const FVec4A& vec ) const
+	{
+#if defined( HP_SIMD_SSE )
+		return _mm_movemask_ps( _mm_cmpeq_ps( v, vec.v ) ) == 0xF;
+#else
+		return v[0] == vec.v[0] && v[1] == vec.v[1] && v[2] == vec.v[2] && v[3] == vec.v[3];
+#endif
+	}
+	inline FVec4A operator * ( const float scalar, const FVec4A& vec )
+	{
+#if defined( HP_SIMD_SSE )
+		return FVec4A{ _mm_mul_ps( vec.v, _mm_set1_ps( scalar ) ) };
+#else
+		return vec4A( vec.v[0] * scalar, vec.v[1] * scalar, vec.v[2] * scalar,
+			vec.v[3] * scalar );
+#endif
+	}
+	inline FVec4A operator * ( const FVec4A& vec, const float scalar )
+	{
+		return scalar * vec;
+	}
+	inline FVec4A operator / ( const FVec4A& vec, const float scalar )
+	{
+#if defined( HP_SIMD_SSE )
+		return FVec4A{ _mm_div_ps( vec.v, _mm_set1_ps( scalar ) ) };
+#else
+		return vec4A( vec.v[0] / scalar, vec.v[1] / scalar, vec.v[2] / scalar,
+			vec.v[3] / scalar );
+#endif
+	}
+#if defined( HP_SIMD_SSE )
+	// x * x + y * y + z * z of v1 * v2 in all lanes, summed in the order of FVec3 dot
+	HP_FORCE_INLINE __m128 dot3( const __m128 v1, const __m128 v2 )
+	{
+		const __m128 m = _mm_mul_ps( v1, v2 );
+		const __m128 x = _mm_shuffle_ps( m, m, HP_SHUFFLE( 0, 0, 0, 0 ) );
+		const __m128 y = _mm_shuffle_ps( m, m, HP_SHUFFLE( 1, 1, 1, 1 ) );
+		const __m128 z = _mm_shuffle_ps( m, m, HP_SHUFFLE( 2, 2, 2, 2 ) );
+		return _mm_add_ps( _mm_add_ps( x, y ), z );
+	}
+#endif
+	inline float dot( const FVec4A& vec1, const FVec4A& vec2 )
+	{
+#if defined( HP_SIMD_SSE )
+		return _mm_cvtss_f32( dot3( vec1.v, vec2.v ) );
+#else
+		return vec1.v[0] * vec2.v[0] + vec1.v[1] * vec2.v[1] + vec1.v[2] * vec2.v[2];
+#endif
+	}
+	// w of the result is 0
+	inline FVec4A cross( const FVec4A& vec1, const FVec4A& vec2 )
+	{
+#if defined( HP_SIMD_SSE )
+		const __m128 a = _mm_shuffle_ps( vec1.v, vec1.v, HP_SHUFFLE( 1, 2, 0, 3 ) );
+		const __m128 b = _mm_shuffle_ps( vec2.v, vec2.v, HP_SHUFFLE( 2, 0, 1, 3 ) );
+		const __m128 c = _mm_shuffle_ps( vec1.v, vec1.v, HP_SHUFFLE( 2, 0, 1, 3 ) );
+		const __m128 d = _mm_shuffle_ps( vec2.v, vec2.v, HP_SHUFFLE( 1, 2, 0, 3 ) );
+		return FVec4A{ _mm_sub_ps( _mm_mul_ps( a, b ), _mm_mul_ps( c, d ) ) };
+#else
+		return vec4A(
+			vec1.v[1] * vec2.v[2] - vec1.v[2] * vec2.v[1],
+			vec1.v[2] * vec2.v[0] - vec1.v[0] * vec2.v[2],
+			vec1.v[0] * vec2.v[1] - vec1.v[1] * vec2.v[0] );
+#endif
+	}
+	inline float length( const FVec4A& vec )
+	{
+#if defined( HP_SIMD_SSE )
+		return _mm_cvtss_f32( _mm_sqrt_ss( dot3( vec.v, vec.v ) ) );
+#else
+		return sqrtf( dot( vec, vec ) );
+#endif
+	}
+	inline float mag( const FVec4A& vec )
+	{
+		return length( vec );
+	}
+	// zero vector stays zero
+	inline FVec4A normalize( const FVec4A& vec )
+	{
+#if defined( HP_SIMD_SSE )
+		const __m128 len = _mm_sqrt_ps( dot3( vec.v, vec.v ) );
+		const __m128 nonZero = _mm_cmpneq_ps( len, _mm_setzero_ps( ) );
+		const __m128 scale = _mm_and_ps( _mm_div_ps( _mm_set1_ps( 1.0f ), len ), nonZero );
+		return FVec4A{ _mm_mul_ps( vec.v, scale ) };
+#else
+		const float len = length( vec );
+		return len == 0.0f ? vec4A( 0.0f, 0.0f, 0.0f, 0.0f ) : vec * ( 1.0f / len );
+#endif
+	}
+	inline FVec4A clampMag( const FVec4A& vec, const float max )
+	{
+		const float magnitude = mag( vec );
+		if ( magnitude > max )
+		{
+			return vec / magnitude * max;
+		}
+		return vec;
+	}
+}
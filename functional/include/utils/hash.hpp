@@ -0,0 +1,10 @@
+#pragma once
+#include <functional>
+namespace hp_fp
+{
+	// mixes value into seed, the result depends on the order of the mixed values
+	inline size_t hashCombine( const size_t seed, const size_t value )
+	{
+		return seed ^ ( value + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 ) );
+	}
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+// Type-erased callables which never allocate on copy. InplaceFn stores its closure in a
+// fixed size buffer, closures which do not fit are a compile error. Calling an InplaceFn may
+// change its closure, so only a non-const one can be called. SharedFn is an InplaceFn
+// allocated once and shared by all its copies, for closures which capture other callables,
+// e.g. signals capturing signals.
+#ifndef HP_FN_CAPACITY
+#define HP_FN_CAPACITY 128
+#endif
+namespace hp_fp
+{
+	// value is true when an F can be called with Args and its result converts to R, constrains
+	// converting constructors to callables of the right signature
+	template<typename F, typename Sig>
+	struct IsCallable;
+	template<typename F, typename R, typename... Args>
+	struct IsCallable < F, R( Args... ) >
+	{
+	private:
+		template<typename G>
+		static typename std::is_convertible<decltype( std::declval<G&>( )(
+			std::declval<Args>( )... ) ), R>::type test( int );
+		template<typename G>
+		static std::false_type test( ... );
+	public:
+		static const bool value = decltype( test<F>( 0 ) )::value;
+	};
+	template<typename Sig, UInt32 Capacity = HP_FN_CAPACITY>
+	struct InplaceFn;
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	template<typename R, typename... Args, UInt32 Capacity>
+	struct InplaceFn < R( Args... ), Capacity >
+	{
+	private:
+		typedef typename std::aligned_storage<Capacity, sizeof( UInt64 )>::type Storage;
+		enum struct Op : UInt8
+		{
+			Copy,
+			Move,
+			Destroy
+		};
+	public:
+		InplaceFn( ) : call( nullptr ), manage( nullptr )
+		{ }
+		template<typename F, typename = typename std::enable_if<
+			!std::is_same<typename std::decay<F>::type, InplaceFn>::value>::type>
+		InplaceFn( F&& f ) : call( &invoke<typename std::decay<F>::type> ),
+			manage( &manageFn<typename std::decay<F>::type> )
+		{
+			typedef typename std::decay<F>::type Fn;
+			static_assert( sizeof( Fn ) <= Capacity,
+				"Closure does not fit into InplaceFn, raise its capacity." );
+			static_assert( std::alignment_of<Fn>::value <= std::alignment_of<Storage>::value,
+				"Closure is over-aligned for InplaceFn." );
+			new ( &storage ) Fn( std::forward<F>( f ) );
+		}
+		InplaceFn( const InplaceFn& fn ) : call( fn.call ), manage( fn.manage )
+		{
+			if ( manage )
+			{
+				manage( Op::Copy, &storage, const_cast<Storage*>( &fn.storage ) );
+			}
+		}
+		InplaceFn( InplaceFn&& fn ) : call( fn.call ), manage( fn.manage )
+		{
+			if ( manage )
+			{
+				manage( Op::Move, &storage, &fn.storage );
+			}
+		}
+		InplaceFn& operator = ( const InplaceFn& fn )
+		{
+			if ( this != &fn )
+			{
+				this->~InplaceFn( );
+				new ( this ) InplaceFn( fn );
+			}
+			return *this;
+		}
+		InplaceFn& operator = ( InplaceFn&& fn )
+		{
+			if ( this != &fn )
+			{
+				this->~InplaceFn( );
+				new ( this ) InplaceFn( std::move( fn ) );
+			}
+			return *this;
+		}
+		~InplaceFn( )
+		{
+			if ( manage )
+			{
+				manage( Op::Destroy, &storage, nullptr );
+			}
+		}
+		R operator () ( Args... args )
+		{
+			return call( &storage, std::forward<Args>( args )... );
+		}
+		explicit operator bool( ) const
+		{
+			return call != nullptr;
+		}
+	private:
+		template<typename F>
+		static R invoke( void* f, Args... args )
+		{
+			return ( *static_cast<F*>( f ) )( std::forward<Args>( args )... );
+		}
+		template<typename F>
+		static void manageFn( const Op op, void* dst, void* src )
+		{
+			switch ( op )
+			{
+			case Op::Copy:
+				new ( dst ) F( *static_cast<const F*>( src ) );
+				break;
+			case Op::Move:
+				new ( dst ) F( std::move( *static_cast<F*>( src ) ) );
+				break;
+			case Op::Destroy:
+				static_cast<F*>( dst )->~F( );
+				break;
+			}
+		}
+		R( *call )( void* f, Args... args );
+		void( *manage )( const Op op, void* dst, void* src );
+		Storage storage;
+	};
+	template<typename Sig, UInt32 Capacity = HP_FN_CAPACITY>
+	struct SharedFn;
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	template<typename R, typename... Args, UInt32 Capacity>
+	struct SharedFn < R( Args... ), Capacity >
+	{
+		template<typename F, typename = typename std::enable_if<
+			!std::is_same<typename std::decay<F>::type, SharedFn>::value>::type>
+		SharedFn( F&& f ) : fn( std::make_shared<InplaceFn<R( Args... ), Capacity>>(
+			std::forward<F>( f ) ) )
+		{ }
+		// all copies call the same closure
+		R operator () ( Args... args ) const
+		{
+			return ( *fn )( std::forward<Args>( args )... );
+		}
+		std::shared_ptr<InplaceFn<R( Args... ), Capacity>> fn;
+	};
+}
@@ -0,0 +1,182 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "threadLocal.hpp"
+// Size-class slab allocator for container nodes. Every thread keeps a free list per size
+// class, its blocks are cut from slabs which are never given back to the system. A free list
+// which grows past two slabs of blocks, e.g. from blocks freed by another thread, spills one
+// slab of them to a shared depot, and an exiting thread hands all of its free blocks over, so a
+// steady state which frees as much as it allocates makes no system allocations.
+namespace hp_fp
+{
+	const UInt32 POOL_GRANULARITY = 16;
+	const UInt32 POOL_CLASS_COUNT = 64;
+	// larger blocks go directly to the system
+	const UInt32 POOL_MAX_BLOCK = POOL_GRANULARITY * POOL_CLASS_COUNT;
+	const UInt32 POOL_SLAB_SIZE = 64 * 1024;
+	// counters of the calling thread
+	struct PoolStats
+	{
+		UInt64 allocations;
+		UInt64 deallocations;
+		// slabs and blocks larger than POOL_MAX_BLOCK
+		UInt64 systemAllocations;
+		// refills and spills, the only atomic operations of the pool
+		UInt64 depotTrips;
+	};
+	struct PoolBlock
+	{
+		PoolBlock* next;
+		// in the depot the first block of a batch links the next batch
+		PoolBlock* nextBatch;
+	};
+	static_assert( sizeof( PoolBlock ) <= POOL_GRANULARITY, "blocks are too small" );
+	// plain data, so that it can be thread local on every compiler
+	struct PoolCache
+	{
+		PoolBlock* free[POOL_CLASS_COUNT];
+		UInt32 count[POOL_CLASS_COUNT];
+		PoolStats stats;
+		// whether the free lists go back to the depot on thread exit
+		bool owned;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	inline PoolCache& poolCache_IO( )
+	{
+		static HP_THREAD_LOCAL PoolCache cache;
+		return cache;
+	}
+	inline PoolStats poolStats_IO( )
+	{
+		return poolCache_IO( ).stats;
+	}
+	inline UInt32 poolClass( const size_t size )
+	{
+		return static_cast<UInt32>( ( size - 1 ) / POOL_GRANULARITY );
+	}
+	// blocks of class c in one slab, the depot takes and gives them in batches of this size
+	inline UInt32 poolBatch( const UInt32 c )
+	{
+		return POOL_SLAB_SIZE / ( ( c + 1 ) * POOL_GRANULARITY );
+	}
+	// hands the free lists of cache over to the depot when the calling thread exits
+	void poolOwn_IO( PoolCache& cache );
+	// fills the empty free list of class c from the depot, or else from a new slab
+	void poolRefill_IO( PoolCache& cache, const UInt32 c );
+	// moves one batch of the free list of class c to the depot
+	void poolSpill_IO( PoolCache& cache, const UInt32 c );
+	// moves all free lists of cache to the depot
+	void poolRelease_IO( PoolCache& cache );
+	// free blocks of class c in the depot
+	UInt64 poolDepotBlocks_IO( const UInt32 c );
+	inline void* poolAllocate_IO( const size_t size )
+	{
+		PoolCache& cache = poolCache_IO( );
+		++cache.stats.allocations;
+		if ( size > POOL_MAX_BLOCK )
+		{
+			++cache.stats.systemAllocations;
+			return ::operator new( size );
+		}
+		const UInt32 c = poolClass( size );
+		if ( !cache.free[c] )
+		{
+			poolRefill_IO( cache, c );
+		}
+		PoolBlock* block = cache.free[c];
+		cache.free[c] = block->next;
+		--cache.count[c];
+		return block;
+	}
+	// size has to be the size the block was allocated with
+	inline void poolFree_IO( void* p, const size_t size )
+	{
+		PoolCache& cache = poolCache_IO( );
+		++cache.stats.deallocations;
+		if ( size > POOL_MAX_BLOCK )
+		{
+			::operator delete( p );
+			return;
+		}
+		const UInt32 c = poolClass( size );
+		PoolBlock* block = static_cast<PoolBlock*>( p );
+		block->next = cache.free[c];
+		cache.free[c] = block;
+		// two slabs of blocks, without the division of poolBatch
+		if ( ++cache.count[c] * ( c + 1 ) * POOL_GRANULARITY >= 2 * POOL_SLAB_SIZE )
+		{
+			poolSpill_IO( cache, c );
+		}
+		else if ( !cache.owned )
+		{
+			poolOwn_IO( cache );
+		}
+	}
+	// standard allocator on top of the pool, e.g. for std::allocate_shared
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	template<typename A>
+	struct PoolAllocator
+	{
+		typedef A value_type;
+		typedef A* pointer;
+		typedef const A* const_pointer;
+		typedef A& reference;
+		typedef const A& const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+		template<typename B>
+		struct rebind
+		{
+			typedef PoolAllocator<B> other;
+		};
+		PoolAllocator( )
+		{ }
+		template<typename B>
+		PoolAllocator( const PoolAllocator<B>& )
+		{ }
+		A* allocate( const size_t n )
+		{
+			return static_cast<A*>( poolAllocate_IO( n * sizeof( A ) ) );
+		}
+		void deallocate( A* p, const size_t n )
+		{
+			poolFree_IO( p, n * sizeof( A ) );
+		}
+		template<typename B, typename... Args>
+		void construct( B* p, Args&&... args )
+		{
+			new ( p ) B( std::forward<Args>( args )... );
+		}
+		template<typename B>
+		void destroy( B* p )
+		{
+			p->~B( );
+		}
+		size_t max_size( ) const
+		{
+			return static_cast<size_t>( -1 ) / sizeof( A );
+		}
+	};
+	template<typename A, typename B>
+	bool operator == ( const PoolAllocator<A>&, const PoolAllocator<B>& )
+	{
+		return true;
+	}
+	template<typename A, typename B>
+	bool operator != ( const PoolAllocator<A>&, const PoolAllocator<B>& )
+	{
+		return false;
+	}
+	// std::make_shared with node and control block in one pool block
+	template<typename A, typename... Args>
+	std::shared_ptr<A> makePooled( Args&&... args )
+	{
+		typedef typename std::remove_const<A>::type B;
+		return std::allocate_shared<B>( PoolAllocator<B>( ), std::forward<Args>( args )... );
+	}
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "pool.hpp"
+// Intrusive reference counted pointer to pool allocated nodes. The count lives in the node,
+// its policy decides whether copies may happen concurrently: LocalRefCount for nodes used by
+// one thread only, AtomicRefCount for nodes shared across threads.
+namespace hp_fp
+{
+	struct LocalRefCount
+	{
+		LocalRefCount( ) : count( 0 )
+		{ }
+		void increment( )
+		{
+			++count;
+		}
+		// true when the last reference is gone
+		bool decrement( )
+		{
+			return --count == 0;
+		}
+		UInt32 get( ) const
+		{
+			return count;
+		}
+		UInt32 count;
+	};
+	struct AtomicRefCount
+	{
+		AtomicRefCount( ) : count( 0 )
+		{ }
+		void increment( )
+		{
+			count.fetch_add( 1, std::memory_order_relaxed );
+		}
+		bool decrement( )
+		{
+			return count.fetch_sub( 1, std::memory_order_acq_rel ) == 1;
+		}
+		UInt32 get( ) const
+		{
+			return count.load( std::memory_order_relaxed );
+		}
+		std::atomic<UInt32> count;
+	};
+	// base of nodes owned by RefPtr, the count is mutable so that const nodes can be shared,
+	// copies of a node start without references
+	template<typename RefCount>
+	struct RefCounted
+	{
+		RefCounted( )
+		{ }
+		RefCounted( const RefCounted& )
+		{ }
+		RefCounted& operator = ( const RefCounted& )
+		{
+			return *this;
+		}
+		mutable RefCount refs;
+	};
+	template<typename A>
+	void releaseRef_IO( A* p );
+	// the node is destroyed and freed by releaseRef_IO, as A unless there is an overload for
+	// the base A of several node types
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	template<typename A>
+	struct RefPtr
+	{
+		RefPtr( ) : _p( nullptr )
+		{ }
+		RefPtr( std::nullptr_t ) : _p( nullptr )
+		{ }
+		explicit RefPtr( A* p ) : _p( p )
+		{
+			if ( _p )
+			{
+				_p->refs.increment( );
+			}
+		}
+		RefPtr( const RefPtr& r ) : _p( r._p )
+		{
+			if ( _p )
+			{
+				_p->refs.increment( );
+			}
+		}
+		RefPtr( RefPtr&& r ) : _p( r._p )
+		{
+			r._p = nullptr;
+		}
+		// from pointers to derived nodes
+		template<typename B>
+		RefPtr( const RefPtr<B>& r ) : RefPtr( static_cast<A*>( r.get( ) ) )
+		{ }
+		RefPtr& operator = ( RefPtr r )
+		{
+			std::swap( _p, r._p );
+			return *this;
+		}
+		~RefPtr( )
+		{
+			if ( _p && _p->refs.decrement( ) )
+			{
+				typedef typename std::remove_const<A>::type B;
+				releaseRef_IO( const_cast<B*>( _p ) );
+			}
+		}
+		A* get( ) const
+		{
+			return _p;
+		}
+		A* operator -> ( ) const
+		{
+			return _p;
+		}
+		A& operator * ( ) const
+		{
+			return *_p;
+		}
+		explicit operator bool( ) const
+		{
+			return _p != nullptr;
+		}
+		UInt32 useCount( ) const
+		{
+			return _p ? _p->refs.get( ) : 0;
+		}
+	private:
+		A* _p;
+	};
+	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
+
+	template<typename A>
+	void releaseRef_IO( A* p )
+	{
+		p->~A( );
+		poolFree_IO( p, sizeof( A ) );
+	}
+	// pointer to a node known to be of type A
+	template<typename A, typename B>
+	RefPtr<A> staticRefCast( const RefPtr<B>& r )
+	{
+		return RefPtr<A>( static_cast<A*>( r.get( ) ) );
+	}
+	template<typename A, typename... Args>
+	RefPtr<A> makeRef( Args&&... args )
+	{
+		typedef typename std::remove_const<A>::type B;
+		void* p = poolAllocate_IO( sizeof( B ) );
+		return RefPtr<A>( new ( p ) B( std::forward<Args>( args )... ) );
+	}
+}
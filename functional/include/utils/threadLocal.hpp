@@ -0,0 +1,8 @@
+#pragma once
+// Storage class of variables with one instance per thread. VS2013 has no thread_local, its
+// __declspec( thread ) only takes plain data without dynamic initialization.
+#if defined( _MSC_VER ) && _MSC_VER < 1900
+#define HP_THREAD_LOCAL __declspec( thread )
+#else
+#define HP_THREAD_LOCAL thread_local
+#endif
@@ -1,13 +1,37 @@
 #pragma once
+// Compile-time type identifiers without RTTI. A type gets its id by registering it with
+// HP_TYPE_ID at global scope, the id is an integral constant expression, so it works as a switch
+// label, a template argument or an index of a static table. Using an unregistered type, or an
+// id twice in one translation unit, does not compile. The same id registered in two translation
+// units is only an ODR violation which no tool reports, so register all ids of a program in one
+// header.
 namespace hp_fp
 {
-	typedef void* TypeId;
+	typedef UInt32 TypeId;
+	template<typename A>
+	struct TypeIdOf;
+	template<typename A>
+	struct TypeIdOf < const A > : TypeIdOf < A >
+	{ };
+	template<TypeId Id>
+	struct TypeOfId;
 	template<typename A>
-	// get type id without RTTI
 	TypeId typeId( )
 	{
-		static A* typeUniqueMarker = NULL;
-		return &typeUniqueMarker;
+		return TypeIdOf<A>::value;
 	}
 }
-
+#define HP_TYPE_ID( A, id ) \
+	namespace hp_fp \
+	{ \
+		template<> \
+		struct TypeIdOf < A > \
+		{ \
+			static const TypeId value = id; \
+		}; \
+		template<> \
+		struct TypeOfId < id > \
+		{ \
+			typedef A type; \
+		}; \
+	}
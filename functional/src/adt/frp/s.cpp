@@ -0,0 +1,15 @@
+#include <pch.hpp>
+#include "../../include/adt/frp/s.hpp"
+#include <atomic>
+namespace hp_fp
+{
+	namespace
+	{
+		// last tick given to any thread
+		std::atomic<UInt64> lastTick( 0 );
+	}
+	UInt64 newTick_IO( )
+	{
+		return ++lastTick;
+	}
+}
@@ -5,29 +5,22 @@ namespace hp_fp
 {
 	ActorTypeDef actorModelDef( ActorModelDef&& m )
 	{
-		ActorTypeDef def;
-		def.model = m;
-		def._typeId = typeId<ActorModelDef>( );
-		return def;
+		return ActorTypeDef( std::move( m ) );
 	}
 	ActorTypeDef actorCameraDef( ActorCameraDef&& c )
 	{
-		ActorTypeDef def;
-		def.camera = c;
-		def._typeId = typeId<ActorCameraDef>( );
-		return def;
+		return ActorTypeDef( std::move( c ) );
 	}
-	std::function<void( Renderer&, const ActorState&, const Mat4x4& )>
-		initActorRenderFunction_IO( Renderer& renderer, Resources& resources,
+	RenderFn initActorRenderFunction_IO( Renderer& renderer, Resources& resources,
 		const ActorDef& actorDef )
 	{
-		static std::function<void( Renderer&, const ActorState&, const Mat4x4& )> doNothing =
-			[]( Renderer&, const ActorState&, const Mat4x4& )
-		{ };
-		if ( actorDef.type.is<ActorModelDef>( ) )
+		return match( actorDef.type, [&renderer, &resources]( const ActorModelDef& model )
+			-> RenderFn
 		{
-			Maybe<ActorResources> res = getActorResources_IO( renderer, resources,
-				actorDef.type.model );
+			static const RenderFn doNothing =
+				[]( Renderer&, const ActorState&, const Mat4x4& )
+			{ };
+			Maybe<ActorResources> res = getActorResources_IO( renderer, resources, model );
 			return ifThenElse( res, []( ActorResources& res )
 			{
 				return renderActor_IO( res );
@@ -35,12 +28,29 @@ namespace hp_fp
 			{
 				return doNothing;
 			} );
-		}
-		else if ( actorDef.type.is<ActorCameraDef>( ) )
+		}, [&renderer]( const ActorCameraDef& camera ) -> RenderFn
 		{
-			return actorDef.type.camera.render( actorDef.type.camera, renderer.windowConfig );
-		}
-		return doNothing;
+			return camera.render( camera, renderer.windowConfig );
+		} );
+	}
+	SF<ActorInput, ActorOutput> staticActor( )
+	{
+		return SF < ActorInput, ActorOutput > {
+			[]( const S<ActorInput>& input ) -> S < ActorOutput >
+			{
+				return S < ActorOutput > {
+					[input]( const float deltaMs )
+					{
+						return ActorOutput{ input( deltaMs ).state };
+					}
+				};
+			},
+			SFKind::Identity
+		};
+	}
+	bool isStatic( const SF<ActorInput, ActorOutput>& sf )
+	{
+		return sf.kind != SFKind::Signal;
 	}
 	Mat4x4 trasformMatFromActorState( const ActorState& actorState )
 	{
@@ -51,21 +61,31 @@ namespace hp_fp
 		return rotSclPosToMat4x4( actorState.modelRot * actorState.rot,
 			actorState.scl, actorState.pos );
 	}
+	ActorState interpolate( const ActorState& previous, const ActorState& current,
+		const float alpha )
+	{
+		return ActorState{
+			lerp( previous.pos, current.pos, alpha ),
+			lerp( previous.vel, current.vel, alpha ),
+			lerp( previous.scl, current.scl, alpha ),
+			slerp( previous.rot, current.rot, alpha ),
+			slerp( previous.modelRot, current.modelRot, alpha )
+		};
+	}
 	namespace
 	{
-		// Have to specify lambda's return type to std::function because of the issue
+		// Have to specify lambda's return type to RenderFn because of the issue
 		// with return type deduction (http://stackoverflow.com/questions/12639578/c11-lambda-returning-lambda)
-		std::function<void( Renderer&, const ActorState&, const Mat4x4& )>  renderActor_IO(
-			ActorResources& res )
+		RenderFn renderActor_IO( ActorResources& res )
 		{
 			return [res]( Renderer& renderer, const ActorState& actorState,
 				const Mat4x4& transform ) mutable
 			{
 				const Camera& cam = getCamera( renderer.cameraBuffer );
 				setProjection_IO( res.material, cam.projection );
-				setView_IO( res.material, inverse( cam.transform ) );
-				setWorld_IO( res.material,
-					modelTrasformMatFromActorState( actorState ) * transform );
+				setView_IO( res.material, affineInverse( cam.transform ) );
+				setWorld_IO( res.material, rotSclPosToMat4x4( actorState.modelRot * actorState.rot,
+					actorState.scl, actorState.pos, transform ) );
 				setCameraPosition_IO( res.material, pos( cam.transform ) );
 				setAbientLightColor_IO( res.material, Color( 0.1f, 0.1f, 0.1f, 0.6f ) );
 				setDiffuseLightColor_IO( res.material, Color( 1.0f, 0.95f, 0.4f, 0.4f ) );
@@ -1,5 +1,7 @@
 #include <pch.hpp>
 #include "../../include/core/engine.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include "../../include/adt/maybe.hpp"
 #include "../../include/core/resources.hpp"
@@ -14,26 +16,51 @@ namespace hp_fp
 		return Engine{ std::move( name ), EngineState::Initialized, { } };
 	}
 	void run_IO( Engine& engine, std::vector<ActorDef>&& actorDefs,
-		const WindowConfig& windowConfig )
+		const WindowConfig& windowConfig, const float simulationStepMs )
 	{
 		Maybe<Window> window = open_IO( engine, windowConfig );
-		ifThenElse( window, [&engine, &windowConfig, &actorDefs]( Window& window )
+		ifThenElse( window, [&engine, &windowConfig, &actorDefs, simulationStepMs](
+			Window& window )
 		{
 			Maybe<Renderer> renderer = init_IO( window.handle, windowConfig );
-			ifThenElse( renderer, [&engine, &window, &actorDefs]( Renderer& renderer )
+			ifThenElse( renderer, [&engine, &window, &actorDefs, simulationStepMs](
+				Renderer& renderer )
 			{
 				engine.state = EngineState::Running;
 				Resources resources;
 				Timer timer = initTimer_IO( );
-				std::vector<Actor> actors = initActors_IO( renderer, resources,
-					std::move( actorDefs ) );
+				Actors actors = initActors_IO( renderer, resources,
+					engine.gameInput, std::move( actorDefs ) );
+				ActorBatches batches;
+				addBatches_IO( batches, actors );
+				// simulation time not yet stepped, less than one step after the steps of a frame
+				double accumulatorMs = 0.0;
 				while ( engine.state == EngineState::Running )
 				{
 					processMessages_IO( window.handle );
 					updateTimer_IO( timer );
+					float alpha = 1.0f;
+					if ( simulationStepMs > 0.0f )
+					{
+						accumulatorMs = std::min( accumulatorMs + timer.deltaMs,
+							static_cast<double>( MAX_SIMULATION_STEPS * simulationStepMs ) );
+						while ( accumulatorMs >= simulationStepMs )
+						{
+							stepActors_IO( actors, engine.gameInput, simulationStepMs );
+							sampleBatches_IO( batches, engine.gameInput, simulationStepMs );
+							accumulatorMs -= simulationStepMs;
+						}
+						alpha = static_cast<float>( accumulatorMs / simulationStepMs );
+					}
+					else
+					{
+						stepActors_IO( actors, engine.gameInput,
+							static_cast<float>( timer.deltaMs ) );
+						sampleBatches_IO( batches, engine.gameInput,
+							static_cast<float>( timer.deltaMs ) );
+					}
 					preRender_IO( renderer );
-					renderActors_IO( renderer, actors, engine.gameInput,
-						static_cast<float>( timer.deltaMs ) );
+					renderActors_IO( renderer, actors, alpha );
 					present_IO( renderer );
 				}
 			}, []
@@ -47,29 +74,162 @@ namespace hp_fp
 	}
 	namespace
 	{
-		void renderActors_IO( Renderer& renderer, std::vector<Actor>& actors,
-			const GameInput& gameInput, const float deltaMs,
+		void stepActors_IO( Actors& actors, const GameInput& gameInput, const float deltaMs )
+		{
+			for ( auto& actor : actors.dynamic )
+			{
+				if ( !actor.batch )
+				{
+					ActorInput actorInput{
+						gameInput,
+						actor.state
+					};
+					auto actorOutput = sample_IO( actor.sf, actorInput, deltaMs );
+					actor.previousState = actor.state;
+					actor.state = actorOutput.state;
+				}
+			}
+			for ( auto& actor : actors.dynamic )
+			{
+				stepActors_IO( actor.children, gameInput, deltaMs );
+			}
+			// only for their children
+			for ( auto& actor : actors.statics )
+			{
+				stepActors_IO( actor.children, gameInput, deltaMs );
+			}
+		}
+		void renderActors_IO( Renderer& renderer, Actors& actors, const float alpha,
 			const Mat4x4& parentLocalTransform )
 		{
-			for ( auto& actor : actors )
+			// all actors of a level before their children
+			for ( auto& actor : actors.statics )
 			{
-				ActorInput actorInput{
-					gameInput,
-					actor.state
-				};
-				// render previous states first then run SF to be in sync with cam
 				actor.render_IO( renderer, actor.state, parentLocalTransform );
-				auto actorOutput = actor.sf < actorInput < deltaMs;
-				actor.state = actorOutput.state;
-				renderActors_IO( renderer, actor.children, gameInput, deltaMs,
-					trasformMatFromActorState( actor.state ) );
 			}
+			for ( auto& actor : actors.dynamic )
+			{
+				actor.render_IO( renderer, renderedState( actor, alpha ), parentLocalTransform );
+			}
+			for ( auto& actor : actors.statics )
+			{
+				renderActors_IO( renderer, actor.children, alpha, actor.transform );
+			}
+			for ( auto& actor : actors.dynamic )
+			{
+				renderActors_IO( renderer, actor.children, alpha,
+					trasformMatFromActorState( renderedState( actor, alpha ) ) );
+			}
+		}
+		ActorState renderedState( const Actor& actor, const float alpha )
+		{
+			return alpha >= 1.0f ? actor.state
+				: interpolate( actor.previousState, actor.state, alpha );
+		}
+		void sampleBatches_IO( ActorBatches& batches, const GameInput& gameInput,
+			const float deltaMs )
+		{
+			for ( auto& tapeBatch : batches )
+			{
+				ActorBatch& batch = tapeBatch.second;
+				sample_IO( *tapeBatch.first, BatchSource( [&batch, &gameInput](
+					const UInt32 offset, const UInt32 size )
+				{
+					return batchView( batch, gameInput, offset, size );
+				} ), batch.outputs.data( ), static_cast<UInt32>( batch.actors.size( ) ), deltaMs );
+				for ( UInt32 i = 0; i < batch.actors.size( ); ++i )
+				{
+					const ActorState& state = batch.outputs[i].state;
+					batch.actors[i]->previousState = batch.actors[i]->state;
+					batch.actors[i]->state = state;
+					batch.pos[i] = state.pos;
+					batch.vel[i] = state.vel;
+					batch.scl[i] = state.scl;
+					batch.rot[i] = state.rot;
+					batch.modelRot[i] = state.modelRot;
+				}
+			}
+		}
+		template<typename A>
+		BatchView arrayView( const std::vector<A>& a )
+		{
+			return BatchView{ reinterpret_cast<const UInt8*>( a.data( ) ), sizeof( A ) };
+		}
+		BatchView batchView( ActorBatch& batch, const GameInput& gameInput, const UInt32 offset,
+			const UInt32 size )
+		{
+			const UInt32 gameInputOffset = offsetof( ActorInput, gameInput );
+			const UInt32 stateOffset = offsetof( ActorInput, state );
+			// the same for all actors
+			if ( offset >= gameInputOffset && offset + size <= gameInputOffset + sizeof( GameInput ) )
+			{
+				return BatchView{ reinterpret_cast<const UInt8*>( &gameInput ) + offset -
+					gameInputOffset, 0 };
+			}
+			if ( offset == stateOffset + offsetof( ActorState, pos ) && size == sizeof( FVec3 ) )
+			{
+				return arrayView( batch.pos );
+			}
+			if ( offset == stateOffset + offsetof( ActorState, vel ) && size == sizeof( FVec3 ) )
+			{
+				return arrayView( batch.vel );
+			}
+			if ( offset == stateOffset + offsetof( ActorState, scl ) && size == sizeof( FVec3 ) )
+			{
+				return arrayView( batch.scl );
+			}
+			if ( offset == stateOffset + offsetof( ActorState, rot ) && size == sizeof( FQuat ) )
+			{
+				return arrayView( batch.rot );
+			}
+			if ( offset == stateOffset + offsetof( ActorState, modelRot ) && size == sizeof( FQuat ) )
+			{
+				return arrayView( batch.modelRot );
+			}
+			if ( offset == stateOffset && size == sizeof( ActorState ) )
+			{
+				batch.states.resize( batch.actors.size( ) );
+				for ( UInt32 i = 0; i < batch.actors.size( ); ++i )
+				{
+					batch.states[i] = batch.actors[i]->state;
+				}
+				return arrayView( batch.states );
+			}
+			// the whole input or parts of fields, each actor gets a copy of the game input
+			batch.inputs.resize( batch.actors.size( ) );
+			for ( UInt32 i = 0; i < batch.actors.size( ); ++i )
+			{
+				fused::storeLane( &batch.inputs[i], ActorInput{ gameInput, batch.actors[i]->state } );
+			}
+			return BatchView{ reinterpret_cast<const UInt8*>( batch.inputs.data( ) ) + offset,
+				sizeof( ActorInput ) };
 		}
-		std::vector<Actor> initActors_IO( Renderer& renderer, Resources& resources,
-			std::vector<ActorDef>&& actorsDef )
+		void addBatches_IO( ActorBatches& batches, Actors& actors )
 		{
-			std::vector<Actor> actors{ };
-			actors.reserve( actorsDef.size( ) );
+			for ( auto& actor : actors.dynamic )
+			{
+				if ( actor.batch )
+				{
+					ActorBatch& batch = batches[actor.batch.get( )];
+					batch.actors.push_back( &actor );
+					batch.pos.push_back( actor.state.pos );
+					batch.vel.push_back( actor.state.vel );
+					batch.scl.push_back( actor.state.scl );
+					batch.rot.push_back( actor.state.rot );
+					batch.modelRot.push_back( actor.state.modelRot );
+					batch.outputs.push_back( ActorOutput{ actor.state } );
+				}
+				addBatches_IO( batches, actor.children );
+			}
+			for ( auto& actor : actors.statics )
+			{
+				addBatches_IO( batches, actor.children );
+			}
+		}
+		Actors initActors_IO( Renderer& renderer, Resources& resources,
+			const GameInput& gameInput, std::vector<ActorDef>&& actorsDef )
+		{
+			Actors actors{ };
 			for ( auto& actorDef : actorsDef )
 			{
 				ActorState startingState{
@@ -79,9 +239,28 @@ namespace hp_fp
 					actorDef.startingState.rot,
 					actorDef.startingState.modelRot
 				};
-				actors.push_back( Actor{ startingState, actorDef.sf,
-					initActorRenderFunction_IO( renderer, resources, actorDef ),
-					initActors_IO( renderer, resources, std::move( actorDef.children ) ) } );
+				if ( isStatic( actorDef.sf ) )
+				{
+					ActorState state = startingState;
+					if ( actorDef.sf.kind == SFKind::Constant )
+					{
+						// sampled once, its output is the state for good
+						auto sf = instantiate( actorDef.sf );
+						state = sample_IO( sf, ActorInput{ gameInput, startingState }, 0.0f ).state;
+					}
+					actors.statics.push_back( StaticActor{ state,
+						initActorRenderFunction_IO( renderer, resources, actorDef ),
+						initActors_IO( renderer, resources, gameInput,
+						std::move( actorDef.children ) ), trasformMatFromActorState( state ) } );
+				}
+				else
+				{
+					actors.dynamic.push_back( Actor{ startingState, startingState,
+						instantiate( actorDef.sf ),
+						initActorRenderFunction_IO( renderer, resources, actorDef ),
+						initActors_IO( renderer, resources, gameInput,
+						std::move( actorDef.children ) ), actorDef.batch } );
+				}
 			}
 			return actors;
 		}
@@ -6,60 +6,64 @@ namespace hp_fp
 	Maybe<Model>& getModel_IO( Renderer& renderer, Resources& resources,
 		const LoadedModelDef& modelDef )
 	{
-		if ( resources.loadedModels.count( modelDef ) == 0 )
+		const auto model = resources.loadedModels.find( modelDef );
+		if ( model )
 		{
-			resources.loadedModels.emplace( modelDef, loadModelFromFile_IO( renderer,
-				modelDef.filename, modelDef.scale ) );
+			return **model;
 		}
-		return resources.loadedModels.at( modelDef );
+		auto loaded = std::make_shared<Maybe<Model>>( loadModelFromFile_IO( renderer,
+			modelDef.filename, modelDef.scale ) );
+		resources.loadedModels = resources.loadedModels.insert( modelDef, loaded );
+		return *loaded;
 	}
 	Maybe<Model>& getModel_IO( Renderer& renderer, Resources& resources,
 		const BuiltInModelDef& modelDef )
 	{
-		if ( resources.builtInModels.count( modelDef ) == 0 )
+		const auto model = resources.builtInModels.find( modelDef );
+		if ( model )
 		{
-			switch ( modelDef.type )
-			{
-			case BuiltInModelType::Cube:
-			{
-				resources.builtInModels.emplace( modelDef,
-					cubeMesh_IO( renderer, modelDef.dimensions ) );
-			}
-			break;
-			default:
-				WAR( "Missing built-In model for type " +
-					std::to_string( static_cast<UInt8>( modelDef.type ) ) + "." );
-			}
+			return **model;
+		}
+		std::shared_ptr<Maybe<Model>> built;
+		switch ( modelDef.type )
+		{
+		case BuiltInModelType::Cube:
+		{
+			built = std::make_shared<Maybe<Model>>( cubeMesh_IO( renderer, modelDef.dimensions ) );
+		}
+		break;
+		default:
+			WAR( "Missing built-In model for type " +
+				std::to_string( static_cast<UInt8>( modelDef.type ) ) + "." );
+			built = std::make_shared<Maybe<Model>>( nothing<Model>( ) );
 		}
-		return resources.builtInModels.at( modelDef );
+		resources.builtInModels = resources.builtInModels.insert( modelDef, built );
+		return *built;
 	}
 	Maybe<Material>& getMaterial_IO( Renderer& renderer, Resources& resources,
 		const MaterialDef& materialDef )
 	{
-		if ( resources.materials.count( materialDef ) == 0 )
+		const auto material = resources.materials.find( materialDef );
+		if ( material )
 		{
-			resources.materials.emplace( materialDef, loadMaterial_IO( renderer, materialDef ) );
+			return **material;
 		}
-		return resources.materials.at( materialDef );
+		auto loaded = std::make_shared<Maybe<Material>>( loadMaterial_IO( renderer, materialDef ) );
+		resources.materials = resources.materials.insert( materialDef, loaded );
+		return *loaded;
 	}
 	Maybe<ActorResources> getActorResources_IO( Renderer& renderer, Resources& resources,
 		const ActorModelDef& actorModelDef )
 	{
-		if ( actorModelDef.model.is<LoadedModelDef>( ) )
+		return match( actorModelDef.model, [&]( const BuiltInModelDef& model )
 		{
-			Maybe<Model>& model = getModel_IO( renderer, resources,
-				actorModelDef.model.loaded );
-			return getMaterialForModel_IO( renderer, resources, model,
-				actorModelDef.material );
-		}
-		else if ( actorModelDef.model.is<BuiltInModelDef>( ) )
+			return getMaterialForModel_IO( renderer, resources,
+				getModel_IO( renderer, resources, model ), actorModelDef.material );
+		}, [&]( const LoadedModelDef& model )
 		{
-			Maybe<Model>& model = getModel_IO( renderer, resources,
-				actorModelDef.model.builtIn );
-			return getMaterialForModel_IO( renderer, resources, model,
-				actorModelDef.material );
-		}
-		return nothing<ActorResources>( );
+			return getMaterialForModel_IO( renderer, resources,
+				getModel_IO( renderer, resources, model ), actorModelDef.material );
+		} );
 	}
 	namespace
 	{
@@ -8,17 +8,11 @@ namespace hp_fp
 {
 	ModelDef builtInModelDef( BuiltInModelDef&& m )
 	{
-		ModelDef model;
-		model.builtIn = m;
-		model._typeId = typeId<BuiltInModelDef>( );
-		return model;
+		return ModelDef( std::move( m ) );
 	}
 	ModelDef loadedModelDef( LoadedModelDef&& m )
 	{
-		ModelDef model;
-		model.loaded = m;
-		model._typeId = typeId<LoadedModelDef>( );
-		return model;
+		return ModelDef( std::move( m ) );
 	}
 	void addVertex_IO( Mesh& mesh, const Vertex vertex )
 	{
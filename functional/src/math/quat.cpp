@@ -1,7 +1,107 @@
 #include <pch.hpp>
 #include "../../include/math/quat.hpp"
+#include "../../include/math/simd.hpp"
+#include <algorithm>
 namespace hp_fp
 {
 	const FQuat FQuat::identity( FQuat( 0.0f, 0.0f, 0.0f, 1.0f ) );
+	namespace
+	{
+		// eulerRadToQuat_IO evaluates the half angles of this many inputs in one sinCos_IO call
+		const UInt32 EULER_BLOCK = 64;
+#if defined( HP_SIMD_SSE )
+		static_assert( sizeof( FVec3 ) == 3 * sizeof( float ), "FVec3 has to be packed" );
+		static_assert( sizeof( FQuat ) == 4 * sizeof( float ), "FQuat has to be packed" );
+		// the same expressions as rotate on four vectors, one component per register
+		void rotate4_IO( const FVec3* vecs, const FQuat* quats, FVec3* rotated )
+		{
+			const float* v = &vecs[0].x;
+			const __m128 v0 = _mm_loadu_ps( v );
+			const __m128 v1 = _mm_loadu_ps( v + 4 );
+			const __m128 v2 = _mm_loadu_ps( v + 8 );
+			// x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3 into x0 x1 x2 x3, y0 y1 y2 y3, z0 z1 z2 z3
+			const __m128 x2233 = _mm_shuffle_ps( v1, v2, HP_SHUFFLE( 2, 2, 1, 1 ) );
+			const __m128 y0011 = _mm_shuffle_ps( v0, v1, HP_SHUFFLE( 1, 1, 0, 0 ) );
+			const __m128 y2233 = _mm_shuffle_ps( v1, v2, HP_SHUFFLE( 3, 3, 2, 2 ) );
+			const __m128 z0011 = _mm_shuffle_ps( v0, v1, HP_SHUFFLE( 2, 2, 1, 1 ) );
+			const __m128 z2233 = _mm_shuffle_ps( v2, v2, HP_SHUFFLE( 0, 0, 3, 3 ) );
+			const __m128 vx = _mm_shuffle_ps( v0, x2233, HP_SHUFFLE( 0, 3, 0, 2 ) );
+			const __m128 vy = _mm_shuffle_ps( y0011, y2233, HP_SHUFFLE( 0, 2, 0, 2 ) );
+			const __m128 vz = _mm_shuffle_ps( z0011, z2233, HP_SHUFFLE( 0, 2, 0, 2 ) );
+			__m128 ux = _mm_loadu_ps( &quats[0].x );
+			__m128 uy = _mm_loadu_ps( &quats[1].x );
+			__m128 uz = _mm_loadu_ps( &quats[2].x );
+			__m128 w = _mm_loadu_ps( &quats[3].x );
+			_MM_TRANSPOSE4_PS( ux, uy, uz, w );
+			const __m128 two = _mm_set1_ps( 2.0f );
+			const __m128 tx = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( uy, vz ), _mm_mul_ps( uz, vy ) ),
+				two );
+			const __m128 ty = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( uz, vx ), _mm_mul_ps( ux, vz ) ),
+				two );
+			const __m128 tz = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( ux, vy ), _mm_mul_ps( uy, vx ) ),
+				two );
+			const __m128 rx = _mm_add_ps( _mm_add_ps( vx, _mm_mul_ps( tx, w ) ),
+				_mm_sub_ps( _mm_mul_ps( uy, tz ), _mm_mul_ps( uz, ty ) ) );
+			const __m128 ry = _mm_add_ps( _mm_add_ps( vy, _mm_mul_ps( ty, w ) ),
+				_mm_sub_ps( _mm_mul_ps( uz, tx ), _mm_mul_ps( ux, tz ) ) );
+			const __m128 rz = _mm_add_ps( _mm_add_ps( vz, _mm_mul_ps( tz, w ) ),
+				_mm_sub_ps( _mm_mul_ps( ux, ty ), _mm_mul_ps( uy, tx ) ) );
+			// and back
+			const __m128 x0y0 = _mm_shuffle_ps( rx, ry, HP_SHUFFLE( 0, 0, 0, 0 ) );
+			const __m128 z0x1 = _mm_shuffle_ps( rz, rx, HP_SHUFFLE( 0, 0, 1, 1 ) );
+			const __m128 y1z1 = _mm_shuffle_ps( ry, rz, HP_SHUFFLE( 1, 1, 1, 1 ) );
+			const __m128 x2y2 = _mm_shuffle_ps( rx, ry, HP_SHUFFLE( 2, 2, 2, 2 ) );
+			const __m128 z2x3 = _mm_shuffle_ps( rz, rx, HP_SHUFFLE( 2, 2, 3, 3 ) );
+			const __m128 y3z3 = _mm_shuffle_ps( ry, rz, HP_SHUFFLE( 3, 3, 3, 3 ) );
+			float* r = &rotated[0].x;
+			_mm_storeu_ps( r, _mm_shuffle_ps( x0y0, z0x1, HP_SHUFFLE( 0, 2, 0, 2 ) ) );
+			_mm_storeu_ps( r + 4, _mm_shuffle_ps( y1z1, x2y2, HP_SHUFFLE( 0, 2, 0, 2 ) ) );
+			_mm_storeu_ps( r + 8, _mm_shuffle_ps( z2x3, y3z3, HP_SHUFFLE( 0, 2, 0, 2 ) ) );
+		}
+#endif
+	}
+	void eulerRadToQuat_IO( const FVec3* euler, const UInt32 count, FQuat* quats,
+		const TrigAccuracy accuracy )
+	{
+		// half angles of a block as x..., y..., z...
+		float halves[3 * EULER_BLOCK];
+		float sines[3 * EULER_BLOCK];
+		float cosines[3 * EULER_BLOCK];
+		for ( UInt32 first = 0; first < count; first += EULER_BLOCK )
+		{
+			const UInt32 n = std::min( EULER_BLOCK, count - first );
+			for ( UInt32 i = 0; i < n; ++i )
+			{
+				halves[i] = euler[first + i].x / 2.0f;
+				halves[n + i] = euler[first + i].y / 2.0f;
+				halves[2 * n + i] = euler[first + i].z / 2.0f;
+			}
+			sinCos_IO( halves, 3 * n, sines, cosines, accuracy );
+			for ( UInt32 i = 0; i < n; ++i )
+			{
+				const float sinX = sines[i], cosX = cosines[i];
+				const float sinY = sines[n + i], cosY = cosines[n + i];
+				const float sinZ = sines[2 * n + i], cosZ = cosines[2 * n + i];
+				quats[first + i] = FQuat(
+					sinY * cosX * sinZ + cosY * sinX * cosZ,
+					sinY * cosX * cosZ - cosY * sinX * sinZ,
+					cosY * cosX * sinZ - sinY * sinX * cosZ,
+					cosY * cosX * cosZ + sinY * sinX * sinZ );
+			}
+		}
+	}
+	void rotate_IO( const FVec3* vecs, const FQuat* quats, const UInt32 count, FVec3* rotated )
+	{
+		UInt32 i = 0;
+#if defined( HP_SIMD_SSE )
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			rotate4_IO( vecs + i, quats + i, rotated + i );
+		}
+#endif
+		for ( ; i < count; ++i )
+		{
+			rotated[i] = rotate( vecs[i], quats[i] );
+		}
+	}
 }
-
@@ -0,0 +1,149 @@
+#include <pch.hpp>
+#include "../../include/math/transformBatch.hpp"
+#include <cassert>
+namespace hp_fp
+{
+	namespace
+	{
+		void worldTransform_IO( const TransformBatch& batch, const UInt32 i, Mat4x4* world )
+		{
+			const UInt32 parent = batch.parents[i];
+			world[i] = rotSclPosToMat4x4(
+				FQuat( batch.rotX[i], batch.rotY[i], batch.rotZ[i], batch.rotW[i] ),
+				FVec3{ batch.sclX[i], batch.sclY[i], batch.sclZ[i] },
+				FVec3{ batch.posX[i], batch.posY[i], batch.posZ[i] },
+				parent == NO_PARENT ? Mat4x4::identity : world[parent] );
+		}
+#if defined( HP_SIMD_SSE )
+		// the same expressions as rotSclPosToMat4x4, so both give equal results
+		void worldTransforms4_IO( const TransformBatch& batch, const UInt32 i, Mat4x4* world )
+		{
+			// parent rows transposed, lane k of p[r][c] is element c of row r of parent k
+			__m128 p[4][4];
+			const float* parents[4];
+			for ( UInt32 k = 0; k < 4; ++k )
+			{
+				const UInt32 parent = batch.parents[i + k];
+				parents[k] = parent == NO_PARENT ? Mat4x4::identity.m[0] : world[parent].m[0];
+			}
+			for ( UInt32 r = 0; r < 4; ++r )
+			{
+				p[r][0] = _mm_loadu_ps( parents[0] + 4 * r );
+				p[r][1] = _mm_loadu_ps( parents[1] + 4 * r );
+				p[r][2] = _mm_loadu_ps( parents[2] + 4 * r );
+				p[r][3] = _mm_loadu_ps( parents[3] + 4 * r );
+				_MM_TRANSPOSE4_PS( p[r][0], p[r][1], p[r][2], p[r][3] );
+			}
+			const __m128 one = _mm_set1_ps( 1.0f );
+			const __m128 two = _mm_set1_ps( 2.0f );
+			const __m128 x = _mm_loadu_ps( &batch.rotX[i] );
+			const __m128 y = _mm_loadu_ps( &batch.rotY[i] );
+			const __m128 z = _mm_loadu_ps( &batch.rotZ[i] );
+			const __m128 w = _mm_loadu_ps( &batch.rotW[i] );
+			const __m128 xx = _mm_mul_ps( x, x );
+			const __m128 yy = _mm_mul_ps( y, y );
+			const __m128 zz = _mm_mul_ps( z, z );
+			const __m128 xy = _mm_mul_ps( x, y );
+			const __m128 xz = _mm_mul_ps( x, z );
+			const __m128 yz = _mm_mul_ps( y, z );
+			const __m128 xw = _mm_mul_ps( x, w );
+			const __m128 yw = _mm_mul_ps( y, w );
+			const __m128 zw = _mm_mul_ps( z, w );
+			__m128 l[4][3];
+			l[0][0] = _mm_mul_ps( _mm_sub_ps( one, _mm_mul_ps( two, _mm_add_ps( yy, zz ) ) ),
+				_mm_loadu_ps( &batch.sclX[i] ) );
+			l[0][1] = _mm_mul_ps( two, _mm_add_ps( xy, zw ) );
+			l[0][2] = _mm_mul_ps( two, _mm_sub_ps( xz, yw ) );
+			l[1][0] = _mm_mul_ps( two, _mm_sub_ps( xy, zw ) );
+			l[1][1] = _mm_mul_ps( _mm_sub_ps( one, _mm_mul_ps( two, _mm_add_ps( xx, zz ) ) ),
+				_mm_loadu_ps( &batch.sclY[i] ) );
+			l[1][2] = _mm_mul_ps( two, _mm_add_ps( yz, xw ) );
+			l[2][0] = _mm_mul_ps( two, _mm_add_ps( xz, yw ) );
+			l[2][1] = _mm_mul_ps( two, _mm_sub_ps( yz, xw ) );
+			l[2][2] = _mm_mul_ps( _mm_sub_ps( one, _mm_mul_ps( two, _mm_add_ps( xx, yy ) ) ),
+				_mm_loadu_ps( &batch.sclZ[i] ) );
+			l[3][0] = _mm_loadu_ps( &batch.posX[i] );
+			l[3][1] = _mm_loadu_ps( &batch.posY[i] );
+			l[3][2] = _mm_loadu_ps( &batch.posZ[i] );
+			for ( UInt32 r = 0; r < 4; ++r )
+			{
+				__m128 row[4];
+				for ( UInt32 c = 0; c < 4; ++c )
+				{
+					row[c] = _mm_add_ps( _mm_add_ps( _mm_mul_ps( l[r][0], p[0][c] ),
+						_mm_mul_ps( l[r][1], p[1][c] ) ), _mm_mul_ps( l[r][2], p[2][c] ) );
+					if ( r == 3 )
+					{
+						row[c] = _mm_add_ps( row[c], p[3][c] );
+					}
+				}
+				_MM_TRANSPOSE4_PS( row[0], row[1], row[2], row[3] );
+				_mm_storeu_ps( world[i].m[r], row[0] );
+				_mm_storeu_ps( world[i + 1].m[r], row[1] );
+				_mm_storeu_ps( world[i + 2].m[r], row[2] );
+				_mm_storeu_ps( world[i + 3].m[r], row[3] );
+			}
+		}
+#endif
+	}
+	UInt32 push_IO( TransformBatch& batch, const FVec3& pos, const FQuat& rot, const FVec3& scl,
+		const UInt32 parent )
+	{
+		assert( parent == NO_PARENT || parent < size( batch ) );
+		batch.posX.push_back( pos.x );
+		batch.posY.push_back( pos.y );
+		batch.posZ.push_back( pos.z );
+		batch.rotX.push_back( rot.x );
+		batch.rotY.push_back( rot.y );
+		batch.rotZ.push_back( rot.z );
+		batch.rotW.push_back( rot.w );
+		batch.sclX.push_back( scl.x );
+		batch.sclY.push_back( scl.y );
+		batch.sclZ.push_back( scl.z );
+		batch.parents.push_back( parent );
+		return size( batch ) - 1;
+	}
+	// groups of four whose parents are all outside the group go through the SSE kernel,
+	// siblings stored next to each other always do
+	void worldTransforms_IO( const TransformBatch& batch, Mat4x4* world )
+	{
+		const UInt32 count = size( batch );
+		UInt32 i = 0;
+#if defined( HP_SIMD_SSE )
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			bool independent = true;
+			for ( UInt32 k = 0; k < 4; ++k )
+			{
+				const UInt32 parent = batch.parents[i + k];
+				independent = independent && ( parent == NO_PARENT || parent < i );
+			}
+			if ( independent )
+			{
+				worldTransforms4_IO( batch, i, world );
+				continue;
+			}
+			for ( UInt32 k = 0; k < 4; ++k )
+			{
+				worldTransform_IO( batch, i + k, world );
+			}
+		}
+#endif
+		for ( ; i < count; ++i )
+		{
+			worldTransform_IO( batch, i, world );
+		}
+	}
+	void worldTransformsScalar_IO( const TransformBatch& batch, Mat4x4* world )
+	{
+		for ( UInt32 i = 0; i < size( batch ); ++i )
+		{
+			const UInt32 parent = batch.parents[i];
+			world[i] = rotSclPosToMat4x4Scalar(
+				FQuat( batch.rotX[i], batch.rotY[i], batch.rotZ[i], batch.rotW[i] ),
+				FVec3{ batch.sclX[i], batch.sclY[i], batch.sclZ[i] },
+				FVec3{ batch.posX[i], batch.posY[i], batch.posZ[i] },
+				parent == NO_PARENT ? Mat4x4::identity : world[parent] );
+		}
+	}
+}
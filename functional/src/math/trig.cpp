@@ -0,0 +1,115 @@
+#include <pch.hpp>
+#include "../../include/math/trig.hpp"
+#include "../../include/math/simd.hpp"
+namespace hp_fp
+{
+	namespace
+	{
+		// the angle is reduced to r in [-pi/4, pi/4] by subtracting a multiple j of pi/4 in
+		// three steps, the polynomials approximate sin( r ) and cos( r )
+		const float FOUR_OVER_PI = 1.27323954473516f;
+		const float PI_4_A = 0.78515625f;
+		const float PI_4_B = 2.4187564849853515625e-4f;
+		const float PI_4_C = 3.77489497744594108e-8f;
+		// minimax on [-pi/4, pi/4]
+		const float SIN_FAST[] = { 8.152966e-3f, -1.6662833e-1f };
+		const float COS_FAST[] = { 4.0908278e-2f };
+		// cephes sinf and cosf
+		const float SIN_PRECISE[] = { -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f };
+		const float COS_PRECISE[] = { 2.443315711809948e-5f, -1.388731625493765e-3f,
+			4.166664568298827e-2f };
+		void sinCosPoly( const float rad, const TrigAccuracy accuracy, float& s, float& c )
+		{
+			const float a = fabsf( rad );
+			const Int32 j = ( static_cast<Int32>( a * FOUR_OVER_PI ) + 1 ) & ~1;
+			const float y = static_cast<float>( j );
+			const float r = ( ( a - y * PI_4_A ) - y * PI_4_B ) - y * PI_4_C;
+			const float z = r * r;
+			float sinR, cosR;
+			if ( accuracy == TrigAccuracy::Fast )
+			{
+				sinR = ( SIN_FAST[0] * z + SIN_FAST[1] ) * z * r + r;
+				cosR = COS_FAST[0] * z * z - 0.5f * z + 1.0f;
+			}
+			else
+			{
+				sinR = ( ( SIN_PRECISE[0] * z + SIN_PRECISE[1] ) * z + SIN_PRECISE[2] ) * z * r + r;
+				cosR = ( ( COS_PRECISE[0] * z + COS_PRECISE[1] ) * z + COS_PRECISE[2] ) * z * z -
+					0.5f * z + 1.0f;
+			}
+			// j / 2 counts quarter turns
+			const bool swap = ( j & 2 ) != 0;
+			s = swap ? cosR : sinR;
+			c = swap ? sinR : cosR;
+			if ( ( ( j & 4 ) != 0 ) != ( rad < 0.0f ) )
+			{
+				s = -s;
+			}
+			if ( ( ( j + 2 ) & 4 ) != 0 )
+			{
+				c = -c;
+			}
+		}
+#if defined( HP_SIMD_SSE )
+		// the same steps as sinCosPoly on four angles, signs and the swap are bit masks
+		void sinCos4_IO( const float* rad, const TrigAccuracy accuracy, float* s, float* c )
+		{
+			const __m128 signMask = _mm_set1_ps( -0.0f );
+			const __m128 x = _mm_loadu_ps( rad );
+			const __m128 a = _mm_andnot_ps( signMask, x );
+			__m128i j = _mm_cvttps_epi32( _mm_mul_ps( a, _mm_set1_ps( FOUR_OVER_PI ) ) );
+			j = _mm_and_si128( _mm_add_epi32( j, _mm_set1_epi32( 1 ) ), _mm_set1_epi32( ~1 ) );
+			const __m128 y = _mm_cvtepi32_ps( j );
+			__m128 r = _mm_sub_ps( a, _mm_mul_ps( y, _mm_set1_ps( PI_4_A ) ) );
+			r = _mm_sub_ps( r, _mm_mul_ps( y, _mm_set1_ps( PI_4_B ) ) );
+			r = _mm_sub_ps( r, _mm_mul_ps( y, _mm_set1_ps( PI_4_C ) ) );
+			const __m128 z = _mm_mul_ps( r, r );
+			__m128 sinR, cosR;
+			if ( accuracy == TrigAccuracy::Fast )
+			{
+				sinR = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps(
+					_mm_set1_ps( SIN_FAST[0] ), z ), _mm_set1_ps( SIN_FAST[1] ) ), z ), r ), r );
+				cosR = _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( COS_FAST[0] ), z ), z );
+			}
+			else
+			{
+				sinR = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( SIN_PRECISE[0] ), z ),
+					_mm_set1_ps( SIN_PRECISE[1] ) );
+				sinR = _mm_add_ps( _mm_mul_ps( sinR, z ), _mm_set1_ps( SIN_PRECISE[2] ) );
+				sinR = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( sinR, z ), r ), r );
+				cosR = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( COS_PRECISE[0] ), z ),
+					_mm_set1_ps( COS_PRECISE[1] ) );
+				cosR = _mm_add_ps( _mm_mul_ps( cosR, z ), _mm_set1_ps( COS_PRECISE[2] ) );
+				cosR = _mm_mul_ps( _mm_mul_ps( cosR, z ), z );
+			}
+			cosR = _mm_add_ps( _mm_sub_ps( cosR, _mm_mul_ps( _mm_set1_ps( 0.5f ), z ) ),
+				_mm_set1_ps( 1.0f ) );
+			const __m128 swap = _mm_castsi128_ps( _mm_cmpeq_epi32(
+				_mm_and_si128( j, _mm_set1_epi32( 2 ) ), _mm_set1_epi32( 2 ) ) );
+			const __m128 sinSign = _mm_xor_ps( _mm_and_ps( x, signMask ), _mm_castsi128_ps(
+				_mm_slli_epi32( _mm_and_si128( j, _mm_set1_epi32( 4 ) ), 29 ) ) );
+			const __m128 cosSign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128(
+				_mm_add_epi32( j, _mm_set1_epi32( 2 ) ), _mm_set1_epi32( 4 ) ), 29 ) );
+			const __m128 sinV = _mm_or_ps( _mm_and_ps( swap, cosR ), _mm_andnot_ps( swap, sinR ) );
+			const __m128 cosV = _mm_or_ps( _mm_and_ps( swap, sinR ), _mm_andnot_ps( swap, cosR ) );
+			_mm_storeu_ps( s, _mm_xor_ps( sinV, sinSign ) );
+			_mm_storeu_ps( c, _mm_xor_ps( cosV, cosSign ) );
+		}
+#endif
+	}
+	void sinCos_IO( const float* rad, const UInt32 count, float* s, float* c,
+		const TrigAccuracy accuracy )
+	{
+		UInt32 i = 0;
+#if defined( HP_SIMD_SSE )
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			sinCos4_IO( rad + i, accuracy, s + i, c + i );
+		}
+#endif
+		for ( ; i < count; ++i )
+		{
+			sinCosPoly( rad[i], accuracy, s[i], c[i] );
+		}
+	}
+}
@@ -0,0 +1,167 @@
+#include <pch.hpp>
+#include "../../include/utils/pool.hpp"
+#include <atomic>
+#include <thread>
+namespace hp_fp
+{
+	namespace
+	{
+		// batches of free blocks per size class, shared by all threads. Plain data and a flag
+		// without destructors, so that threads can still release their caches while the
+		// process exits.
+		struct PoolDepot
+		{
+			PoolBlock* batches[POOL_CLASS_COUNT];
+			// outside of the lock, for poolDepotBlocks_IO only
+			std::atomic<UInt64> blocks[POOL_CLASS_COUNT];
+		};
+		PoolDepot depot;
+		std::atomic_flag depotLock = ATOMIC_FLAG_INIT;
+		// [const][cop-c][cop-a][mov-c][mov-a]
+		// [  +  ][  -  ][  -  ][  -  ][  -  ]
+		struct DepotLock
+		{
+			DepotLock( )
+			{
+				while ( depotLock.test_and_set( std::memory_order_acquire ) )
+				{
+					std::this_thread::yield( );
+				}
+			}
+			~DepotLock( )
+			{
+				depotLock.clear( std::memory_order_release );
+			}
+		private:
+			DepotLock( const DepotLock& ) = delete;
+			DepotLock& operator = ( const DepotLock& ) = delete;
+		};
+		// the chain from first to last with count blocks becomes one batch of the depot
+		void pushBatch_IO( const UInt32 c, PoolBlock* first, PoolBlock* last, const UInt32 count )
+		{
+			last->next = nullptr;
+			{
+				const DepotLock lock;
+				first->nextBatch = depot.batches[c];
+				depot.batches[c] = first;
+			}
+			depot.blocks[c] += count;
+		}
+		void addSlab_IO( PoolCache& cache, const UInt32 c )
+		{
+			const UInt32 blockSize = ( c + 1 ) * POOL_GRANULARITY;
+			char* slab = static_cast<char*>( ::operator new( POOL_SLAB_SIZE ) );
+			++cache.stats.systemAllocations;
+			for ( UInt32 offset = 0; offset + blockSize <= POOL_SLAB_SIZE; offset += blockSize )
+			{
+				PoolBlock* block = reinterpret_cast<PoolBlock*>( slab + offset );
+				block->next = cache.free[c];
+				cache.free[c] = block;
+				++cache.count[c];
+			}
+		}
+#if defined( _MSC_VER ) && _MSC_VER < 1900
+		// no thread_local destructors, the callback of a fiber local slot runs on thread exit
+		VOID WINAPI releaseOnExit_IO( PVOID cache )
+		{
+			if ( cache )
+			{
+				poolRelease_IO( *static_cast<PoolCache*>( cache ) );
+			}
+		}
+		const DWORD exitSlot = FlsAlloc( &releaseOnExit_IO );
+#else
+		// [const][cop-c][cop-a][mov-c][mov-a]
+		// [  +  ][  -  ][  -  ][  -  ][  -  ]
+		struct CacheOwner
+		{
+			~CacheOwner( )
+			{
+				if ( cache )
+				{
+					poolRelease_IO( *cache );
+				}
+			}
+			PoolCache* cache;
+		};
+		thread_local CacheOwner owner = { nullptr };
+#endif
+	}
+	void poolOwn_IO( PoolCache& cache )
+	{
+		cache.owned = true;
+#if defined( _MSC_VER ) && _MSC_VER < 1900
+		FlsSetValue( exitSlot, &cache );
+#else
+		owner.cache = &cache;
+#endif
+	}
+	void poolRefill_IO( PoolCache& cache, const UInt32 c )
+	{
+		if ( !cache.owned )
+		{
+			poolOwn_IO( cache );
+		}
+		++cache.stats.depotTrips;
+		PoolBlock* batch = nullptr;
+		{
+			const DepotLock lock;
+			batch = depot.batches[c];
+			if ( batch )
+			{
+				depot.batches[c] = batch->nextBatch;
+			}
+		}
+		if ( batch )
+		{
+			// batches of released caches are shorter or longer than poolBatch( c )
+			UInt32 count = 0;
+			for ( const PoolBlock* block = batch; block; block = block->next )
+			{
+				++count;
+			}
+			depot.blocks[c] -= count;
+			cache.free[c] = batch;
+			cache.count[c] = count;
+		}
+		else
+		{
+			addSlab_IO( cache, c );
+		}
+	}
+	void poolSpill_IO( PoolCache& cache, const UInt32 c )
+	{
+		const UInt32 count = poolBatch( c );
+		PoolBlock* first = cache.free[c];
+		PoolBlock* last = first;
+		for ( UInt32 i = 1; i < count; ++i )
+		{
+			last = last->next;
+		}
+		cache.free[c] = last->next;
+		cache.count[c] -= count;
+		++cache.stats.depotTrips;
+		pushBatch_IO( c, first, last, count );
+	}
+	void poolRelease_IO( PoolCache& cache )
+	{
+		for ( UInt32 c = 0; c < POOL_CLASS_COUNT; ++c )
+		{
+			if ( cache.free[c] )
+			{
+				PoolBlock* last = cache.free[c];
+				while ( last->next )
+				{
+					last = last->next;
+				}
+				pushBatch_IO( c, cache.free[c], last, cache.count[c] );
+				cache.free[c] = nullptr;
+				cache.count[c] = 0;
+			}
+		}
+	}
+	UInt64 poolDepotBlocks_IO( const UInt32 c )
+	{
+		return depot.blocks[c];
+	}
+}
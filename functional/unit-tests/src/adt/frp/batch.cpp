@@ -0,0 +1,183 @@
+#include <pch/pch.hpp>
+#include <core/actor/actor.hpp>
+#include <adt/frp/batch.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	const float rotSpeed = 0.003f;
+	const FVec3 gravity{ 0.0f, -0.00000981f, 0.0f };
+	ActorState getState( const ActorInput& input )
+	{
+		return input.state;
+	}
+	FVec3 getPos( const ActorState& state )
+	{
+		return state.pos;
+	}
+	FVec3 getVel( const ActorState& state )
+	{
+		return state.vel;
+	}
+	FQuat getRot( const ActorState& state )
+	{
+		return state.rot;
+	}
+	FVec3 fromY( const float& y )
+	{
+		return FVec3{ 0.0f, y, 0.0f };
+	}
+	ActorState withPos( const FVec3& pos, const ActorState& state )
+	{
+		auto newState = state;
+		newState.pos = pos;
+		return newState;
+	}
+	ActorState withVel( const FVec3& vel, const ActorState& state )
+	{
+		auto newState = state;
+		newState.vel = vel;
+		return newState;
+	}
+	ActorState withRot( const FQuat& rot, const ActorState& state )
+	{
+		auto newState = state;
+		newState.rot = rot;
+		return newState;
+	}
+	ActorOutput conActorOutput( const ActorState& state )
+	{
+		return ActorOutput{ state };
+	}
+	FVec3 jump( const GameInput& gameInput )
+	{
+		return FVec3{ 0.0f, gameInput[Key::Space] ? 0.01f : 0.0f, 0.0f };
+	}
+}
+
+TEST( BatchTest, FnSampleMatchesScalar )
+{
+	auto input = fused::input<ActorInput>( );
+	auto state = fused::arr( getState ) < input;
+	auto rot = fused::mul( fused::arr( getRot ) < state ) < fused::arr( eulerRadToQuat<float> )
+		< fused::arr( fromY ) < fused::integral( ) < rotSpeed;
+	auto vel = fused::sub( fused::arr( getVel ) < state ) < fused::mul( 0.5f )
+		< fused::add( gravity ) < fused::integral( ) < gravity;
+	auto pos = fused::add( fused::arr( getPos ) < state ) < fused::rotate( rot )
+		< fused::integral( ) < vel;
+	auto output = fused::arr( conActorOutput ) < fused::lift2( withRot, rot )
+		< fused::lift2( withVel, vel ) < fused::lift2( withPos, pos ) < state;
+
+	auto batch = fused::batch( input, output );
+	// more lanes than one chunk, not divisible by SIMD width
+	const UInt32 count = BATCH_CHUNK_SIZE + 37;
+	std::vector<ActorInput> inputs( count );
+	for ( UInt32 i = 0; i < count; ++i )
+	{
+		inputs[i].state.pos = FVec3{ 0.1f * i, 0.45f + 0.02f * i, -0.3f * i };
+		inputs[i].state.vel = FVec3{ 0.001f * i, -0.002f * i, 0.0005f };
+		inputs[i].state.rot = eulerRadToQuat( FVec3{ 0.0f, 0.05f * i, 0.0f } );
+	}
+	std::vector<ActorOutput> outputs( count );
+	for ( float deltaMs = 1.0f; deltaMs < 40.0f; deltaMs += 7.5f )
+	{
+		sample_IO( *batch.tape, inputs.data( ), outputs.data( ), count, deltaMs );
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			const ActorOutput expected = fused::sample_IO( input, output, inputs[i], deltaMs );
+			EXPECT_EQ( expected.state.pos, outputs[i].state.pos );
+			EXPECT_EQ( expected.state.vel, outputs[i].state.vel );
+			EXPECT_EQ( expected.state.rot.x, outputs[i].state.rot.x );
+			EXPECT_EQ( expected.state.rot.y, outputs[i].state.rot.y );
+			EXPECT_EQ( expected.state.rot.z, outputs[i].state.rot.z );
+			EXPECT_EQ( expected.state.rot.w, outputs[i].state.rot.w );
+			inputs[i].state = outputs[i].state;
+		}
+	}
+}
+
+TEST( BatchTest, FnMembersMatchScalar )
+{
+	auto input = fused::input<ActorInput>( );
+	auto state = fused::member( &ActorInput::state ) < input;
+	auto vel = fused::add( fused::member( &ActorState::vel ) < state )
+		< fused::arr( jump ) < fused::member( &ActorInput::gameInput ) < input;
+	auto pos = fused::add( fused::member( &ActorState::pos ) < state ) < fused::integral( ) < vel;
+	auto output = fused::arr( conActorOutput ) < fused::lift2( withVel, vel )
+		< fused::lift2( withPos, pos ) < state;
+
+	auto batch = fused::batch( input, output );
+	// game input once for all lanes, the fields of the state in arrays of their own
+	UInt32 shared = 0, fields = 0;
+	for ( const auto& in : batch.tape->inputs )
+	{
+		if ( in.size == sizeof( GameInput ) && batch.tape->slots[in.slot].uniform )
+		{
+			++shared;
+		}
+		if ( in.size == sizeof( FVec3 ) && !batch.tape->slots[in.slot].uniform )
+		{
+			++fields;
+		}
+	}
+	EXPECT_EQ( 1u, shared );
+	EXPECT_EQ( 2u, fields );
+	const UInt32 count = 37;
+	std::vector<ActorInput> inputs( count );
+	for ( UInt32 i = 0; i < count; ++i )
+	{
+		inputs[i].gameInput[Key::Space] = true;
+		inputs[i].state.pos = FVec3{ 0.1f * i, 0.45f + 0.02f * i, -0.3f * i };
+		inputs[i].state.vel = FVec3{ 0.001f * i, -0.002f * i, 0.0005f };
+	}
+	std::vector<ActorOutput> outputs( count );
+	sample_IO( *batch.tape, inputs.data( ), outputs.data( ), count, 16.0f );
+	for ( UInt32 i = 0; i < count; ++i )
+	{
+		const ActorOutput expected = fused::sample_IO( input, output, inputs[i], 16.0f );
+		EXPECT_EQ( expected.state.pos, outputs[i].state.pos );
+		EXPECT_EQ( expected.state.vel, outputs[i].state.vel );
+	}
+}
+
+TEST( BatchTest, FnEqualNodesOnce )
+{
+	auto input = fused::input<ActorInput>( );
+	// fused networks copy state into both of its consumers
+	auto state = fused::arr( getState ) < input;
+	auto output = fused::arr( conActorOutput ) < fused::lift2( withPos,
+		fused::add( gravity ) < fused::arr( getPos ) < state ) < state;
+	auto batch = fused::batch( input, output );
+	// getState, getPos, add, withPos and conActorOutput
+	EXPECT_EQ( 5u, batch.tape->ops.size( ) );
+	const UInt32 count = 37;
+	std::vector<ActorInput> inputs( count );
+	for ( UInt32 i = 0; i < count; ++i )
+	{
+		inputs[i].state.pos = FVec3{ 0.1f * i, 0.45f + 0.02f * i, -0.3f * i };
+	}
+	std::vector<ActorOutput> outputs( count );
+	sample_IO( *batch.tape, inputs.data( ), outputs.data( ), count, 16.0f );
+	for ( UInt32 i = 0; i < count; ++i )
+	{
+		const ActorOutput expected = fused::sample_IO( input, output, inputs[i], 16.0f );
+		EXPECT_EQ( expected.state.pos, outputs[i].state.pos );
+	}
+}
+
+TEST( BatchTest, FnFewerLanesKeepStorage )
+{
+	auto input = fused::input<ActorInput>( );
+	auto output = fused::arr( conActorOutput ) < fused::member( &ActorInput::state ) < input;
+	auto batch = fused::batch( input, output );
+	std::vector<ActorInput> inputs( BATCH_CHUNK_SIZE );
+	std::vector<ActorOutput> outputs( BATCH_CHUNK_SIZE );
+	sample_IO( *batch.tape, inputs.data( ), outputs.data( ), BATCH_CHUNK_SIZE, 16.0f );
+	const UInt64* values = batch.tape->values.data( );
+	inputs[3].state.pos = FVec3{ 1.0f, 2.0f, 3.0f };
+	sample_IO( *batch.tape, inputs.data( ), outputs.data( ), 10, 16.0f );
+	EXPECT_EQ( values, batch.tape->values.data( ) );
+	EXPECT_EQ( BATCH_CHUNK_SIZE, batch.tape->capacity );
+	EXPECT_EQ( inputs[3].state.pos, outputs[3].state.pos );
+}
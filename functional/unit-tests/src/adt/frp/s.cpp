@@ -0,0 +1,92 @@
+#include <pch/pch.hpp>
+#include <adt/frp/sf.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+using namespace hp_fp;
+
+TEST( STest, FnShareEvaluatesOncePerTick )
+{
+	auto counters = std::make_shared<ShareCounters>( ShareCounters{ 0, 0 } );
+	S<float> a = share( S < float > {
+		[]( const float deltaMs )
+		{
+			return deltaMs * 2.0f;
+		} }, counters );
+	S<float> sum{ [a]( const float deltaMs )
+	{
+		return a( deltaMs ) + a( deltaMs ) + a( deltaMs );
+	} };
+	EXPECT_EQ( 6.0f, sum( 1.0f ) );
+	EXPECT_EQ( 3u, counters->samples );
+	EXPECT_EQ( 1u, counters->evaluations );
+	EXPECT_EQ( 12.0f, sum( 2.0f ) );
+	EXPECT_EQ( 6u, counters->samples );
+	EXPECT_EQ( 2u, counters->evaluations );
+}
+
+TEST( STest, FnConstructsFromCallablesOnly )
+{
+	EXPECT_TRUE( ( std::is_constructible<S<float>, float( * )( const float )>::value ) );
+	EXPECT_FALSE( ( std::is_constructible<S<float>, float>::value ) );
+	EXPECT_FALSE( ( std::is_constructible<S<float>, void( * )( const float )>::value ) );
+	EXPECT_FALSE( ( std::is_constructible<SF<float, float>, S<float>>::value ) );
+}
+
+TEST( STest, FnAssign )
+{
+	S<float> a = constant( 1.0f );
+	const S<float> b = constant( 2.0f );
+	a = b;
+	EXPECT_EQ( 2.0f, a( 1.0f ) );
+	a = constant( 3.0f );
+	EXPECT_EQ( 3.0f, a( 1.0f ) );
+}
+
+TEST( STest, FnShareReevaluatesOnDirectSample )
+{
+	auto counters = std::make_shared<ShareCounters>( ShareCounters{ 0, 0 } );
+	auto total = std::make_shared<float>( 0.0f );
+	S<float> a = share( S < float > {
+		[total]( const float deltaMs )
+		{
+			return *total += deltaMs;
+		} }, counters );
+	EXPECT_EQ( 1.0f, a( 1.0f ) );
+	EXPECT_EQ( 3.0f, a < 2.0f );
+	EXPECT_EQ( 6.0f, a.apply( 3.0f ) );
+	EXPECT_EQ( 3u, counters->evaluations );
+}
+
+TEST( STest, FnTickPerThread )
+{
+	const Sampling sampling;
+	const UInt64 tick = tick_IO( );
+	UInt64 otherTick = 0;
+	std::thread( [&otherTick]
+	{
+		const Sampling sampling;
+		otherTick = tick_IO( );
+	} ).join( );
+	EXPECT_NE( tick, otherTick );
+	EXPECT_EQ( tick, tick_IO( ) );
+	EXPECT_EQ( 1u, epoch_IO( ).depth );
+}
+
+TEST( STest, FnShareReevaluatesOnEachSample )
+{
+	auto counters = std::make_shared<ShareCounters>( ShareCounters{ 0, 0 } );
+	SF<float, float> sf{ [counters]( const S<float>& a )
+	{
+		S<float> shared = share( a, counters );
+		return S < float > {
+			[shared]( const float deltaMs )
+			{
+				return shared( deltaMs ) * shared( deltaMs );
+			} };
+	} };
+	auto instance = instantiate( sf );
+	EXPECT_EQ( 4.0f, sample_IO( instance, 2.0f, 1.0f ) );
+	EXPECT_EQ( 9.0f, sample_IO( instance, 3.0f, 1.0f ) );
+	EXPECT_EQ( 4u, counters->samples );
+	EXPECT_EQ( 2u, counters->evaluations );
+}
@@ -0,0 +1,81 @@
+#include <pch/pch.hpp>
+#include <adt/frp/sf.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	float twice( const float& x )
+	{
+		return x * 2.0f;
+	}
+	float negate( const float& x )
+	{
+		return -x;
+	}
+	float minus( const float& a, const float& b )
+	{
+		return a - b;
+	}
+	float sum3( const float& a, const float& b, const float& c )
+	{
+		return a + b + c;
+	}
+	// signal counting its evaluations
+	S<float> counted( const float x, const std::shared_ptr<int>& evaluations )
+	{
+		return S < float > {
+			[x, evaluations]( const float deltaMs )
+			{
+				++*evaluations;
+				return x;
+			} };
+	}
+}
+
+TEST( SFTest, FnArrTuple )
+{
+	EXPECT_EQ( 1.0f, arr( minus ) < std::make_tuple( 3.0f, 2.0f ) < 1.0f );
+	EXPECT_EQ( 6.0f, arr( sum3 ) < std::make_tuple( 1.0f, 2.0f, 3.0f ) < 1.0f );
+}
+
+TEST( SFTest, FnFirstSecond )
+{
+	auto a = first<float, float, int>( arr( twice ) ) < std::make_tuple( 3.0f, 7 ) < 1.0f;
+	EXPECT_EQ( 6.0f, std::get<0>( a ) );
+	EXPECT_EQ( 7, std::get<1>( a ) );
+	auto b = second<float, float, int>( arr( twice ) ) < std::make_tuple( 7, 3.0f ) < 1.0f;
+	EXPECT_EQ( 7, std::get<0>( b ) );
+	EXPECT_EQ( 6.0f, std::get<1>( b ) );
+}
+
+TEST( SFTest, FnSplit )
+{
+	auto a = split( arr( twice ), arr( negate ) ) < std::make_tuple( 3.0f, 2.0f ) < 1.0f;
+	EXPECT_EQ( 6.0f, std::get<0>( a ) );
+	EXPECT_EQ( -2.0f, std::get<1>( a ) );
+}
+
+TEST( SFTest, FnFanoutEvaluatesInputOnce )
+{
+	auto evaluations = std::make_shared<int>( 0 );
+	S<float> out = arr( minus ) < fanout( arr( twice ), arr( negate ) ) <
+		counted( 3.0f, evaluations );
+	EXPECT_EQ( 9.0f, out( 1.0f ) );
+	EXPECT_EQ( 1, *evaluations );
+	EXPECT_EQ( 9.0f, out( 1.0f ) );
+	EXPECT_EQ( 2, *evaluations );
+}
+
+TEST( SFTest, FnKind )
+{
+	EXPECT_EQ( 3.0f, identity<float>( ) < 3.0f < 1.0f );
+	EXPECT_EQ( 5.0f, constantSF<float>( 5.0f ) < 3.0f < 1.0f );
+	EXPECT_TRUE( SFKind::Identity == identity<float>( ).kind );
+	EXPECT_TRUE( SFKind::Signal == arr( twice ).kind );
+	EXPECT_TRUE( SFKind::Identity == ( identity<float>( ) > identity<float>( ) ).kind );
+	EXPECT_TRUE( SFKind::Signal == ( identity<float>( ) > arr( twice ) ).kind );
+	EXPECT_TRUE( SFKind::Constant == ( arr( twice ) > constantSF<float>( 1.0f ) ).kind );
+	EXPECT_TRUE( SFKind::Constant == ( constantSF<float>( 1.0f ) > identity<float>( ) ).kind );
+	EXPECT_TRUE( SFKind::Signal == ( constantSF<float>( 1.0f ) > arr( twice ) ).kind );
+}
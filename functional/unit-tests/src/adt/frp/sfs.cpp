@@ -0,0 +1,224 @@
+#include <pch/pch.hpp>
+#include <adt/frp/sfs.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+using namespace hp_fp;
+
+TEST( SFsTest, FnIntegralAccumulates )
+{
+	auto instance = instantiate( integral( 1.0f ) );
+	EXPECT_EQ( 3.0f, sample_IO( instance, 2.0f, 1.0f ) );
+	EXPECT_EQ( 9.0f, sample_IO( instance, 3.0f, 2.0f ) );
+	EXPECT_EQ( 8.0f, sample_IO( instance, -0.5f, 2.0f ) );
+}
+
+TEST( SFsTest, FnIntegralAdvancesOncePerTick )
+{
+	SF<float, float> sf{ []( const S<float>& a )
+	{
+		S<float> acc = integral( 0.0f ) < a;
+		return S < float > {
+			[acc]( const float deltaMs )
+			{
+				return acc( deltaMs ) + acc( deltaMs );
+			} };
+	} };
+	auto instance = instantiate( sf );
+	EXPECT_EQ( 4.0f, sample_IO( instance, 2.0f, 1.0f ) );
+	EXPECT_EQ( 8.0f, sample_IO( instance, 2.0f, 1.0f ) );
+}
+
+TEST( SFsTest, FnIntegralAdvancesOnDirectSample )
+{
+	S<float> acc = integral( 1.0f ) < constant( 2.0f );
+	EXPECT_EQ( 3.0f, acc( 1.0f ) );
+	EXPECT_EQ( 7.0f, acc( 2.0f ) );
+	EXPECT_EQ( 9.0f, acc < 1.0f );
+	auto step = std::make_shared<float>( 0.0f );
+	S<float> delayed = delay<1>( 0.0f ) < S < float > {
+		[step]( const float deltaMs )
+		{
+			return *step += 1.0f;
+		} };
+	EXPECT_EQ( 0.0f, delayed( 1.0f ) );
+	EXPECT_EQ( 1.0f, delayed( 1.0f ) );
+	EXPECT_EQ( 2.0f, delayed( 1.0f ) );
+}
+
+TEST( SFsTest, FnDelay )
+{
+	auto instance = instantiate( delay<2>( 0.0f ) );
+	EXPECT_EQ( 0.0f, sample_IO( instance, 1.0f, 1.0f ) );
+	EXPECT_EQ( 0.0f, sample_IO( instance, 2.0f, 1.0f ) );
+	EXPECT_EQ( 1.0f, sample_IO( instance, 3.0f, 1.0f ) );
+	EXPECT_EQ( 2.0f, sample_IO( instance, 4.0f, 1.0f ) );
+	auto pre = instantiate( iPre( -1.0f ) );
+	EXPECT_EQ( -1.0f, sample_IO( pre, 1.0f, 1.0f ) );
+	EXPECT_EQ( 1.0f, sample_IO( pre, 2.0f, 1.0f ) );
+}
+
+TEST( SFsTest, FnHold )
+{
+	SF<float, float> sf{ []( const S<float>& a )
+	{
+		return hold( 0.0f ) < S < E<float> > {
+			[a]( const float deltaMs )
+			{
+				float x = a( deltaMs );
+				return x > 0.0f ? e( std::move( x ) ) : noE<float>( );
+			} };
+	} };
+	auto instance = instantiate( sf );
+	EXPECT_EQ( 0.0f, sample_IO( instance, -1.0f, 1.0f ) );
+	EXPECT_EQ( 2.0f, sample_IO( instance, 2.0f, 1.0f ) );
+	EXPECT_EQ( 2.0f, sample_IO( instance, -3.0f, 1.0f ) );
+	EXPECT_EQ( 4.0f, sample_IO( instance, 4.0f, 1.0f ) );
+}
+
+TEST( SFsTest, FnLoop )
+{
+	// running sum of the input fed back through the loop
+	auto instance = instantiate( loop<float, float>( 10.0f,
+		[]( const S<float>& input, const S<float>& feedback )
+	{
+		return S < float > {
+			[input, feedback]( const float deltaMs )
+			{
+				return input( deltaMs ) + feedback( deltaMs );
+			} };
+	} ) );
+	EXPECT_EQ( 11.0f, sample_IO( instance, 1.0f, 1.0f ) );
+	EXPECT_EQ( 13.0f, sample_IO( instance, 2.0f, 1.0f ) );
+	EXPECT_EQ( 16.0f, sample_IO( instance, 3.0f, 1.0f ) );
+}
+
+TEST( SFsTest, FnInstantiateAllocatesOneStateBlock )
+{
+	SF<float, float> sf = compose( compose( integral( 0.0f ), iPre( 0.0f ) ),
+		delay<3>( 0.0f ) );
+	auto instance = instantiate( sf );
+	auto other = instantiate( sf );
+	EXPECT_TRUE( instance.state->allocated );
+	EXPECT_NE( instance.state, other.state );
+	EXPECT_EQ( sizeof( TickedValue<float> ) + sizeof( DelayState<float, 1> ) +
+		sizeof( DelayState<float, 3> ), instance.state->size );
+	sample_IO( instance, 1.0f, 1.0f );
+	EXPECT_EQ( 0.0f, sample_IO( other, 1.0f, 1.0f ) );
+	EXPECT_EQ( 0.0f, sample_IO( instance, 1.0f, 1.0f ) );
+}
+
+TEST( SFsTest, FnInstantiateOnThreadsKeepsBlocksApart )
+{
+	const SF<float, float> sf = compose( compose( integral( 0.0f ), iPre( 0.0f ) ),
+		delay<3>( 0.0f ) );
+	const UInt32 size = sizeof( TickedValue<float> ) + sizeof( DelayState<float, 1> ) +
+		sizeof( DelayState<float, 3> );
+	bool apart[2] = { true, true };
+	std::thread threads[2];
+	for ( UInt32 t = 0; t < 2; ++t )
+	{
+		threads[t] = std::thread( [&sf, &apart, size, t]
+		{
+			for ( UInt32 i = 0; i < 200; ++i )
+			{
+				auto instance = instantiate( sf );
+				apart[t] = apart[t] && instance.state->size == size;
+			}
+		} );
+	}
+	threads[0].join( );
+	threads[1].join( );
+	EXPECT_TRUE( apart[0] );
+	EXPECT_TRUE( apart[1] );
+}
+
+namespace
+{
+	// subject outputs its input and fires with it once it exceeds limit
+	SF<float, std::tuple<float, E<float>>> untilAbove( const float limit,
+		const std::shared_ptr<int>& evaluations )
+	{
+		return SF < float, std::tuple<float, E<float>> > {
+			[limit, evaluations]( const S<float>& a )
+			{
+				return S < std::tuple<float, E<float>> > {
+					[limit, evaluations, a]( const float deltaMs )
+					{
+						++*evaluations;
+						float x = a( deltaMs );
+						return std::make_tuple( x, x > limit ? e( float( x ) ) : noE<float>( ) );
+					} };
+			} };
+	}
+	std::function<SF<float, float>( float )> scaleBy( )
+	{
+		return []( const float c )
+		{
+			return arrAlt<float, float>( [c]( const float& x )
+			{
+				return x * c;
+			} );
+		};
+	}
+}
+
+TEST( SFsTest, FnSwEvaluatesSubjectOnceAndLatches )
+{
+	auto evaluations = std::make_shared<int>( 0 );
+	auto instance = instantiate( sw( untilAbove( 2.0f, evaluations ), scaleBy( ) ) );
+	EXPECT_EQ( 1.0f, sample_IO( instance, 1.0f, 1.0f ) );
+	EXPECT_EQ( 1, *evaluations );
+	// switched in at the event tick
+	EXPECT_EQ( 9.0f, sample_IO( instance, 3.0f, 1.0f ) );
+	EXPECT_EQ( 2, *evaluations );
+	EXPECT_EQ( 3.0f, sample_IO( instance, 1.0f, 1.0f ) );
+	EXPECT_EQ( 2, *evaluations );
+}
+
+TEST( SFsTest, FnDSwitch )
+{
+	auto evaluations = std::make_shared<int>( 0 );
+	auto instance = instantiate( dSwitch( untilAbove( 2.0f, evaluations ), scaleBy( ) ) );
+	EXPECT_EQ( 1.0f, sample_IO( instance, 1.0f, 1.0f ) );
+	EXPECT_EQ( 3.0f, sample_IO( instance, 3.0f, 1.0f ) );
+	EXPECT_EQ( 6.0f, sample_IO( instance, 2.0f, 1.0f ) );
+	EXPECT_EQ( 2, *evaluations );
+}
+
+TEST( SFsTest, FnRSwitch )
+{
+	// E is move only, so the input is generated by the signal instead of a slot
+	auto step = std::make_shared<int>( 0 );
+	S<std::tuple<float, E<SF<float, float>>>> input{ [step]( const float deltaMs )
+	{
+		const float x = *step % 2 ? 1.0f : 2.0f;
+		return std::make_tuple( x, *step % 2 ? e( scaleBy( )( 2.0f + *step ) )
+			: noE<SF<float, float>>( ) );
+	} };
+	S<float> out = rSwitch( scaleBy( )( 1.0f ) ) < input;
+	const float expected[] = { 2.0f, 3.0f, 6.0f, 5.0f, 10.0f };
+	for ( const auto x : expected )
+	{
+		EXPECT_EQ( x, out( 1.0f ) );
+		++*step;
+	}
+}
+
+TEST( SFsTest, FnKSwitchContinuesSubject )
+{
+	// event when the accumulated output exceeds 2, k adds 100 to the running subject
+	auto instance = instantiate( kSwitch<float, float, float>( integral( 0.0f ),
+		arrAlt<std::tuple<float, float>, E<float>>( []( const std::tuple<float, float>& t )
+	{
+		return std::get<1>( t ) > 2.0f ? e( float( std::get<1>( t ) ) ) : noE<float>( );
+	} ), []( const SF<float, float>& subject, const float& c )
+	{
+		return compose( subject, arrAlt<float, float>( []( const float& x )
+		{
+			return x + 100.0f;
+		} ) );
+	} ) );
+	EXPECT_EQ( 2.0f, sample_IO( instance, 2.0f, 1.0f ) );
+	EXPECT_EQ( 104.0f, sample_IO( instance, 2.0f, 1.0f ) );
+	EXPECT_EQ( 105.0f, sample_IO( instance, 1.0f, 1.0f ) );
+}
@@ -0,0 +1,210 @@
+#include <pch/pch.hpp>
+#include <core/actor/actor.hpp>
+#include <adt/frp/sfs.hpp>
+#include <adt/frp/tape.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	const float rotSpeed = 0.003f;
+	const FVec3 gravity{ 0.0f, -0.00000981f, 0.0f };
+	ActorState getState( const ActorInput& input )
+	{
+		return input.state;
+	}
+	FVec3 getPos( const ActorState& state )
+	{
+		return state.pos;
+	}
+	FVec3 getVel( const ActorState& state )
+	{
+		return state.vel;
+	}
+	FQuat getRot( const ActorState& state )
+	{
+		return state.rot;
+	}
+	FVec3 fromY( const float& y )
+	{
+		return FVec3{ 0.0f, y, 0.0f };
+	}
+	ActorState withPos( const FVec3& pos, const ActorState& state )
+	{
+		auto newState = state;
+		newState.pos = pos;
+		return newState;
+	}
+	ActorState withVel( const FVec3& vel, const ActorState& state )
+	{
+		auto newState = state;
+		newState.vel = vel;
+		return newState;
+	}
+	ActorState withRot( const FQuat& rot, const ActorState& state )
+	{
+		auto newState = state;
+		newState.rot = rot;
+		return newState;
+	}
+	ActorOutput conActorOutput( const ActorState& state )
+	{
+		return ActorOutput{ state };
+	}
+	// closure implementation used as the reference
+	SF<ActorInput, ActorOutput> reference( )
+	{
+		return SF < ActorInput, ActorOutput > {
+			[]( const S<ActorInput>& input ) -> S < ActorOutput >
+			{
+				S<ActorState> state = arr( getState ) < input;
+				S<FQuat> rot = mul( arr( getRot ) < state ) < arr( eulerRadToQuat<float> )
+					< arr( fromY ) < integral<float>( ) < rotSpeed;
+				S<FVec3> vel = sub( arr( getVel ) < state ) < mul<FVec3>( 0.5f ) < add( gravity )
+					< integral<FVec3>( ) < gravity;
+				S<FVec3> pos = add( arr( getPos ) < state ) < rotate( rot )
+					< integral<FVec3>( ) < vel;
+				return S < ActorOutput > {
+					[state, rot, vel, pos]( const float deltaMs )
+					{
+						return conActorOutput( withRot( rot( deltaMs ),
+							withVel( vel( deltaMs ), withPos( pos( deltaMs ),
+							state( deltaMs ) ) ) ) );
+					}
+				};
+			}
+		};
+	}
+	std::vector<ActorInput> recordedInputs( )
+	{
+		std::vector<ActorInput> inputs;
+		ActorInput input{ };
+		input.state.pos = FVec3{ 1.0f, 2.0f, 3.0f };
+		input.state.vel = FVec3{ 0.001f, 0.002f, -0.003f };
+		input.state.scl = FVec3{ 1.0f, 1.0f, 1.0f };
+		for ( int i = 0; i < 256; ++i )
+		{
+			input.state.pos = input.state.pos + FVec3{ 0.01f, -0.02f, 0.005f * i };
+			input.state.vel = input.state.vel * 1.01f;
+			input.state.rot = input.state.rot * eulerRadToQuat( FVec3{ 0.0f, 0.01f, 0.0f } );
+			inputs.push_back( input );
+		}
+		return inputs;
+	}
+}
+
+TEST( TapeTest, FnCompileMatchesClosures )
+{
+	auto input = fused::input<ActorInput>( );
+	auto state = fused::arr( getState ) < input;
+	auto rot = fused::mul( fused::arr( getRot ) < state ) < fused::arr( eulerRadToQuat<float> )
+		< fused::arr( fromY ) < fused::integral( ) < rotSpeed;
+	auto vel = fused::sub( fused::arr( getVel ) < state ) < fused::mul( 0.5f )
+		< fused::add( gravity ) < fused::integral( ) < gravity;
+	auto pos = fused::add( fused::arr( getPos ) < state ) < fused::rotate( rot )
+		< fused::integral( ) < vel;
+	auto output = fused::arr( conActorOutput ) < fused::lift2( withRot, rot )
+		< fused::lift2( withVel, vel ) < fused::lift2( withPos, pos ) < state;
+
+	auto tape = fused::compile( input, output );
+	auto closures = instantiate( reference( ) );
+	float deltaMs = 16.0f;
+	for ( const auto& actorInput : recordedInputs( ) )
+	{
+		deltaMs += 0.125f;
+		const ActorOutput expected = sample_IO( closures, actorInput, deltaMs );
+		const ActorOutput fromFused = fused::sample_IO( input, output, actorInput, deltaMs );
+		const ActorOutput fromTape = sample_IO( tape, actorInput, deltaMs );
+		for ( const auto* actual : { &fromFused, &fromTape } )
+		{
+			EXPECT_EQ( expected.state.pos, actual->state.pos );
+			EXPECT_EQ( expected.state.vel, actual->state.vel );
+			EXPECT_EQ( expected.state.scl, actual->state.scl );
+			EXPECT_EQ( expected.state.rot.x, actual->state.rot.x );
+			EXPECT_EQ( expected.state.rot.y, actual->state.rot.y );
+			EXPECT_EQ( expected.state.rot.z, actual->state.rot.z );
+			EXPECT_EQ( expected.state.rot.w, actual->state.rot.w );
+		}
+	}
+}
+
+TEST( TapeTest, FnEqualNodesOnce )
+{
+	auto input = fused::input<ActorInput>( );
+	// fused networks copy state into both of its consumers
+	auto state = fused::arr( getState ) < input;
+	auto output = fused::arr( conActorOutput ) < fused::lift2( withPos,
+		fused::add( gravity ) < fused::arr( getPos ) < state ) < state;
+	auto tape = fused::compile( input, output );
+	// getState, getPos, add, withPos and conActorOutput
+	EXPECT_EQ( 5u, tape.ops.size( ) );
+	for ( const auto& actorInput : recordedInputs( ) )
+	{
+		const ActorOutput expected = fused::sample_IO( input, output, actorInput, 16.0f );
+		EXPECT_EQ( expected.state.pos, sample_IO( tape, actorInput, 16.0f ).state.pos );
+	}
+}
+
+TEST( TapeTest, FnCompileSFMatchesErase )
+{
+	auto input = fused::input<ActorInput>( );
+	auto state = fused::arr( getState ) < input;
+	auto vel = fused::sub( fused::arr( getVel ) < state ) < fused::mul( 0.5f )
+		< fused::add( gravity ) < fused::integral( ) < gravity;
+	auto output = fused::arr( conActorOutput ) < fused::lift2( withVel, vel ) < state;
+	auto fromTape = instantiate( fused::compileSF( input, output ) );
+	auto fromClosures = instantiate( fused::erase( input, output ) );
+	float deltaMs = 16.0f;
+	for ( const auto& actorInput : recordedInputs( ) )
+	{
+		deltaMs += 0.125f;
+		const ActorOutput expected = sample_IO( fromClosures, actorInput, deltaMs );
+		const ActorOutput actual = sample_IO( fromTape, actorInput, deltaMs );
+		EXPECT_EQ( expected.state.pos, actual.state.pos );
+		EXPECT_EQ( expected.state.vel, actual.state.vel );
+	}
+}
+
+namespace
+{
+	// half the input, fires with the input once it is above 2
+	std::tuple<float, E<float>> fireAbove( const float& x )
+	{
+		return std::make_tuple( x * 0.5f, x > 2.0f ? e( float( x ) ) : noE<float>( ) );
+	}
+	float scaled( const float& c, const float& x )
+	{
+		return x * c + 0.25f;
+	}
+}
+
+TEST( TapeTest, FnSwitchMatchesSw )
+{
+	auto reference = instantiate( sw<float, float, float>( arrAlt<float, std::tuple<float,
+		E<float>>>( fireAbove ), std::function<SF<float, float>( float )>( []( const float c )
+	{
+		return arrAlt<float, float>( [c]( const float& x )
+		{
+			return scaled( c, x );
+		} );
+	} ) ) );
+	auto input = fused::input<float>( );
+	auto output = fused::sw<float>( fused::arr( fireAbove ),
+		[]( const fused::S<fused::LatchNode<float>>& c )
+	{
+		return fused::lift2( scaled, c );
+	} ) < input;
+	auto tape = fused::compile( input, output );
+	// the switch is one op, its subject and the switched in network are sub-tapes of it
+	EXPECT_EQ( 1u, tape.ops.size( ) );
+	float x = 0.0f;
+	for ( int i = 0; i < 64; ++i )
+	{
+		x += i < 32 ? 0.07f : -0.03f;
+		const float expected = sample_IO( reference, x, 16.0f );
+		EXPECT_EQ( expected, fused::sample_IO( input, output, x, 16.0f ) );
+		EXPECT_EQ( expected, sample_IO( tape, x, 16.0f ) );
+	}
+	// switched in at the tick above 2, after it the output is not half the input
+	EXPECT_NE( x * 0.5f, sample_IO( tape, x, 16.0f ) );
+}
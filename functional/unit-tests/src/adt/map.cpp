@@ -0,0 +1,173 @@
+#include <pch/pch.hpp>
+#include <map>
+#include <random>
+#include <adt/map.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	// all keys with equal remainder collide
+	struct ModHash
+	{
+		size_t operator () ( const Int32 a ) const
+		{
+			return a % 4;
+		}
+	};
+	template<typename H>
+	void expectEq( const std::map<Int32, Int32>& expected, const Map<Int32, Int32, H>& m )
+	{
+		ASSERT_EQ( expected.size( ), m.size( ) );
+		for ( const auto& kv : expected )
+		{
+			const Int32* b = m.find( kv.first );
+			ASSERT_NE( nullptr, b );
+			EXPECT_EQ( kv.second, *b );
+		}
+		UInt32 count = 0;
+		m.forEach( [&expected, &count]( const Int32& a, const Int32& b )
+		{
+			EXPECT_EQ( expected.at( a ), b );
+			++count;
+		} );
+		EXPECT_EQ( expected.size( ), count );
+	}
+}
+
+TEST( MapTest, FnInsertFind )
+{
+	const Map<Int32, Int32> empty;
+	EXPECT_TRUE( empty.isEmpty( ) );
+	EXPECT_EQ( nullptr, empty.find( 1 ) );
+	std::map<Int32, Int32> expected;
+	Map<Int32, Int32> m;
+	for ( Int32 i = 0; i < 5000; ++i )
+	{
+		m = m.insert( i * 7, i );
+		expected[i * 7] = i;
+	}
+	expectEq( expected, m );
+	EXPECT_FALSE( m.contains( 1 ) );
+	const auto replaced = m.insert( 7, -1 );
+	EXPECT_EQ( m.size( ), replaced.size( ) );
+	EXPECT_EQ( -1, *replaced.find( 7 ) );
+	EXPECT_EQ( 1, *m.find( 7 ) );
+}
+
+TEST( MapTest, FnErase )
+{
+	std::mt19937 random( 7 );
+	std::map<Int32, Int32> expected;
+	Map<Int32, Int32> m;
+	for ( Int32 i = 0; i < 2000; ++i )
+	{
+		const Int32 a = random( ) % 1000;
+		if ( random( ) % 3 == 0 )
+		{
+			m = m.erase( a );
+			expected.erase( a );
+		}
+		else
+		{
+			m = m.insert( a, i );
+			expected[a] = i;
+		}
+	}
+	expectEq( expected, m );
+	for ( const auto& kv : expected )
+	{
+		m = m.erase( kv.first );
+	}
+	EXPECT_TRUE( m.isEmpty( ) );
+	EXPECT_EQ( 0, m.erase( 3 ).size( ) );
+}
+
+TEST( MapTest, FnCollisions )
+{
+	std::map<Int32, Int32> expected;
+	Map<Int32, Int32, ModHash> m;
+	for ( Int32 i = 0; i < 100; ++i )
+	{
+		m = m.insert( i, -i );
+		expected[i] = -i;
+	}
+	expectEq( expected, m );
+	for ( Int32 i = 0; i < 100; i += 3 )
+	{
+		m = m.erase( i );
+		expected.erase( i );
+	}
+	expectEq( expected, m );
+	EXPECT_EQ( nullptr, m.find( 0 ) );
+	EXPECT_EQ( nullptr, m.find( 200 ) );
+}
+
+TEST( MapTest, FnPersistence )
+{
+	std::map<Int32, Int32> expected;
+	Map<Int32, Int32> m;
+	for ( Int32 i = 0; i < 1000; ++i )
+	{
+		m = m.insert( i, i );
+		expected[i] = i;
+	}
+	const auto snapshot = m;
+	for ( Int32 i = 0; i < 1000; i += 2 )
+	{
+		m = m.erase( i ).insert( i + 1, 0 );
+	}
+	expectEq( expected, snapshot );
+	EXPECT_EQ( 500, m.size( ) );
+}
+
+TEST( MapTest, FnTransient )
+{
+	const Map<Int32, Int32> base{ { 1, 1 }, { 2, 2 } };
+	MapTransient<Int32, Int32> t( base );
+	for ( Int32 i = 0; i < 3000; ++i )
+	{
+		t.insert_IO( i, i * 2 );
+	}
+	t.erase_IO( 0 );
+	const auto first = t.persistent_IO( );
+	// changes after persistent_IO do not reach maps handed out before
+	t.insert_IO( 5, -5 );
+	t.erase_IO( 6 );
+	const auto second = t.persistent_IO( );
+	std::map<Int32, Int32> expected;
+	for ( Int32 i = 1; i < 3000; ++i )
+	{
+		expected[i] = i * 2;
+	}
+	expectEq( expected, first );
+	expectEq( { { 1, 1 }, { 2, 2 } }, base );
+	expected[5] = -5;
+	expected.erase( 6 );
+	expectEq( expected, second );
+}
+
+TEST( MapTest, FnLookupFold )
+{
+	const Map<Int32, Int32> m{ { 1, 10 }, { 2, 20 }, { 3, 30 } };
+	const Int32 sum = foldl( []( const Int32 acc, const Int32& a, const Int32& b )
+	{
+		return acc + a * b;
+	}, 0, m );
+	EXPECT_EQ( 140, sum );
+	const bool found = ifThenElse( lookup( m, 2 ), []( const Int32& b )
+	{
+		return b == 20;
+	}, []
+	{
+		return false;
+	} );
+	EXPECT_TRUE( found );
+	EXPECT_FALSE( ifThenElse( lookup( m, 4 ), []( const Int32& )
+	{
+		return true;
+	}, []
+	{
+		return false;
+	} ) );
+}
@@ -0,0 +1,90 @@
+#include <pch/pch.hpp>
+#include <memory>
+#include <adt/maybe.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	Int32 valueOr( const Maybe<Int32>& m, const Int32 b )
+	{
+		return ifThenElse( m, []( const Int32& a )
+		{
+			return a;
+		}, [b]
+		{
+			return b;
+		} );
+	}
+}
+
+TEST( MaybeTest, FnJustNothing )
+{
+	EXPECT_EQ( 3, valueOr( just( 3 ), 0 ) );
+	EXPECT_EQ( 0, valueOr( nothing<Int32>( ), 0 ) );
+	static_assert( sizeof( Maybe<Int32> ) <= 2 * sizeof( Int32 ), "Maybe stores its value inline." );
+}
+
+TEST( MaybeTest, FnCopy )
+{
+	static_assert( std::is_copy_constructible<Maybe<Int32>>::value,
+		"Maybe of trivially copyable type is copyable." );
+	static_assert( !std::is_copy_constructible<Maybe<std::unique_ptr<Int32>>>::value,
+		"Maybe of move-only type is move-only." );
+	const Maybe<Int32> m = just( 5 );
+	const Maybe<Int32> copy( m );
+	EXPECT_EQ( 5, valueOr( m, 0 ) );
+	EXPECT_EQ( 5, valueOr( copy, 0 ) );
+	static_assert( !std::is_copy_assignable<Maybe<std::unique_ptr<Int32>>>::value,
+		"Maybe of move-only type is not copy assignable." );
+	Maybe<Int32> assigned = nothing<Int32>( );
+	assigned = m;
+	EXPECT_EQ( 5, valueOr( assigned, 0 ) );
+	assigned = nothing<Int32>( );
+	EXPECT_EQ( 0, valueOr( assigned, 0 ) );
+}
+
+TEST( MaybeTest, FnMoveDestroy )
+{
+	auto p = std::make_shared<Int32>( 7 );
+	{
+		Maybe<std::shared_ptr<Int32>> m = just( std::shared_ptr<Int32>( p ) );
+		EXPECT_EQ( 2, p.use_count( ) );
+		Maybe<std::shared_ptr<Int32>> moved( std::move( m ) );
+		EXPECT_EQ( 2, p.use_count( ) );
+		EXPECT_FALSE( ifThenElse( m, []( std::shared_ptr<Int32>& )
+		{
+			return true;
+		}, []
+		{
+			return false;
+		} ) );
+	}
+	EXPECT_EQ( 1, p.use_count( ) );
+}
+
+TEST( MaybeTest, FnMoveAssign )
+{
+	auto p = std::make_shared<Int32>( 7 );
+	auto q = std::make_shared<Int32>( 8 );
+	{
+		Maybe<std::shared_ptr<Int32>> m = just( std::shared_ptr<Int32>( p ) );
+		Maybe<std::shared_ptr<Int32>> n = just( std::shared_ptr<Int32>( q ) );
+		m = std::move( n );
+		EXPECT_EQ( 1, p.use_count( ) );
+		EXPECT_EQ( 2, q.use_count( ) );
+		EXPECT_EQ( 8, ifThenElse( m, []( std::shared_ptr<Int32>& a )
+		{
+			return *a;
+		}, []
+		{
+			return 0;
+		} ) );
+		m = nothing<std::shared_ptr<Int32>>( );
+		EXPECT_EQ( 1, q.use_count( ) );
+		m = just( std::shared_ptr<Int32>( p ) );
+		m = std::move( m );
+		EXPECT_EQ( 2, p.use_count( ) );
+	}
+	EXPECT_EQ( 1, p.use_count( ) );
+}
@@ -0,0 +1,104 @@
+#include <pch/pch.hpp>
+#include <vector>
+#include <adt/parallel.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	std::vector<Int32> range( const Int32 count )
+	{
+		std::vector<Int32> v;
+		for ( Int32 i = 0; i < count; ++i )
+		{
+			v.push_back( i );
+		}
+		return v;
+	}
+	std::vector<Int32> toStd( const Vector<Int32>& v )
+	{
+		std::vector<Int32> vals;
+		v.forEach( [&vals]( const Int32& a )
+		{
+			vals.push_back( a );
+		} );
+		return vals;
+	}
+	Int32 square( const Int32& a )
+	{
+		return a * a;
+	}
+	bool isOdd( const Int32& a )
+	{
+		return a % 2 != 0;
+	}
+}
+
+TEST( ParallelTest, FnRunCallsEachChunkOnce )
+{
+	ThreadPool pool( 4 );
+	EXPECT_EQ( 4u, pool.threadCount( ) );
+	for ( UInt32 run = 0; run < 50; ++run )
+	{
+		std::vector<std::atomic<UInt32>> calls( 1000 );
+		auto f = [&calls]( const UInt32 c )
+		{
+			++calls[c];
+		};
+		pool.run_IO( static_cast<UInt32>( calls.size( ) ), f );
+		for ( const auto& c : calls )
+		{
+			ASSERT_EQ( 1u, c );
+		}
+	}
+}
+
+TEST( ParallelTest, FnMapFilter )
+{
+	ThreadPool pool( 4 );
+	const auto v = range( 10000 );
+	std::vector<Int32> squares;
+	std::vector<Int32> odds;
+	for ( const auto a : v )
+	{
+		squares.push_back( square( a ) );
+		if ( isOdd( a ) )
+		{
+			odds.push_back( a );
+		}
+	}
+	EXPECT_EQ( squares, parallelMap( pool, square, v, 100 ) );
+	EXPECT_EQ( odds, parallelFilter( pool, isOdd, v, 77 ) );
+	const Vector<Int32> vec( v.begin( ), v.end( ) );
+	EXPECT_EQ( squares, toStd( parallelMap( pool, square, vec, 100 ) ) );
+	EXPECT_EQ( odds, toStd( parallelFilter( pool, isOdd, vec, 77 ) ) );
+	EXPECT_TRUE( parallelMap( pool, square, std::vector<Int32>( ) ).empty( ) );
+	EXPECT_TRUE( parallelFilter( pool, isOdd, Vector<Int32>( ) ).isEmpty( ) );
+}
+
+TEST( ParallelTest, FnReduceIsDeterministic )
+{
+	// float addition is not associative, equal results need equal chunking
+	std::vector<float> v;
+	for ( UInt32 i = 0; i < 100000; ++i )
+	{
+		v.push_back( 1.0f / ( i + 1 ) );
+	}
+	const Vector<float> vec( v.begin( ), v.end( ) );
+	auto add = []( const float acc, const float a )
+	{
+		return acc + a;
+	};
+	ThreadPool single( 1 );
+	const float expected = parallelReduce( single, add, 0.0f, v, 1000 );
+	for ( UInt32 threads = 2; threads <= 8; threads *= 2 )
+	{
+		ThreadPool pool( threads );
+		for ( UInt32 run = 0; run < 10; ++run )
+		{
+			EXPECT_EQ( expected, parallelReduce( pool, add, 0.0f, v, 1000 ) );
+			EXPECT_EQ( expected, parallelReduce( pool, add, 0.0f, vec, 1000 ) );
+		}
+	}
+	EXPECT_EQ( 3, parallelReduce( single, add, 3.0f, std::vector<float>( ) ) );
+}
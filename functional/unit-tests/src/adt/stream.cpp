@@ -0,0 +1,101 @@
+#include <pch/pch.hpp>
+#include <memory>
+#include <vector>
+#include <adt/stream.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	template<typename S>
+	std::vector<Int32> toVector( const Stream<S>& s )
+	{
+		std::vector<Int32> vals;
+		forEach( s, [&vals]( const Int32 a )
+		{
+			vals.push_back( a );
+		} );
+		return vals;
+	}
+	bool isOdd( const Int32 a )
+	{
+		return a % 2 != 0;
+	}
+}
+
+TEST( StreamTest, FnSources )
+{
+	const std::vector<Int32> v{ 1, 2, 3 };
+	const List<Int32> l{ 1, 2, 3 };
+	const Vector<Int32> vec{ 1, 2, 3 };
+	const Int32 a[] = { 1, 2, 3 };
+	EXPECT_EQ( v, toVector( stream( v ) ) );
+	EXPECT_EQ( v, toVector( stream( l ) ) );
+	EXPECT_EQ( v, toVector( stream( vec ) ) );
+	EXPECT_EQ( v, toVector( stream( a, a + 3 ) ) );
+	EXPECT_TRUE( toVector( stream( std::vector<Int32>( ) ) ).empty( ) );
+}
+
+TEST( StreamTest, FnPipeline )
+{
+	std::vector<Int32> v;
+	for ( Int32 i = 0; i < 10; ++i )
+	{
+		v.push_back( i );
+	}
+	const auto squares = fmap( []( const Int32 a )
+	{
+		return a * a;
+	}, filter( isOdd, stream( v ) ) );
+	EXPECT_EQ( std::vector<Int32>( { 1, 9, 25, 49, 81 } ), toVector( squares ) );
+	EXPECT_EQ( std::vector<Int32>( { 1, 9 } ), toVector( take( 2, squares ) ) );
+	EXPECT_EQ( 165, foldl( []( const Int32 acc, const Int32 a )
+	{
+		return acc + a;
+	}, 0, squares ) );
+	// streams are values, pulling a copy leaves the original at its start
+	EXPECT_EQ( 5u, toVector( squares ).size( ) );
+}
+
+TEST( StreamTest, FnLaziness )
+{
+	const std::vector<Int32> v{ 1, 2, 3, 4, 5 };
+	Int32 calls = 0;
+	const auto s = take( 2, fmap( [&calls]( const Int32 a )
+	{
+		++calls;
+		return a;
+	}, stream( v ) ) );
+	EXPECT_EQ( 0, calls );
+	EXPECT_EQ( std::vector<Int32>( { 1, 2 } ), toVector( s ) );
+	EXPECT_EQ( 2, calls );
+}
+
+TEST( StreamTest, FnZip )
+{
+	const std::vector<Int32> a{ 1, 2, 3 };
+	const List<Int32> b{ 10, 20 };
+	const Int32 sum = foldl( []( const Int32 acc, const std::tuple<const Int32&, const Int32&>& ab )
+	{
+		return acc + std::get<0>( ab ) * std::get<1>( ab );
+	}, 0, zip( stream( a ), stream( b ) ) );
+	EXPECT_EQ( 50, sum );
+}
+
+TEST( StreamTest, FnNoCopies )
+{
+	// move-only elements are passed by reference through every stage
+	std::vector<std::unique_ptr<Int32>> v;
+	for ( Int32 i = 0; i < 4; ++i )
+	{
+		v.push_back( std::unique_ptr<Int32>( new Int32( i ) ) );
+	}
+	const Int32 sum = foldl( []( const Int32 acc, const std::unique_ptr<Int32>& a )
+	{
+		return acc + *a;
+	}, 0, filter( []( const std::unique_ptr<Int32>& a )
+	{
+		return *a > 1;
+	}, stream( v ) ) );
+	EXPECT_EQ( 5, sum );
+}
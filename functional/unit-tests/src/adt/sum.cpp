@@ -0,0 +1,123 @@
+#include <pch/pch.hpp>
+#include <memory>
+#include <adt/sum.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	typedef Sum<Int32, float, std::shared_ptr<Int32>> IntFloatPtr;
+	Int32 toInt( const IntFloatPtr& sum )
+	{
+		return match( sum, []( const Int32& i )
+		{
+			return i;
+		}, []( const float& f )
+		{
+			return static_cast<Int32>( f );
+		}, []( const std::shared_ptr<Int32>& p )
+		{
+			return *p;
+		} );
+	}
+	struct Describe
+	{
+		const char* operator () ( const Int32& ) const
+		{
+			return "int";
+		}
+		const char* operator () ( const float& ) const
+		{
+			return "float";
+		}
+		const char* operator () ( const std::shared_ptr<Int32>& ) const
+		{
+			return "ptr";
+		}
+	};
+}
+
+TEST( SumTest, FnIsGet )
+{
+	const IntFloatPtr i( 3 );
+	const IntFloatPtr f( 2.5f );
+	EXPECT_TRUE( i.is<Int32>( ) );
+	EXPECT_FALSE( i.is<float>( ) );
+	EXPECT_TRUE( f.is<float>( ) );
+	EXPECT_EQ( 3, i.get<Int32>( ) );
+	EXPECT_EQ( 2.5f, f.get<float>( ) );
+	EXPECT_EQ( 1, ( SumIndex<float, Int32, float, std::shared_ptr<Int32>>::value ) );
+	static_assert( sizeof( Sum<Int32, float> ) == 2 * sizeof( Int32 ), "Sum is a tag and a union." );
+}
+
+TEST( SumTest, FnMatchVisit )
+{
+	EXPECT_EQ( 3, toInt( IntFloatPtr( 3 ) ) );
+	EXPECT_EQ( 2, toInt( IntFloatPtr( 2.5f ) ) );
+	EXPECT_EQ( 7, toInt( IntFloatPtr( std::make_shared<Int32>( 7 ) ) ) );
+	Describe describe;
+	EXPECT_STREQ( "float", visit( IntFloatPtr( 2.5f ), describe ) );
+	EXPECT_STREQ( "ptr", visit( IntFloatPtr( std::make_shared<Int32>( 7 ) ), describe ) );
+}
+
+TEST( SumTest, FnCopyMoveDestroy )
+{
+	auto p = std::make_shared<Int32>( 7 );
+	{
+		const IntFloatPtr a( p );
+		EXPECT_EQ( 2, p.use_count( ) );
+		const IntFloatPtr copy( a );
+		EXPECT_EQ( 3, p.use_count( ) );
+		IntFloatPtr b( p );
+		const IntFloatPtr moved( std::move( b ) );
+		// payload is moved, not its bytes
+		EXPECT_EQ( 4, p.use_count( ) );
+		EXPECT_EQ( nullptr, b.get<std::shared_ptr<Int32>>( ) );
+		EXPECT_EQ( 7, toInt( moved ) );
+	}
+	EXPECT_EQ( 1, p.use_count( ) );
+}
+
+TEST( SumTest, FnCopyAssign )
+{
+	auto p = std::make_shared<Int32>( 7 );
+	{
+		IntFloatPtr a( 3 );
+		const IntFloatPtr ptr( p );
+		a = ptr;
+		EXPECT_TRUE( a.is<std::shared_ptr<Int32>>( ) );
+		EXPECT_EQ( 3, p.use_count( ) );
+		EXPECT_EQ( 7, toInt( a ) );
+		a = IntFloatPtr( 2.5f );
+		EXPECT_TRUE( a.is<float>( ) );
+		EXPECT_EQ( 2, p.use_count( ) );
+		a = ptr;
+		const IntFloatPtr& self = a;
+		a = self;
+		EXPECT_EQ( 3, p.use_count( ) );
+		EXPECT_EQ( 7, toInt( a ) );
+	}
+	EXPECT_EQ( 1, p.use_count( ) );
+}
+
+TEST( SumTest, FnMoveAssign )
+{
+	auto p = std::make_shared<Int32>( 7 );
+	{
+		IntFloatPtr a( 2.5f );
+		IntFloatPtr b( p );
+		a = std::move( b );
+		EXPECT_TRUE( a.is<std::shared_ptr<Int32>>( ) );
+		// payload is moved, not its bytes
+		EXPECT_EQ( 2, p.use_count( ) );
+		EXPECT_EQ( nullptr, b.get<std::shared_ptr<Int32>>( ) );
+		a = IntFloatPtr( 3 );
+		EXPECT_EQ( 1, p.use_count( ) );
+		EXPECT_EQ( 3, toInt( a ) );
+		b = IntFloatPtr( p );
+		a = std::move( b );
+		a = std::move( a );
+		EXPECT_EQ( 7, toInt( a ) );
+	}
+	EXPECT_EQ( 1, p.use_count( ) );
+}
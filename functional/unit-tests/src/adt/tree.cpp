@@ -0,0 +1,100 @@
+#include <pch/pch.hpp>
+#include <vector>
+#include <adt/tree.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	// 1 with children 2, 3 and 4, 2 with children 5 and 6, 4 with child 7
+	Tree<Int32> sample( )
+	{
+		return Tree<Int32>( 1, {
+			Tree<Int32>( 2, { Tree<Int32>( 5 ), Tree<Int32>( 6 ) } ),
+			Tree<Int32>( 3 ),
+			Tree<Int32>( 4, { Tree<Int32>( 7 ) } ) } );
+	}
+	std::vector<Int32> values( const Tree<Int32>& t )
+	{
+		std::vector<Int32> vals;
+		t.forEach( [&vals]( const Int32& a )
+		{
+			vals.push_back( a );
+		} );
+		return vals;
+	}
+}
+
+TEST( TreeTest, FnBuild )
+{
+	const Tree<Int32> empty;
+	EXPECT_TRUE( empty.isEmpty( ) );
+	EXPECT_EQ( 0, empty.size( ) );
+	const auto t = sample( );
+	EXPECT_EQ( 7, t.size( ) );
+	EXPECT_EQ( 1, t.value( ) );
+	EXPECT_EQ( 3, t.childCount( ) );
+	EXPECT_EQ( 3, t.child( 0 ).size( ) );
+	EXPECT_EQ( 6, t.at( { 0, 1 } ) );
+	EXPECT_EQ( 7, t.at( { 2, 0 } ) );
+}
+
+TEST( TreeTest, FnForEachBreadthFirst )
+{
+	EXPECT_EQ( std::vector<Int32>( { 1, 2, 3, 4, 5, 6, 7 } ), values( sample( ) ) );
+}
+
+TEST( TreeTest, FnUpdate )
+{
+	const auto t = sample( );
+	const auto u = t.update( { 0, 1 }, 60 ).modify( { }, []( const Int32& a )
+	{
+		return a * 10;
+	} );
+	EXPECT_EQ( std::vector<Int32>( { 10, 2, 3, 4, 5, 60, 7 } ), values( u ) );
+	EXPECT_EQ( std::vector<Int32>( { 1, 2, 3, 4, 5, 6, 7 } ), values( t ) );
+	// subtrees off the path are shared
+	EXPECT_EQ( &t.child( 2 ).value( ), &u.child( 2 ).value( ) );
+	EXPECT_EQ( &t.at( { 0, 0 } ), &u.at( { 0, 0 } ) );
+	EXPECT_NE( &t.at( { 0, 1 } ), &u.at( { 0, 1 } ) );
+}
+
+TEST( TreeTest, FnAddRemoveChild )
+{
+	const auto t = sample( );
+	const auto added = t.addChild( { 1 }, Tree<Int32>( 8, { Tree<Int32>( 9 ) } ) );
+	EXPECT_EQ( 9, added.size( ) );
+	EXPECT_EQ( std::vector<Int32>( { 1, 2, 3, 4, 5, 6, 8, 7, 9 } ), values( added ) );
+	const auto removed = added.removeChild( { }, 0 );
+	EXPECT_EQ( 6, removed.size( ) );
+	EXPECT_EQ( std::vector<Int32>( { 1, 3, 4, 8, 7, 9 } ), values( removed ) );
+	EXPECT_EQ( 7, t.size( ) );
+}
+
+TEST( TreeTest, FnWideTree )
+{
+	Tree<Int32> t( 0 );
+	for ( Int32 i = 1; i <= 100; ++i )
+	{
+		t = t.addChild( { }, Tree<Int32>( i ) );
+	}
+	t = t.update( { 70 }, -71 );
+	EXPECT_EQ( 101, t.size( ) );
+	EXPECT_EQ( -71, t.at( { 70 } ) );
+	EXPECT_EQ( 100, t.at( { 99 } ) );
+	EXPECT_EQ( 5050 - 142, foldl( []( const Int32 acc, const Int32& a )
+	{
+		return acc + a;
+	}, 0, t ) );
+}
+
+TEST( TreeTest, FnFmap )
+{
+	const auto t = fmap( []( const Int32& a )
+	{
+		return a * 0.5f;
+	}, sample( ) );
+	EXPECT_EQ( 7, t.size( ) );
+	EXPECT_FLOAT_EQ( 3.0f, t.at( { 0, 1 } ) );
+	EXPECT_FLOAT_EQ( 3.5f, t.at( { 2, 0 } ) );
+}
@@ -0,0 +1,129 @@
+#include <pch/pch.hpp>
+#include <random>
+#include <vector>
+#include <adt/vector.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	Vector<Int32> range( const Int32 from, const Int32 count )
+	{
+		Vector<Int32> v;
+		for ( Int32 i = 0; i < count; ++i )
+		{
+			v = v.pushBack( from + i );
+		}
+		return v;
+	}
+	void expectEq( const std::vector<Int32>& expected, const Vector<Int32>& v )
+	{
+		ASSERT_EQ( expected.size( ), v.size( ) );
+		for ( UInt32 i = 0; i < v.size( ); ++i )
+		{
+			ASSERT_EQ( expected[i], v[i] );
+		}
+		UInt32 i = 0;
+		v.forEach( [&expected, &i]( const Int32& a )
+		{
+			EXPECT_EQ( expected[i++], a );
+		} );
+		EXPECT_EQ( v.size( ), i );
+		// a slice crossing leaves
+		const UInt32 first = v.size( ) / 3;
+		i = first;
+		v.forEach( first, v.size( ) - first, [&expected, &i]( const Int32& a )
+		{
+			EXPECT_EQ( expected[i++], a );
+		} );
+		EXPECT_EQ( v.size( ) - first, i );
+	}
+}
+
+TEST( VectorTest, FnPushBackUpdate )
+{
+	std::vector<Int32> expected;
+	Vector<Int32> v;
+	for ( Int32 i = 0; i < 40000; ++i )
+	{
+		expected.push_back( i );
+		v = v.pushBack( i );
+	}
+	expectEq( expected, v );
+	const Vector<Int32> old = v;
+	for ( UInt32 i = 0; i < expected.size( ); i += 97 )
+	{
+		expected[i] = -expected[i];
+		v = v.update( i, expected[i] );
+	}
+	expectEq( expected, v );
+	// original is not changed
+	EXPECT_EQ( 97, old[97] );
+	expectEq( std::vector<Int32>{ 1, 2, 3 }, Vector<Int32>{ 1, 2, 3 } );
+	expectEq( std::vector<Int32>( expected.begin( ), expected.end( ) ),
+		Vector<Int32>( expected.begin( ), expected.end( ) ) );
+}
+
+TEST( VectorTest, FnConcat )
+{
+	std::mt19937 random( 7 );
+	const Int32 sizes[] = { 0, 1, 31, 32, 33, 100, 1024, 1057, 33000 };
+	for ( const auto a : sizes )
+	{
+		for ( const auto b : sizes )
+		{
+			std::vector<Int32> expected;
+			for ( Int32 i = 0; i < a + b; ++i )
+			{
+				expected.push_back( i );
+			}
+			const Vector<Int32> v = concat( range( 0, a ), range( a, b ) );
+			expectEq( expected, v );
+			// relaxed tree keeps working with push and update
+			const Vector<Int32> pushed = v.pushBack( a + b ).pushBack( a + b + 1 );
+			expected.push_back( a + b );
+			expected.push_back( a + b + 1 );
+			expectEq( expected, pushed );
+			const UInt32 i = random( ) % expected.size( );
+			expected[i] = -1;
+			expectEq( expected, pushed.update( i, -1 ) );
+		}
+	}
+	// repeated concatenation of uneven parts
+	std::vector<Int32> expected;
+	Vector<Int32> v;
+	for ( Int32 i = 0; i < 300; ++i )
+	{
+		const Int32 count = random( ) % 200;
+		v = concat( v, range( static_cast<Int32>( expected.size( ) ), count ) );
+		for ( Int32 j = 0; j < count; ++j )
+		{
+			expected.push_back( static_cast<Int32>( expected.size( ) ) );
+		}
+	}
+	expectEq( expected, v );
+}
+
+TEST( VectorTest, FnFmapFilterFold )
+{
+	const Vector<Int32> v = range( 0, 1000 );
+	const auto doubled = fmap( []( const Int32& a )
+	{
+		return a * 2;
+	}, v );
+	EXPECT_EQ( 1998, doubled[999] );
+	const auto even = filter( []( const Int32& a )
+	{
+		return a % 2 == 0;
+	}, v );
+	EXPECT_EQ( 500, even.size( ) );
+	EXPECT_EQ( 998, even[499] );
+	EXPECT_EQ( 499500, foldl( []( const Int32 acc, const Int32& a )
+	{
+		return acc + a;
+	}, 0, v ) );
+	EXPECT_EQ( 321, foldr( []( const Int32& a, const Int32 acc )
+	{
+		return acc * 10 + a;
+	}, 0, range( 1, 3 ) ) );
+}
@@ -0,0 +1,141 @@
+#include <pch/pch.hpp>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <math/mat4x4.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	// cofactor inverse the SIMD kernels replaced
+	Mat4x4 referenceInverse( const Mat4x4& mat )
+	{
+		Mat4x4 invMat;
+		FVec4 vec[3];
+		const float det = determinant( mat );
+		for ( int i = 0; i < 4; ++i )
+		{
+			for ( int j = 0; j < 4; ++j )
+			{
+				if ( i != j )
+				{
+					const int a = ( j <= i ) ? j : j - 1;
+					vec[a] = FVec4( mat.m[j][0], mat.m[j][1], mat.m[j][2], mat.m[j][3] );
+				}
+			}
+			const FVec4 x = cross( vec[0], vec[1], vec[2] );
+			const float cofactors[] = { x.x, x.y, x.z, x.w };
+			for ( int j = 0; j < 4; ++j )
+			{
+				invMat.m[j][i] = ( i % 2 == 0 ? 1.0f : -1.0f ) * cofactors[j] / det;
+			}
+		}
+		return invMat;
+	}
+	void expectNear( const Mat4x4& expected, const Mat4x4& actual, const float tolerance )
+	{
+		for ( int i = 0; i < 4; ++i )
+		{
+			for ( int j = 0; j < 4; ++j )
+			{
+				EXPECT_NEAR( expected.m[i][j], actual.m[i][j],
+					tolerance * std::max( 1.0f, std::fabs( expected.m[i][j] ) ) ) << i << j;
+			}
+		}
+	}
+	// distance of two floats in units in the last place, 0 and -0 are equal
+	Int32 ulps( const float a, const float b )
+	{
+		Int32 ia, ib;
+		memcpy( &ia, &a, sizeof( float ) );
+		memcpy( &ib, &b, sizeof( float ) );
+		// ordered like the floats they represent
+		ia = ia < 0 ? INT32_MIN - ia : ia;
+		ib = ib < 0 ? INT32_MIN - ib : ib;
+		return std::abs( ia - ib );
+	}
+	void expectUlps( const Mat4x4& expected, const Mat4x4& actual, const Int32 maxUlps )
+	{
+		for ( int i = 0; i < 4; ++i )
+		{
+			for ( int j = 0; j < 4; ++j )
+			{
+				EXPECT_LE( ulps( expected.m[i][j], actual.m[i][j] ), maxUlps ) << i << j;
+			}
+		}
+	}
+	FQuat normalized( const FQuat& q )
+	{
+		const float len = sqrtf( q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w );
+		return FQuat( q.x / len, q.y / len, q.z / len, q.w / len );
+	}
+	const FQuat rot = normalized( FQuat( 0.3f, -0.5f, 0.1f, 0.8f ) );
+	const FQuat parentRot = normalized( FQuat( -0.2f, 0.4f, 0.7f, 0.5f ) );
+	const FVec3 scl{ 1.5f, 0.5f, 2.0f };
+	const FVec3 position{ 10.0f, -3.0f, 25.0f };
+	const Mat4x4 parent = rotSclPosToMat4x4( parentRot, FVec3{ 2.0f, 2.0f, 2.0f },
+		FVec3{ -4.0f, 1.0f, 8.0f } );
+	const Mat4x4 general( 2.0f, 0.5f, -1.0f, 0.25f, 1.0f, 3.0f, 0.5f, -0.5f,
+		-0.5f, 1.0f, 4.0f, 0.75f, 3.0f, -2.0f, 1.0f, 1.5f );
+	// the kernels reorder the cofactor sums, 4 ulps like EXPECT_FLOAT_EQ
+	const Int32 inverseUlps = 4;
+	// the translation row cancels in dot products with the 3x3 inverse
+	const Int32 affineUlps = 16;
+	// absolute, ulps mean nothing around the zeros of the identity
+	const float identityTolerance = 1e-5f;
+}
+
+TEST( Mat4x4Test, OpMultiply )
+{
+	const Mat4x4 a = rotSclPosToMat4x4( rot, scl, position );
+	const Mat4x4 expected = mulScalar( a, parent );
+	const Mat4x4 actual = mul( a, parent );
+	for ( int i = 0; i < 4; ++i )
+	{
+		for ( int j = 0; j < 4; ++j )
+		{
+			EXPECT_FLOAT_EQ( expected.m[i][j], actual.m[i][j] );
+		}
+	}
+	expectNear( expected, a * parent, 0.0f );
+	expectNear( general, general * Mat4x4::identity, 0.0f );
+	expectNear( general, Mat4x4::identity * general, 0.0f );
+}
+
+TEST( Mat4x4Test, FnInverse )
+{
+	const Mat4x4 trs = rotSclPosToMat4x4( rot, scl, position ) * parent;
+	for ( const auto& mat : { general, trs, parent } )
+	{
+		expectUlps( referenceInverse( mat ), inverse( mat ), inverseUlps );
+		expectUlps( referenceInverse( mat ), inverseScalar( mat ), inverseUlps );
+		expectNear( Mat4x4::identity, mat * inverse( mat ), identityTolerance );
+	}
+}
+
+TEST( Mat4x4Test, FnAffineInverse )
+{
+	const Mat4x4 trs = rotSclPosToMat4x4( rot, scl, position ) * parent;
+	for ( const auto& mat : { trs, parent, posToMat4x4( position ) } )
+	{
+		expectUlps( referenceInverse( mat ), affineInverse( mat ), affineUlps );
+		expectUlps( referenceInverse( mat ), affineInverseScalar( mat ), affineUlps );
+	}
+}
+
+TEST( Mat4x4Test, FnRotSclPosToMat4x4Parent )
+{
+	const Mat4x4 expected = rotSclPosToMat4x4( rot, scl, position ) * parent;
+	for ( const auto& mat : { rotSclPosToMat4x4( rot, scl, position, parent ),
+		rotSclPosToMat4x4Scalar( rot, scl, position, parent ) } )
+	{
+		for ( int i = 0; i < 4; ++i )
+		{
+			for ( int j = 0; j < 4; ++j )
+			{
+				EXPECT_FLOAT_EQ( expected.m[i][j], mat.m[i][j] );
+			}
+		}
+	}
+}
@@ -1,4 +1,7 @@
 #include <pch/pch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 #include <math/quat.hpp>
 #include <gtest/gtest.h>
 using namespace hp_fp;
@@ -47,3 +50,125 @@ TEST( QuatTest, FnEulerRadToQuat )
 		sin( a.y / 2.0f ) * sin( a.x / 2.0f ) * sin( a.z / 2.0f ),
 		eulerRadToQuat( a ).w );
 }
+
+namespace
+{
+	// two quaternion products, as rotate computed them before
+	FVec3 referenceRotate( const FVec3& vec, const FQuat& quat )
+	{
+		const FQuat rotated = conjugate( quat ) * FQuat{ vec.x, vec.y, vec.z, 0.0f } * quat;
+		return FVec3{ rotated.x, rotated.y, rotated.z };
+	}
+	std::vector<FVec3> angles( const UInt32 count )
+	{
+		std::vector<FVec3> euler( count );
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			euler[i] = FVec3{ 0.37f * i - 20.0f, -0.11f * i, 0.05f * i * i - 3.0f };
+		}
+		return euler;
+	}
+}
+
+TEST( QuatTest, FnRotate )
+{
+	const auto euler = angles( 50 );
+	for ( const auto& e : euler )
+	{
+		const FQuat q = eulerRadToQuat( e );
+		const FVec3 v{ e.z, 1.0f, -0.5f * e.x };
+		const FVec3 expected = referenceRotate( v, q );
+		const FVec3 actual = rotate( v, q );
+		EXPECT_NEAR( expected.x, actual.x, 1e-4f );
+		EXPECT_NEAR( expected.y, actual.y, 1e-4f );
+		EXPECT_NEAR( expected.z, actual.z, 1e-4f );
+	}
+	const FVec3 x = rotate( FVec3{ 1.0f, 0.0f, 0.0f }, eulerRadToQuat( FVec3{ 0.0f, PI_F / 2.0f,
+		0.0f } ) );
+	EXPECT_NEAR( 0.0f, x.x, 1e-6f );
+	EXPECT_NEAR( 0.0f, x.y, 1e-6f );
+	EXPECT_NEAR( -1.0f, x.z, 1e-6f );
+}
+
+TEST( QuatTest, FnRotateArray )
+{
+	const auto euler = angles( 23 );
+	std::vector<FVec3> vecs;
+	std::vector<FQuat> quats;
+	for ( const auto& e : euler )
+	{
+		vecs.push_back( FVec3{ e.y, e.z, e.x } );
+		quats.push_back( eulerRadToQuat( e ) );
+	}
+	std::vector<FVec3> rotated( vecs.size( ) );
+	rotate_IO( vecs.data( ), quats.data( ), static_cast<UInt32>( vecs.size( ) ), rotated.data( ) );
+	for ( UInt32 i = 0; i < vecs.size( ); ++i )
+	{
+		EXPECT_EQ( rotate( vecs[i], quats[i] ), rotated[i] );
+	}
+}
+
+TEST( QuatTest, FnEulerRadToQuatArray )
+{
+	const auto euler = angles( 150 );
+	std::vector<FQuat> precise( euler.size( ) );
+	std::vector<FQuat> fast( euler.size( ) );
+	const UInt32 count = static_cast<UInt32>( euler.size( ) );
+	eulerRadToQuat_IO( euler.data( ), count, precise.data( ), TrigAccuracy::Precise );
+	eulerRadToQuat_IO( euler.data( ), count, fast.data( ), TrigAccuracy::Fast );
+	for ( UInt32 i = 0; i < count; ++i )
+	{
+		const FQuat expected = eulerRadToQuat( euler[i] );
+		EXPECT_NEAR( expected.x, precise[i].x, 1e-5f );
+		EXPECT_NEAR( expected.y, precise[i].y, 1e-5f );
+		EXPECT_NEAR( expected.z, precise[i].z, 1e-5f );
+		EXPECT_NEAR( expected.w, precise[i].w, 1e-5f );
+		EXPECT_NEAR( expected.x, fast[i].x, 2e-4f );
+		EXPECT_NEAR( expected.y, fast[i].y, 2e-4f );
+		EXPECT_NEAR( expected.z, fast[i].z, 2e-4f );
+		EXPECT_NEAR( expected.w, fast[i].w, 2e-4f );
+	}
+}
+
+namespace
+{
+	float angleBetween( const FQuat& a, const FQuat& b )
+	{
+		return 2.0f * acosf( std::min( fabsf( dot( a, b ) ), 1.0f ) );
+	}
+}
+
+TEST( QuatTest, FnNlerp )
+{
+	const FQuat a = eulerRadToQuat( FVec3{ 0.0f, 0.2f, 0.0f } );
+	const FQuat b = eulerRadToQuat( FVec3{ 0.1f, 0.5f, -0.1f } );
+	const FQuat half = nlerp( a, b, 0.5f );
+	EXPECT_NEAR( 1.0f, dot( half, half ), 1e-6f );
+	EXPECT_NEAR( angleBetween( a, half ), angleBetween( half, b ), 1e-3f );
+	EXPECT_NEAR( 0.0f, angleBetween( a, nlerp( a, b, 0.0f ) ), 1e-3f );
+	EXPECT_NEAR( 0.0f, angleBetween( b, nlerp( a, b, 1.0f ) ), 1e-3f );
+	// -b is the same rotation, nlerp takes the shorter arc either way
+	const FQuat negB( -b.x, -b.y, -b.z, -b.w );
+	EXPECT_NEAR( 0.0f, angleBetween( half, nlerp( a, negB, 0.5f ) ), 1e-3f );
+}
+
+TEST( QuatTest, FnSlerp )
+{
+	const FQuat a = FQuat::identity;
+	const FQuat b = eulerRadToQuat( FVec3{ 0.0f, 2.0f, 0.0f } );
+	for ( UInt32 i = 0; i <= 10; ++i )
+	{
+		const float t = i / 10.0f;
+		const FQuat q = slerp( a, b, t );
+		EXPECT_NEAR( 1.0f, dot( q, q ), 1e-5f );
+		// constant angular speed
+		EXPECT_NEAR( 2.0f * t, angleBetween( a, q ), 1e-3f );
+	}
+	const FQuat negB( -b.x, -b.y, -b.z, -b.w );
+	EXPECT_NEAR( 0.0f, angleBetween( slerp( a, b, 0.3f ), slerp( a, negB, 0.3f ) ), 1e-3f );
+	// nearly parallel, falls back to nlerp
+	const FQuat c = eulerRadToQuat( FVec3{ 0.0f, 0.01f, 0.0f } );
+	const FQuat q = slerp( a, c, 0.5f );
+	EXPECT_NEAR( 1.0f, dot( q, q ), 1e-6f );
+	EXPECT_NEAR( 0.005f, angleBetween( a, q ), 1e-3f );
+}
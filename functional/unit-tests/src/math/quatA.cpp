@@ -0,0 +1,57 @@
+#include <pch/pch.hpp>
+#include <type_traits>
+#include <math/quatA.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	void expectNear( const FQuat& expected, const FQuat& actual )
+	{
+		EXPECT_NEAR( expected.x, actual.x, 1e-5f );
+		EXPECT_NEAR( expected.y, actual.y, 1e-5f );
+		EXPECT_NEAR( expected.z, actual.z, 1e-5f );
+		EXPECT_NEAR( expected.w, actual.w, 1e-5f );
+	}
+}
+
+TEST( QuatATest, Layout )
+{
+	EXPECT_EQ( 16u, sizeof( FQuatA ) );
+	EXPECT_EQ( 16u, std::alignment_of<FQuatA>::value );
+}
+
+TEST( QuatATest, FnLoadStore )
+{
+	FQuat a( 0.1f, -0.2f, 0.3f, 0.9f );
+	FQuat b = storeQuat( load( a ) );
+	EXPECT_EQ( a.x, b.x );
+	EXPECT_EQ( a.y, b.y );
+	EXPECT_EQ( a.z, b.z );
+	EXPECT_EQ( a.w, b.w );
+}
+
+TEST( QuatATest, OpMultiply )
+{
+	FQuat a( 0.1f, -0.2f, 0.3f, 0.9f );
+	FQuat b( -0.5f, 0.4f, 0.7f, -0.3f );
+	expectNear( a * b, storeQuat( load( a ) * load( b ) ) );
+	expectNear( b * a, storeQuat( load( b ) * load( a ) ) );
+	expectNear( a, storeQuat( load( a ) * load( FQuat::identity ) ) );
+}
+
+TEST( QuatATest, FnConjugate )
+{
+	FQuat a( 0.1f, -0.2f, 0.3f, 0.9f );
+	expectNear( conjugate( a ), storeQuat( conjugate( load( a ) ) ) );
+}
+
+TEST( QuatATest, FnDotLengthNormalize )
+{
+	FQuatA a = quatA( 1.0f, -2.0f, 2.0f, 4.0f );
+	EXPECT_FLOAT_EQ( 25.0f, dot( a, a ) );
+	EXPECT_FLOAT_EQ( 5.0f, length( a ) );
+	expectNear( FQuat( 0.2f, -0.4f, 0.4f, 0.8f ), storeQuat( normalize( a ) ) );
+	expectNear( FQuat( 0.0f, 0.0f, 0.0f, 0.0f ),
+		storeQuat( normalize( quatA( 0.0f, 0.0f, 0.0f, 0.0f ) ) ) );
+}
@@ -0,0 +1,77 @@
+#include <pch/pch.hpp>
+#include <cmath>
+#include <vector>
+#include <math/transformBatch.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	FQuat rotAt( const UInt32 i )
+	{
+		const float a = 0.37f * i;
+		const FQuat q( sinf( a ), 0.5f, 0.3f * cosf( a ), 1.0f );
+		const float len = sqrtf( q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w );
+		return FQuat( q.x / len, q.y / len, q.z / len, q.w / len );
+	}
+	FVec3 posAt( const UInt32 i )
+	{
+		return FVec3{ 0.5f * i, -0.25f * i, 1.0f + i };
+	}
+	FVec3 sclAt( const UInt32 i )
+	{
+		return FVec3{ 1.0f + 0.1f * ( i % 3 ), 1.0f, 2.0f - 0.1f * ( i % 5 ) };
+	}
+	// world matrices computed node by node from the parent's world matrix
+	std::vector<Mat4x4> expected( const std::vector<UInt32>& parents )
+	{
+		std::vector<Mat4x4> world;
+		for ( UInt32 i = 0; i < parents.size( ); ++i )
+		{
+			world.push_back( rotSclPosToMat4x4( rotAt( i ), sclAt( i ), posAt( i ),
+				parents[i] == NO_PARENT ? Mat4x4::identity : world[parents[i]] ) );
+		}
+		return world;
+	}
+	void expectWorld( const std::vector<UInt32>& parents )
+	{
+		TransformBatch batch;
+		for ( UInt32 i = 0; i < parents.size( ); ++i )
+		{
+			EXPECT_EQ( i, push_IO( batch, posAt( i ), rotAt( i ), sclAt( i ), parents[i] ) );
+		}
+		const auto ex = expected( parents );
+		std::vector<Mat4x4> world( parents.size( ) );
+		std::vector<Mat4x4> worldScalar( parents.size( ) );
+		worldTransforms_IO( batch, world.data( ) );
+		worldTransformsScalar_IO( batch, worldScalar.data( ) );
+		for ( UInt32 n = 0; n < parents.size( ); ++n )
+		{
+			for ( int i = 0; i < 4; ++i )
+			{
+				for ( int j = 0; j < 4; ++j )
+				{
+					EXPECT_FLOAT_EQ( ex[n].m[i][j], world[n].m[i][j] ) << n;
+					EXPECT_FLOAT_EQ( ex[n].m[i][j], worldScalar[n].m[i][j] ) << n;
+				}
+			}
+		}
+	}
+}
+
+TEST( TransformBatchTest, FnRoots )
+{
+	expectWorld( std::vector<UInt32>( 11, NO_PARENT ) );
+}
+
+TEST( TransformBatchTest, FnLevels )
+{
+	// 3 roots, 2 children each, 1 grandchild each, stored level by level
+	expectWorld( { NO_PARENT, NO_PARENT, NO_PARENT, 0, 0, 1, 1, 2, 2, 3, 4, 5, 6, 7, 8 } );
+}
+
+TEST( TransformBatchTest, FnParentsInGroup )
+{
+	// depth first, parents are often in the same group of four
+	expectWorld( { NO_PARENT, 0, 1, 1, 0, 4, NO_PARENT, 6, 7, 8, 9 } );
+}
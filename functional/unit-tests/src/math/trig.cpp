@@ -0,0 +1,62 @@
+#include <pch/pch.hpp>
+#include <cmath>
+#include <vector>
+#include <math/trig.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	// max absolute error of sinCos_IO over [-range, range]
+	float maxError( const TrigAccuracy accuracy, const float range )
+	{
+		const UInt32 count = 100003;
+		std::vector<float> rad( count ), s( count ), c( count );
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			rad[i] = -range + 2.0f * range * i / ( count - 1 );
+		}
+		sinCos_IO( rad.data( ), count, s.data( ), c.data( ), accuracy );
+		double error = 0.0;
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			error = std::max( error, fabs( s[i] - sin( static_cast<double>( rad[i] ) ) ) );
+			error = std::max( error, fabs( c[i] - cos( static_cast<double>( rad[i] ) ) ) );
+		}
+		return static_cast<float>( error );
+	}
+}
+
+TEST( TrigTest, FnSinCos )
+{
+	float s, c;
+	sinCos( 0.5f, s, c );
+	EXPECT_FLOAT_EQ( sinf( 0.5f ), s );
+	EXPECT_FLOAT_EQ( cosf( 0.5f ), c );
+}
+
+TEST( TrigTest, FnSinCosArrayPrecise )
+{
+	EXPECT_GT( 2e-7f, maxError( TrigAccuracy::Precise, 2.0f * PI_F ) );
+	EXPECT_GT( 2e-7f, maxError( TrigAccuracy::Precise, 100.0f ) );
+}
+
+TEST( TrigTest, FnSinCosArrayFast )
+{
+	EXPECT_GT( 4e-5f, maxError( TrigAccuracy::Fast, 2.0f * PI_F ) );
+	EXPECT_GT( 4e-5f, maxError( TrigAccuracy::Fast, 100.0f ) );
+}
+
+TEST( TrigTest, FnSinCosArrayQuadrants )
+{
+	const float rad[] = { 0.0f, PI_F / 2.0f, PI_F, -PI_F / 2.0f, 3.0f * PI_F / 2.0f, -0.0f };
+	float s[6], c[6];
+	sinCos_IO( rad, 6, s, c );
+	const float expectedS[] = { 0.0f, 1.0f, 0.0f, -1.0f, -1.0f, 0.0f };
+	const float expectedC[] = { 1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f };
+	for ( UInt32 i = 0; i < 6; ++i )
+	{
+		EXPECT_NEAR( expectedS[i], s[i], 1e-6f );
+		EXPECT_NEAR( expectedC[i], c[i], 1e-6f );
+	}
+}
@@ -92,4 +92,14 @@ TEST( Vec3Test, FnDot )
 	FVec3 a{ 1.0f, -1.0f, 0.5f };
 	FVec3 b{ 5.0f, -0.5f, -1.5f };
 	EXPECT_EQ( a.x * b.x + a.y * b.y + a.z * b.z, dot( a, b ) );
-}
\ No newline at end of file
+}
+TEST( Vec3Test, FnLerp )
+{
+	FVec3 a{ 1.0f, -1.0f, 0.5f };
+	FVec3 b{ 5.0f, -0.5f, -1.5f };
+	EXPECT_EQ( a, lerp( a, b, 0.0f ) );
+	EXPECT_EQ( b, lerp( a, b, 1.0f ) );
+	EXPECT_FLOAT_EQ( 2.0f, lerp( a, b, 0.25f ).x );
+	EXPECT_FLOAT_EQ( -0.875f, lerp( a, b, 0.25f ).y );
+	EXPECT_FLOAT_EQ( 0.0f, lerp( a, b, 0.25f ).z );
+}
@@ -0,0 +1,84 @@
+#include <pch/pch.hpp>
+#include <type_traits>
+#include <math/vec4A.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	void expectNear( const FVec3& expected, const FVec3& actual )
+	{
+		EXPECT_NEAR( expected.x, actual.x, 1e-5f );
+		EXPECT_NEAR( expected.y, actual.y, 1e-5f );
+		EXPECT_NEAR( expected.z, actual.z, 1e-5f );
+	}
+}
+
+TEST( Vec4ATest, Layout )
+{
+	EXPECT_EQ( 16u, sizeof( FVec4A ) );
+	EXPECT_EQ( 16u, std::alignment_of<FVec4A>::value );
+}
+
+TEST( Vec4ATest, FnLoadStore )
+{
+	FVec3 a{ 1.0f, -2.0f, 0.5f };
+	FVec4 b( 1.0f, -2.0f, 0.5f, 3.0f );
+	EXPECT_EQ( a, storeVec3( load( a ) ) );
+	EXPECT_EQ( 0.0f, get( load( a ), 3 ) );
+	FVec4 c = storeVec4( load( b ) );
+	EXPECT_EQ( b.x, c.x );
+	EXPECT_EQ( b.y, c.y );
+	EXPECT_EQ( b.z, c.z );
+	EXPECT_EQ( b.w, c.w );
+}
+
+TEST( Vec4ATest, OpPlusMinus )
+{
+	FVec3 a{ 1.0f, -1.0f, 0.5f };
+	FVec3 b{ -0.5f, 0.5f, -0.5f };
+	EXPECT_EQ( a + b, storeVec3( load( a ) + load( b ) ) );
+	EXPECT_EQ( a - b, storeVec3( load( a ) - load( b ) ) );
+	EXPECT_EQ( ( FVec3{ -1.0f, 1.0f, -0.5f } ), storeVec3( -load( a ) ) );
+}
+
+TEST( Vec4ATest, OpMultiplyDivide )
+{
+	FVec3 a{ 1.0f, -1.0f, 0.5f };
+	EXPECT_EQ( a * 3.0f, storeVec3( load( a ) * 3.0f ) );
+	EXPECT_EQ( 3.0f * a, storeVec3( 3.0f * load( a ) ) );
+	EXPECT_EQ( a / 4.0f, storeVec3( load( a ) / 4.0f ) );
+}
+
+TEST( Vec4ATest, OpEquals )
+{
+	EXPECT_EQ( true, vec4A( 1.0f, 2.0f, 3.0f ) == vec4A( 1.0f, 2.0f, 3.0f ) );
+	EXPECT_EQ( false, vec4A( 1.0f, 2.0f, 3.0f ) == vec4A( 1.0f, 2.0f, 3.0f, 1.0f ) );
+	EXPECT_EQ( false, vec4A( 1.0f, 2.0f, 3.0f ) == vec4A( 1.0f, 2.0f, -3.0f ) );
+}
+
+TEST( Vec4ATest, FnDotCross )
+{
+	FVec3 a{ 1.0f, -2.0f, 0.5f };
+	FVec3 b{ -0.5f, 3.0f, 2.0f };
+	EXPECT_FLOAT_EQ( dot( a, b ), dot( load( a ), load( b ) ) );
+	expectNear( cross( a, b ), storeVec3( cross( load( a ), load( b ) ) ) );
+	EXPECT_EQ( 0.0f, get( cross( load( a ), load( b ) ), 3 ) );
+}
+
+TEST( Vec4ATest, FnLengthNormalize )
+{
+	FVec3 a{ 3.0f, -4.0f, 12.0f };
+	EXPECT_FLOAT_EQ( length( a ), length( load( a ) ) );
+	EXPECT_FLOAT_EQ( mag( a ), mag( load( a ) ) );
+	expectNear( normalize( a ), storeVec3( normalize( load( a ) ) ) );
+	EXPECT_EQ( ( FVec3{ 0.0f, 0.0f, 0.0f } ),
+		storeVec3( normalize( vec4A( 0.0f, 0.0f, 0.0f ) ) ) );
+}
+
+TEST( Vec4ATest, FnClampMag )
+{
+	FVec3 a{ 3.0f, -4.0f, 12.0f };
+	expectNear( clampMag( a, 6.5f ), storeVec3( clampMag( load( a ), 6.5f ) ) );
+	EXPECT_EQ( a, storeVec3( clampMag( load( a ), 20.0f ) ) );
+}
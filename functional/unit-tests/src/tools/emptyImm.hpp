@@ -0,0 +1,34 @@
+#pragma once
+#include <utility>
+// Generated using tools/immutableStruct.hs:
+// gen "Empty" [] []
+namespace hp_fp
+{
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	struct EmptyImm
+	{
+		struct Builder;
+		EmptyImm( )
+		{ }
+		Builder builder( ) const &;
+		Builder builder( ) &&;
+	private:
+	};
+	// batches changes of several fields into one construction
+	struct EmptyImm::Builder
+	{
+		EmptyImm build( ) &&
+		{
+			return EmptyImm( );
+		}
+	};
+	inline EmptyImm::Builder EmptyImm::builder( ) const &
+	{
+		return Builder{ };
+	}
+	inline EmptyImm::Builder EmptyImm::builder( ) &&
+	{
+		return Builder{ };
+	}
+}
@@ -0,0 +1,77 @@
+#include <pch/pch.hpp>
+#include <gtest/gtest.h>
+// headers generated by tools/immutableStruct.hs, their rvalue setters are ref-qualified member
+// functions which VS2013 does not support
+#if !defined( _MSC_VER ) || _MSC_VER >= 1900
+namespace test
+{
+	UInt32 copies = 0;
+	// field counting its copies, moves are free
+	struct Copies
+	{
+		explicit Copies( const Int32 value ) : value( value )
+		{ }
+		Copies( const Copies& c ) : value( c.value )
+		{
+			++copies;
+		}
+		Copies( Copies&& c ) : value( c.value )
+		{ }
+		Copies& operator = ( const Copies& c )
+		{
+			value = c.value;
+			++copies;
+			return *this;
+		}
+		Copies& operator = ( Copies&& c )
+		{
+			value = c.value;
+			return *this;
+		}
+		Int32 value;
+	};
+}
+#include "pairImm.hpp"
+#include "emptyImm.hpp"
+using namespace hp_fp;
+using test::Copies;
+using test::copies;
+
+TEST( ImmutableStructTest, FnSetters )
+{
+	PairImm pair( Copies( 1 ), Copies( 2 ) );
+	copies = 0;
+	const PairImm changed = std::move( pair ).setFirst( Copies( 3 ) ).setSecond( Copies( 4 ) );
+	EXPECT_EQ( 0u, copies );
+	EXPECT_EQ( 3, changed.first( ).value );
+	EXPECT_EQ( 4, changed.second( ).value );
+	// only the field which does not change is copied
+	const PairImm copied = changed.setFirst( Copies( 5 ) );
+	EXPECT_EQ( 1u, copies );
+	EXPECT_EQ( 5, copied.first( ).value );
+	EXPECT_EQ( 4, copied.second( ).value );
+}
+
+TEST( ImmutableStructTest, FnBuilder )
+{
+	PairImm pair( Copies( 1 ), Copies( 2 ) );
+	copies = 0;
+	PairImm::Builder builder = std::move( pair ).builder( );
+	builder.first = Copies( 3 );
+	const PairImm built = std::move( builder ).build( );
+	EXPECT_EQ( 0u, copies );
+	EXPECT_EQ( 3, built.first( ).value );
+	EXPECT_EQ( 2, built.second( ).value );
+	PairImm::Builder copiedBuilder = built.builder( );
+	EXPECT_EQ( 2u, copies );
+	EXPECT_EQ( 3, std::move( copiedBuilder ).build( ).first( ).value );
+	EXPECT_EQ( 2u, copies );
+}
+
+TEST( ImmutableStructTest, FnNoFields )
+{
+	const EmptyImm empty;
+	empty.builder( ).build( ).builder( );
+	EXPECT_TRUE( std::is_empty<EmptyImm>::value );
+}
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+#include <utility>
+// Generated using tools/immutableStruct.hs:
+// gen "Pair" [("test::Copies", "first"), ("test::Copies", "second")] []
+namespace hp_fp
+{
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	struct PairImm
+	{
+		struct Builder;
+		PairImm( test::Copies first, test::Copies second )
+			: _first( std::move( first ) ), _second( std::move( second ) )
+		{ }
+		const test::Copies& first( ) const
+		{
+			return _first;
+		}
+		const test::Copies& second( ) const
+		{
+			return _second;
+		}
+		PairImm setFirst( test::Copies f ) const &
+		{
+			return PairImm( std::move( f ), _second );
+		}
+		// moves the other fields out of this
+		PairImm setFirst( test::Copies f ) &&
+		{
+			return PairImm( std::move( f ), std::move( _second ) );
+		}
+		PairImm setSecond( test::Copies s ) const &
+		{
+			return PairImm( _first, std::move( s ) );
+		}
+		// moves the other fields out of this
+		PairImm setSecond( test::Copies s ) &&
+		{
+			return PairImm( std::move( _first ), std::move( s ) );
+		}
+		Builder builder( ) const &;
+		Builder builder( ) &&;
+	private:
+		test::Copies _first;
+		test::Copies _second;
+	};
+	// batches changes of several fields into one construction
+	struct PairImm::Builder
+	{
+		test::Copies first;
+		test::Copies second;
+		PairImm build( ) &&
+		{
+			return PairImm( std::move( first ), std::move( second ) );
+		}
+	};
+	inline PairImm::Builder PairImm::builder( ) const &
+	{
+		return Builder{ _first, _second };
+	}
+	inline PairImm::Builder PairImm::builder( ) &&
+	{
+		return Builder{ std::move( _first ), std::move( _second ) };
+	}
+}
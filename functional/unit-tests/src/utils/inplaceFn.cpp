@@ -0,0 +1,106 @@
+#include <pch/pch.hpp>
+#include <utils/inplaceFn.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	// counts live copies of a closure
+	struct Counted
+	{
+		Counted( Int32* alive ) : alive( alive )
+		{
+			++*alive;
+		}
+		Counted( const Counted& c ) : alive( c.alive )
+		{
+			++*alive;
+		}
+		~Counted( )
+		{
+			--*alive;
+		}
+		Int32* alive;
+	};
+}
+
+TEST( InplaceFnTest, FnInvoke )
+{
+	const float b = 2.0f;
+	InplaceFn<float( const float )> f = [b]( const float a )
+	{
+		return a * b;
+	};
+	EXPECT_EQ( 6.0f, f( 3.0f ) );
+	UInt32 calls = 0;
+	InplaceFn<UInt32( )> g = [calls]( ) mutable
+	{
+		return ++calls;
+	};
+	g( );
+	EXPECT_EQ( 2, g( ) );
+	EXPECT_FALSE( InplaceFn<void( )>( ) );
+}
+
+TEST( InplaceFnTest, FnCopyAssignDestroy )
+{
+	Int32 alive = 0;
+	{
+		const Counted counted( &alive );
+		InplaceFn<Int32( )> f = [counted]( )
+		{
+			return *counted.alive;
+		};
+		EXPECT_EQ( 2, alive );
+		InplaceFn<Int32( )> g = f;
+		EXPECT_EQ( 3, alive );
+		g = [] { return -1; };
+		EXPECT_EQ( 2, alive );
+		EXPECT_EQ( -1, g( ) );
+		g = std::move( f );
+		EXPECT_EQ( 3, g( ) );
+	}
+	EXPECT_EQ( 0, alive );
+}
+
+TEST( InplaceFnTest, FnSharedCopies )
+{
+	Int32 alive = 0;
+	{
+		const Counted counted( &alive );
+		const SharedFn<Int32( )> f = [counted]( )
+		{
+			return *counted.alive;
+		};
+		const SharedFn<Int32( )> g = f;
+		EXPECT_EQ( 2, alive );
+		EXPECT_EQ( f.fn, g.fn );
+		EXPECT_EQ( 2, g( ) );
+	}
+	EXPECT_EQ( 0, alive );
+}
+
+TEST( InplaceFnTest, FnSharedMutableClosure )
+{
+	UInt32 calls = 0;
+	const SharedFn<UInt32( )> f = [calls]( ) mutable
+	{
+		return ++calls;
+	};
+	const SharedFn<UInt32( )> g = f;
+	f( );
+	EXPECT_EQ( 2, g( ) );
+}
+
+TEST( InplaceFnTest, FnIsCallable )
+{
+	const auto twice = []( const float a )
+	{
+		return a * 2.0f;
+	};
+	EXPECT_TRUE( ( IsCallable<decltype( twice ), float( const float )>::value ) );
+	EXPECT_TRUE( ( IsCallable<decltype( twice ), double( const float )>::value ) );
+	EXPECT_FALSE( ( IsCallable<decltype( twice ), float( )>::value ) );
+	EXPECT_FALSE( ( IsCallable<decltype( twice ), std::shared_ptr<int>( const float )>::value ) );
+	EXPECT_FALSE( ( IsCallable<float, float( const float )>::value ) );
+}
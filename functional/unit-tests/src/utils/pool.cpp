@@ -0,0 +1,198 @@
+#include <pch/pch.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <adt/list.hpp>
+#include <adt/vector.hpp>
+#include <utils/pool.hpp>
+#include <utils/refPtr.hpp>
+#include <gtest/gtest.h>
+using namespace hp_fp;
+
+namespace
+{
+	// block sizes which no other test uses
+	const UInt32 remoteSize = 200;
+	const UInt32 exitSize = 900;
+	template<typename RefCount>
+	struct Node : RefCounted < RefCount >
+	{
+		Node( const Int32 val, Int32& destroyed ) : val( val ), destroyed( destroyed )
+		{ }
+		~Node( )
+		{
+			++destroyed;
+		}
+		Int32 val;
+		Int32& destroyed;
+	};
+	template<typename RefCount>
+	Int32 sum( const List<Int32, RefCount>& l )
+	{
+		return foldl( []( const Int32 acc, const Int32 a )
+		{
+			return acc + a;
+		}, 0, l );
+	}
+}
+
+TEST( PoolTest, FnReuse )
+{
+	void* a = poolAllocate_IO( 24 );
+	poolFree_IO( a, 24 );
+	const PoolStats before = poolStats_IO( );
+	void* b = poolAllocate_IO( 20 );
+	EXPECT_EQ( a, b );
+	void* c = poolAllocate_IO( 20 );
+	EXPECT_NE( b, c );
+	poolFree_IO( c, 20 );
+	poolFree_IO( b, 20 );
+	const PoolStats after = poolStats_IO( );
+	EXPECT_EQ( 2, after.allocations - before.allocations );
+	EXPECT_EQ( 2, after.deallocations - before.deallocations );
+	EXPECT_EQ( 0, after.systemAllocations - before.systemAllocations );
+}
+
+TEST( PoolTest, FnLargeBlocks )
+{
+	const PoolStats before = poolStats_IO( );
+	void* a = poolAllocate_IO( POOL_MAX_BLOCK + 1 );
+	poolFree_IO( a, POOL_MAX_BLOCK + 1 );
+	EXPECT_EQ( 1, poolStats_IO( ).systemAllocations - before.systemAllocations );
+}
+
+TEST( PoolTest, FnMakePooled )
+{
+	auto warmUp = makePooled<Int32>( 1 );
+	warmUp.reset( );
+	const PoolStats before = poolStats_IO( );
+	auto p = makePooled<const Int32>( 5 );
+	EXPECT_EQ( 5, *p );
+	p.reset( );
+	const PoolStats after = poolStats_IO( );
+	EXPECT_EQ( 1, after.allocations - before.allocations );
+	EXPECT_EQ( 1, after.deallocations - before.deallocations );
+	EXPECT_EQ( 0, after.systemAllocations - before.systemAllocations );
+}
+
+TEST( PoolTest, FnRemoteFreesSpill )
+{
+	// blocks of another thread, so that they do not come back to it
+	const UInt32 count = 4 * poolBatch( poolClass( remoteSize ) );
+	std::vector<void*> blocks;
+	std::thread( [&blocks, count]
+	{
+		for ( UInt32 i = 0; i < count; ++i )
+		{
+			blocks.push_back( poolAllocate_IO( remoteSize ) );
+		}
+	} ).join( );
+	const UInt64 depotBefore = poolDepotBlocks_IO( poolClass( remoteSize ) );
+	for ( void* block : blocks )
+	{
+		poolFree_IO( block, remoteSize );
+	}
+	// this thread keeps at most two slabs of them
+	EXPECT_LE( depotBefore + count - 2 * poolBatch( poolClass( remoteSize ) ),
+		poolDepotBlocks_IO( poolClass( remoteSize ) ) );
+	PoolStats stats;
+	std::thread( [&stats, count]
+	{
+		std::vector<void*> reused;
+		for ( UInt32 i = 0; i < count / 2; ++i )
+		{
+			reused.push_back( poolAllocate_IO( remoteSize ) );
+		}
+		for ( void* block : reused )
+		{
+			poolFree_IO( block, remoteSize );
+		}
+		stats = poolStats_IO( );
+	} ).join( );
+	EXPECT_EQ( 0, stats.systemAllocations );
+}
+
+TEST( PoolTest, FnThreadExitReleases )
+{
+	const UInt64 depotBefore = poolDepotBlocks_IO( poolClass( exitSize ) );
+	std::thread( []
+	{
+		poolFree_IO( poolAllocate_IO( exitSize ), exitSize );
+	} ).join( );
+	EXPECT_LE( depotBefore + 1, poolDepotBlocks_IO( poolClass( exitSize ) ) );
+}
+
+TEST( RefPtrTest, FnRefCount )
+{
+	Int32 destroyed = 0;
+	{
+		const RefPtr<const Node<LocalRefCount>> a = makeRef<const Node<LocalRefCount>>( 3, destroyed );
+		EXPECT_EQ( 1, a.useCount( ) );
+		RefPtr<const Node<LocalRefCount>> b = a;
+		EXPECT_EQ( 2, a.useCount( ) );
+		const RefPtr<const Node<LocalRefCount>> c = std::move( b );
+		EXPECT_EQ( 2, c.useCount( ) );
+		EXPECT_FALSE( b );
+		EXPECT_EQ( 3, c->val );
+	}
+	EXPECT_EQ( 1, destroyed );
+	{
+		RefPtr<Node<AtomicRefCount>> a = makeRef<Node<AtomicRefCount>>( 4, destroyed );
+		RefPtr<Node<AtomicRefCount>> b = makeRef<Node<AtomicRefCount>>( 5, destroyed );
+		a = b;
+		EXPECT_EQ( 2, destroyed );
+		EXPECT_EQ( 2, b.useCount( ) );
+		EXPECT_EQ( 5, a->val );
+	}
+	EXPECT_EQ( 3, destroyed );
+}
+
+TEST( RefPtrTest, FnListSteadyState )
+{
+	const List<Int32> l{ 1, 2, 3 };
+	const List<Int32, AtomicRefCount> shared{ 1, 2, 3 };
+	EXPECT_EQ( 6, sum( l ) );
+	EXPECT_EQ( 6, sum( shared ) );
+	// pushing and dropping the same number of items reuses their blocks
+	auto run = [&l]
+	{
+		List<Int32> longer = l;
+		for ( Int32 i = 0; i < 1000; ++i )
+		{
+			longer = longer.push( i );
+		}
+		EXPECT_EQ( 1003, foldl( []( const Int32 acc, const Int32 )
+		{
+			return acc + 1;
+		}, 0, longer ) );
+	};
+	run( );
+	const PoolStats before = poolStats_IO( );
+	run( );
+	const PoolStats after = poolStats_IO( );
+	EXPECT_EQ( 0, after.systemAllocations - before.systemAllocations );
+	EXPECT_EQ( after.allocations - before.allocations, after.deallocations - before.deallocations );
+}
+
+TEST( RefPtrTest, FnVectorSteadyState )
+{
+	std::vector<Int32> vals( 2048, 0 );
+	Vector<Int32> v( vals.begin( ), vals.end( ) );
+	// a frame updating values over the whole vector frees the paths the last frame copied
+	auto frame = [&v]
+	{
+		for ( UInt32 i = 0; i < 1000; ++i )
+		{
+			const UInt32 j = i * 37 % 2048;
+			v = v.update( j, v[j] + 1 );
+		}
+	};
+	frame( );
+	const PoolStats before = poolStats_IO( );
+	frame( );
+	const PoolStats after = poolStats_IO( );
+	EXPECT_EQ( 0, after.systemAllocations - before.systemAllocations );
+	EXPECT_EQ( 0, after.depotTrips - before.depotTrips );
+	EXPECT_EQ( after.allocations - before.allocations, after.deallocations - before.deallocations );
+	EXPECT_EQ( 2, v[0] );
+}
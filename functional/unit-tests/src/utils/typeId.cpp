@@ -0,0 +1,57 @@
+#include <pch/pch.hpp>
+#include <type_traits>
+#include <utils/typeId.hpp>
+#include <gtest/gtest.h>
+
+namespace test
+{
+	struct Mesh
+	{ };
+	struct Camera
+	{ };
+	struct Light
+	{ };
+}
+HP_TYPE_ID( test::Mesh, 0 )
+HP_TYPE_ID( test::Camera, 1 )
+HP_TYPE_ID( test::Light, 2 )
+using namespace hp_fp;
+
+namespace
+{
+	template<TypeId Id>
+	struct Slot
+	{
+		static const TypeId value = Id;
+	};
+	const char* nameOf( const TypeId id )
+	{
+		switch ( id )
+		{
+		case TypeIdOf<test::Mesh>::value:
+			return "mesh";
+		case TypeIdOf<test::Camera>::value:
+			return "camera";
+		case TypeIdOf<test::Light>::value:
+			return "light";
+		default:
+			return "";
+		}
+	}
+}
+
+TEST( TypeIdTest, FnSwitch )
+{
+	EXPECT_STREQ( "mesh", nameOf( typeId<test::Mesh>( ) ) );
+	EXPECT_STREQ( "camera", nameOf( typeId<const test::Camera>( ) ) );
+	EXPECT_STREQ( "light", nameOf( typeId<test::Light>( ) ) );
+}
+
+TEST( TypeIdTest, FnCompileTime )
+{
+	static_assert( Slot<TypeIdOf<test::Light>::value>::value == 2, "Id is a template argument." );
+	static_assert( std::is_same<TypeOfId<1>::type, test::Camera>::value, "Id maps back to its type." );
+	// table indexed by id, sized at compile time
+	const char* table[TypeIdOf<test::Light>::value + 1] = { "mesh", "camera", "light" };
+	EXPECT_STREQ( "camera", table[typeId<test::Camera>( )] );
+}
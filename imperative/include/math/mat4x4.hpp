@@ -1,9 +1,12 @@
 #pragma once
+#include "simd.hpp"
 #include "vec3.hpp"
 #include "vec4.hpp"
 #include "quat.hpp"
 namespace hp_ip
 {
+	struct Mat4x4;
+	Mat4x4 mulScalar( const Mat4x4& a, const Mat4x4& b );
 	struct Mat4x4
 	{
 	public:
@@ -23,33 +26,98 @@ namespace hp_ip
 			_31( m31 ), _32( m32 ), _33( m33 ), _34( m34 ), _41( m41 ), _42( m42 ), _43( m43 ), _44( m44 )
 		{ }
 		static const Mat4x4 identity;
+		// scalar, for a single product it is faster than the SIMD mul
 		Mat4x4 operator * ( const Mat4x4& mat ) const
 		{
-			Mat4x4 result;
-			for ( int i = 0; i < 4; i++ )
-			{
-				for ( int j = 0; j < 4; j++ )
-				{
-					result.m[i][j] =
-						m[i][0] * mat.m[0][j] +
-						m[i][1] * mat.m[1][j] +
-						m[i][2] * mat.m[2][j] +
-						m[i][3] * mat.m[3][j];
-				}
-			}
-			return result;
+			return mulScalar( *this, mat );
 		}
 	};
 	/*}   }   }   }  }  }  } } } }}}} Functions {{{{ { { {  {  {  {   {   {   {*/
 
+	// scalar kernels, the functions below use them when no SIMD is selected
+	inline Mat4x4 mulScalar( const Mat4x4& a, const Mat4x4& b )
+	{
+		Mat4x4 result;
+		for ( int i = 0; i < 4; i++ )
+		{
+			for ( int j = 0; j < 4; j++ )
+			{
+				result.m[i][j] =
+					a.m[i][0] * b.m[0][j] +
+					a.m[i][1] * b.m[1][j] +
+					a.m[i][2] * b.m[2][j] +
+					a.m[i][3] * b.m[3][j];
+			}
+		}
+		return result;
+	}
+	Mat4x4 inverseScalar( const Mat4x4& mat );
+	Mat4x4 affineInverseScalar( const Mat4x4& mat );
+	Mat4x4 rotSclPosToMat4x4Scalar( const FQuat& rot, const FVec3& scl, const FVec3& pos,
+		const Mat4x4& parent );
+#if defined( HP_SIMD_AVX )
+	namespace detail
+	{
+		// x in the lower and y in the upper four lanes
+		HP_FORCE_INLINE __m256 pair( const float x, const float y )
+		{
+			return _mm256_insertf128_ps( _mm256_set1_ps( x ), _mm_set1_ps( y ), 1 );
+		}
+	}
+#endif
+	// rows summed in the same order as mulScalar, so results are equal, only pays off when
+	// the products are not bound by storing and reloading the matrices
+	inline Mat4x4 mul( const Mat4x4& a, const Mat4x4& b )
+	{
+#if defined( HP_SIMD_AVX )
+		Mat4x4 result;
+		const __m256 b0 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b.m[0] ) );
+		const __m256 b1 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b.m[1] ) );
+		const __m256 b2 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b.m[2] ) );
+		const __m256 b3 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b.m[3] ) );
+		// two rows of a per register, elements of a are broadcast from memory because a
+		// vector load of a matrix just written by scalar stores stalls on store forwarding
+		for ( int i = 0; i < 4; i += 2 )
+		{
+			__m256 r = _mm256_mul_ps( detail::pair( a.m[i][0], a.m[i + 1][0] ), b0 );
+			r = _mm256_add_ps( r, _mm256_mul_ps( detail::pair( a.m[i][1], a.m[i + 1][1] ), b1 ) );
+			r = _mm256_add_ps( r, _mm256_mul_ps( detail::pair( a.m[i][2], a.m[i + 1][2] ), b2 ) );
+			r = _mm256_add_ps( r, _mm256_mul_ps( detail::pair( a.m[i][3], a.m[i + 1][3] ), b3 ) );
+			_mm256_storeu_ps( result.m[i], r );
+		}
+		return result;
+#elif defined( HP_SIMD_SSE )
+		Mat4x4 result;
+		const __m128 b0 = _mm_loadu_ps( b.m[0] );
+		const __m128 b1 = _mm_loadu_ps( b.m[1] );
+		const __m128 b2 = _mm_loadu_ps( b.m[2] );
+		const __m128 b3 = _mm_loadu_ps( b.m[3] );
+		for ( int i = 0; i < 4; i++ )
+		{
+			__m128 r = _mm_mul_ps( _mm_set1_ps( a.m[i][0] ), b0 );
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( a.m[i][1] ), b1 ) );
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( a.m[i][2] ), b2 ) );
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( a.m[i][3] ), b3 ) );
+			_mm_storeu_ps( result.m[i], r );
+		}
+		return result;
+#else
+		return mulScalar( a, b );
+#endif
+	}
 	FVec3 pos( const Mat4x4& mat );
 	float determinant( const Mat4x4& mat );
 	Mat4x4 inverse( const Mat4x4& mat );
+	// inverse of a matrix whose last column is ( 0, 0, 0, 1 ), e.g. any TRS composition
+	Mat4x4 affineInverse( const Mat4x4& mat );
 	Mat4x4 matrixPerspectiveFovLH( const float fieldOfView, const float aspectRatio,
 		const float nearClipDist, const float farClipDist );
 	Mat4x4 rotToMat4x4( const FQuat& rot );
 	Mat4x4 sclToMat4x4( const FVec3& scl );
 	Mat4x4 posToMat4x4( const FVec3& pos );
 	Mat4x4 rotSclPosToMat4x4( const FQuat& rot, const FVec3& scl, const FVec3& pos );
+	// rotSclPosToMat4x4( rot, scl, pos ) * parent without building the local matrix
+	Mat4x4 rotSclPosToMat4x4( const FQuat& rot, const FVec3& scl, const FVec3& pos,
+		const Mat4x4& parent );
 }
 
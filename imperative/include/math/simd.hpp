@@ -0,0 +1,22 @@
+#pragma once
+// Compile-time selection of SIMD kernels. HP_SIMD_AVX implies HP_SIMD_SSE, defining
+// HP_SIMD_SCALAR before including any math header keeps every kernel scalar.
+#if !defined( HP_SIMD_SCALAR )
+#	if defined( __AVX__ )
+#		define HP_SIMD_AVX
+#	endif
+#	if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#		define HP_SIMD_SSE
+#	endif
+#endif
+#if defined( HP_SIMD_AVX )
+#	include <immintrin.h>
+#elif defined( HP_SIMD_SSE )
+#	include <emmintrin.h>
+#endif
+#if defined( _MSC_VER )
+#	define HP_FORCE_INLINE __forceinline
+#else
+#	define HP_FORCE_INLINE inline __attribute__( ( always_inline ) )
+#endif
+#define HP_SHUFFLE( x, y, z, w ) ( ( x ) | ( ( y ) << 2 ) | ( ( z ) << 4 ) | ( ( w ) << 6 ) )
@@ -0,0 +1,15 @@
+#pragma once
+#include <cmath>
+// Sine and cosine of one angle in one call.
+namespace hp_ip
+{
+	inline void sinCos( const float rad, float& s, float& c )
+	{
+#if defined( __GNUC__ )
+		__builtin_sincosf( rad, &s, &c );
+#else
+		s = sin( rad );
+		c = cos( rad );
+#endif
+	}
+}
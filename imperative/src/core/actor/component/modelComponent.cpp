@@ -30,7 +30,7 @@ namespace hp_ip
 		{
 			const Camera& cam = pRenderer->getCamera( );
 			_material->setProjection( cam.projection );
-			_material->setView( inverse( cam.transform ) );
+			_material->setView( affineInverse( cam.transform ) );
 			_material->setWorld( _owner->transformComponent( ).modelTransform( ) );
 			_material->setCameraPosition( pos( cam.transform ) );
 			_material->setAbientLightColor( Color( 0.1f, 0.1f, 0.1f, 0.6f ) );
@@ -26,40 +26,197 @@ namespace hp_ip
 		return -( mat.m[0][3] * x.x + mat.m[1][3] * x.y + mat.m[2][3] * x.z +
 			mat.m[3][3] * x.w );
 	}
-	Mat4x4 inverse( const Mat4x4& mat )
+	namespace
 	{
-		Mat4x4 invMat;
-		FVec4 vec[3];
-		int i, j;
-		float det = determinant( mat );
-		for ( i = 0; i < 4; ++i )
+#if defined( HP_SIMD_SSE )
+		HP_FORCE_INLINE __m128 swizzle( const __m128 v, const int mask )
+		{
+			return _mm_castsi128_ps( _mm_shuffle_epi32( _mm_castps_si128( v ), mask ) );
+		}
+		// 2x2 matrices as ( _11, _12, _21, _22 ), a * b
+		HP_FORCE_INLINE __m128 mat2Mul( const __m128 a, const __m128 b )
+		{
+			return _mm_add_ps( _mm_mul_ps( a, swizzle( b, HP_SHUFFLE( 0, 3, 0, 3 ) ) ),
+				_mm_mul_ps( swizzle( a, HP_SHUFFLE( 1, 0, 3, 2 ) ),
+				swizzle( b, HP_SHUFFLE( 2, 1, 2, 1 ) ) ) );
+		}
+		// adj( a ) * b
+		HP_FORCE_INLINE __m128 mat2AdjMul( const __m128 a, const __m128 b )
+		{
+			return _mm_sub_ps( _mm_mul_ps( swizzle( a, HP_SHUFFLE( 3, 3, 0, 0 ) ), b ),
+				_mm_mul_ps( swizzle( a, HP_SHUFFLE( 1, 1, 2, 2 ) ),
+				swizzle( b, HP_SHUFFLE( 2, 3, 0, 1 ) ) ) );
+		}
+		// a * adj( b )
+		HP_FORCE_INLINE __m128 mat2MulAdj( const __m128 a, const __m128 b )
+		{
+			return _mm_sub_ps( _mm_mul_ps( a, swizzle( b, HP_SHUFFLE( 3, 0, 3, 0 ) ) ),
+				_mm_mul_ps( swizzle( a, HP_SHUFFLE( 1, 0, 3, 2 ) ),
+				swizzle( b, HP_SHUFFLE( 2, 1, 2, 1 ) ) ) );
+		}
+		// ( a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x, 0 ) for
+		// a.w == b.w
+		HP_FORCE_INLINE __m128 cross3( const __m128 a, const __m128 b )
+		{
+			return _mm_sub_ps(
+				_mm_mul_ps( swizzle( a, HP_SHUFFLE( 1, 2, 0, 3 ) ),
+				swizzle( b, HP_SHUFFLE( 2, 0, 1, 3 ) ) ),
+				_mm_mul_ps( swizzle( a, HP_SHUFFLE( 2, 0, 1, 3 ) ),
+				swizzle( b, HP_SHUFFLE( 1, 2, 0, 3 ) ) ) );
+		}
+		// lane I of l0, l1 and l2 times the rows p0, p1 and p2
+		template<int I>
+		HP_FORCE_INLINE __m128 combineRows( const __m128 l0, const __m128 l1, const __m128 l2,
+			const __m128 p0, const __m128 p1, const __m128 p2 )
 		{
-			for ( j = 0; j < 4; ++j )
-			{
-				if ( i != j )
-				{
-					int a = ( j <= i ) ? j : j - 1;
-					vec[a].x = mat.m[j][0];
-					vec[a].y = mat.m[j][1];
-					vec[a].z = mat.m[j][2];
-					vec[a].w = mat.m[j][3];
-				}
-			}
-			FVec4 x = cross( vec[0], vec[1], vec[2] );
-			float cofactor;
-			for ( j = 0; j < 4; ++j )
-			{
-				switch ( j )
-				{
-				case 0: cofactor = x.x; break;
-				case 1: cofactor = x.y; break;
-				case 2: cofactor = x.z; break;
-				case 3: cofactor = x.w; break;
-				}
-				invMat.m[j][i] = pow( -1.0f, i ) * cofactor / det;
-			}
+			__m128 r = _mm_mul_ps( _mm_shuffle_ps( l0, l0, HP_SHUFFLE( I, I, I, I ) ), p0 );
+			r = _mm_add_ps( r, _mm_mul_ps( _mm_shuffle_ps( l1, l1, HP_SHUFFLE( I, I, I, I ) ), p1 ) );
+			return _mm_add_ps( r, _mm_mul_ps( _mm_shuffle_ps( l2, l2, HP_SHUFFLE( I, I, I, I ) ),
+				p2 ) );
 		}
+#endif
+	}
+	Mat4x4 inverseScalar( const Mat4x4& mat )
+	{
+		const float( &a )[4][4] = mat.m;
+		// 2x2 minors of the upper and the lower two rows
+		const float s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+		const float s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+		const float s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+		const float s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+		const float s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+		const float s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+		const float c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+		const float c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+		const float c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+		const float c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+		const float c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+		const float c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+		const float invDet = 1.0f /
+			( s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0 );
+		return Mat4x4(
+			( a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3 ) * invDet,
+			( -a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3 ) * invDet,
+			( a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3 ) * invDet,
+			( -a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3 ) * invDet,
+			( -a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1 ) * invDet,
+			( a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1 ) * invDet,
+			( -a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1 ) * invDet,
+			( a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1 ) * invDet,
+			( a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0 ) * invDet,
+			( -a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0 ) * invDet,
+			( a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0 ) * invDet,
+			( -a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0 ) * invDet,
+			( -a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0 ) * invDet,
+			( a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0 ) * invDet,
+			( -a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0 ) * invDet,
+			( a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0 ) * invDet );
+	}
+	// block inverse, with mat as 2x2 blocks A B / C D
+	Mat4x4 inverse( const Mat4x4& mat )
+	{
+#if defined( HP_SIMD_SSE )
+		const __m128 r0 = _mm_loadu_ps( mat.m[0] );
+		const __m128 r1 = _mm_loadu_ps( mat.m[1] );
+		const __m128 r2 = _mm_loadu_ps( mat.m[2] );
+		const __m128 r3 = _mm_loadu_ps( mat.m[3] );
+		const __m128 a = _mm_movelh_ps( r0, r1 );
+		const __m128 b = _mm_movehl_ps( r1, r0 );
+		const __m128 c = _mm_movelh_ps( r2, r3 );
+		const __m128 d = _mm_movehl_ps( r3, r2 );
+		// ( |A|, |B|, |C|, |D| )
+		const __m128 detSub = _mm_sub_ps(
+			_mm_mul_ps( _mm_shuffle_ps( r0, r2, HP_SHUFFLE( 0, 2, 0, 2 ) ),
+			_mm_shuffle_ps( r1, r3, HP_SHUFFLE( 1, 3, 1, 3 ) ) ),
+			_mm_mul_ps( _mm_shuffle_ps( r0, r2, HP_SHUFFLE( 1, 3, 1, 3 ) ),
+			_mm_shuffle_ps( r1, r3, HP_SHUFFLE( 0, 2, 0, 2 ) ) ) );
+		const __m128 detA = swizzle( detSub, HP_SHUFFLE( 0, 0, 0, 0 ) );
+		const __m128 detB = swizzle( detSub, HP_SHUFFLE( 1, 1, 1, 1 ) );
+		const __m128 detC = swizzle( detSub, HP_SHUFFLE( 2, 2, 2, 2 ) );
+		const __m128 detD = swizzle( detSub, HP_SHUFFLE( 3, 3, 3, 3 ) );
+		const __m128 dc = mat2AdjMul( d, c );
+		const __m128 ab = mat2AdjMul( a, b );
+		// adjugates of the blocks of the inverse scaled by |M|
+		__m128 x = _mm_sub_ps( _mm_mul_ps( detD, a ), mat2Mul( b, dc ) );
+		__m128 w = _mm_sub_ps( _mm_mul_ps( detA, d ), mat2Mul( c, ab ) );
+		__m128 y = _mm_sub_ps( _mm_mul_ps( detB, c ), mat2MulAdj( d, ab ) );
+		__m128 z = _mm_sub_ps( _mm_mul_ps( detC, b ), mat2MulAdj( a, dc ) );
+		// |M| = |A| |D| + |B| |C| - tr( adj( A ) B adj( D ) C )
+		__m128 tr = _mm_mul_ps( ab, swizzle( dc, HP_SHUFFLE( 0, 2, 1, 3 ) ) );
+		tr = _mm_add_ps( tr, swizzle( tr, HP_SHUFFLE( 2, 3, 0, 1 ) ) );
+		tr = _mm_add_ps( tr, swizzle( tr, HP_SHUFFLE( 1, 0, 3, 2 ) ) );
+		const __m128 detM = _mm_sub_ps( _mm_add_ps( _mm_mul_ps( detA, detD ),
+			_mm_mul_ps( detB, detC ) ), tr );
+		const __m128 rDetM = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), detM );
+		x = _mm_mul_ps( x, rDetM );
+		y = _mm_mul_ps( y, rDetM );
+		z = _mm_mul_ps( z, rDetM );
+		w = _mm_mul_ps( w, rDetM );
+		Mat4x4 invMat;
+		_mm_storeu_ps( invMat.m[0], _mm_shuffle_ps( x, y, HP_SHUFFLE( 3, 1, 3, 1 ) ) );
+		_mm_storeu_ps( invMat.m[1], _mm_shuffle_ps( x, y, HP_SHUFFLE( 2, 0, 2, 0 ) ) );
+		_mm_storeu_ps( invMat.m[2], _mm_shuffle_ps( z, w, HP_SHUFFLE( 3, 1, 3, 1 ) ) );
+		_mm_storeu_ps( invMat.m[3], _mm_shuffle_ps( z, w, HP_SHUFFLE( 2, 0, 2, 0 ) ) );
 		return invMat;
+#else
+		return inverseScalar( mat );
+#endif
+	}
+	// rows of the inverse of the upper 3x3 block are the columns of cross products of its
+	// rows divided by the determinant
+	Mat4x4 affineInverseScalar( const Mat4x4& mat )
+	{
+		const FVec3 r0{ mat.m[0][0], mat.m[0][1], mat.m[0][2] };
+		const FVec3 r1{ mat.m[1][0], mat.m[1][1], mat.m[1][2] };
+		const FVec3 r2{ mat.m[2][0], mat.m[2][1], mat.m[2][2] };
+		const float invDet = 1.0f / dot( r0, cross( r1, r2 ) );
+		const FVec3 c0 = cross( r1, r2 ) * invDet;
+		const FVec3 c1 = cross( r2, r0 ) * invDet;
+		const FVec3 c2 = cross( r0, r1 ) * invDet;
+		const float tx = mat.m[3][0];
+		const float ty = mat.m[3][1];
+		const float tz = mat.m[3][2];
+		return Mat4x4(
+			c0.x, c1.x, c2.x, 0.0f,
+			c0.y, c1.y, c2.y, 0.0f,
+			c0.z, c1.z, c2.z, 0.0f,
+			-( tx * c0.x + ty * c0.y + tz * c0.z ),
+			-( tx * c1.x + ty * c1.y + tz * c1.z ),
+			-( tx * c2.x + ty * c2.y + tz * c2.z ), 1.0f );
+	}
+	Mat4x4 affineInverse( const Mat4x4& mat )
+	{
+#if defined( HP_SIMD_SSE )
+		const __m128 w0 = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+		const __m128 r0 = _mm_and_ps( _mm_loadu_ps( mat.m[0] ), w0 );
+		const __m128 r1 = _mm_and_ps( _mm_loadu_ps( mat.m[1] ), w0 );
+		const __m128 r2 = _mm_and_ps( _mm_loadu_ps( mat.m[2] ), w0 );
+		const __m128 t = _mm_loadu_ps( mat.m[3] );
+		__m128 c0 = cross3( r1, r2 );
+		__m128 c1 = cross3( r2, r0 );
+		__m128 c2 = cross3( r0, r1 );
+		__m128 det = _mm_mul_ps( r0, c0 );
+		det = _mm_add_ps( det, swizzle( det, HP_SHUFFLE( 2, 3, 0, 1 ) ) );
+		det = _mm_add_ps( det, swizzle( det, HP_SHUFFLE( 1, 0, 3, 2 ) ) );
+		const __m128 invDet = _mm_div_ps( _mm_set1_ps( 1.0f ), det );
+		c0 = _mm_mul_ps( c0, invDet );
+		c1 = _mm_mul_ps( c1, invDet );
+		c2 = _mm_mul_ps( c2, invDet );
+		__m128 c3 = _mm_setzero_ps( );
+		_MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+		__m128 pos = _mm_mul_ps( swizzle( t, HP_SHUFFLE( 0, 0, 0, 0 ) ), c0 );
+		pos = _mm_add_ps( pos, _mm_mul_ps( swizzle( t, HP_SHUFFLE( 1, 1, 1, 1 ) ), c1 ) );
+		pos = _mm_add_ps( pos, _mm_mul_ps( swizzle( t, HP_SHUFFLE( 2, 2, 2, 2 ) ), c2 ) );
+		pos = _mm_sub_ps( _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f ), pos );
+		Mat4x4 invMat;
+		_mm_storeu_ps( invMat.m[0], c0 );
+		_mm_storeu_ps( invMat.m[1], c1 );
+		_mm_storeu_ps( invMat.m[2], c2 );
+		_mm_storeu_ps( invMat.m[3], pos );
+		return invMat;
+#else
+		return affineInverseScalar( mat );
+#endif
 	}
 	Mat4x4 matrixPerspectiveFovLH( const float fieldOfView, const float aspectRatio,
 		const float nearClipDist, const float farClipDist )
@@ -123,7 +280,59 @@ namespace hp_ip
 		mat.m[1][1] *= scl.y;
 		mat.m[2][2] *= scl.z;
 		return mat;
-
+	}
+	// terms of the zero elements of the local matrix are left out, they add exact zeros
+	Mat4x4 rotSclPosToMat4x4Scalar( const FQuat& rot, const FVec3& scl, const FVec3& pos,
+		const Mat4x4& parent )
+	{
+		const float l00 = ( 1.0f - 2.0f * ( rot.y * rot.y + rot.z * rot.z ) ) * scl.x;
+		const float l01 = 2.0f * ( rot.x *rot.y + rot.z * rot.w );
+		const float l02 = 2.0f * ( rot.x * rot.z - rot.y * rot.w );
+		const float l10 = 2.0f * ( rot.x * rot.y - rot.z * rot.w );
+		const float l11 = ( 1.0f - 2.0f * ( rot.x * rot.x + rot.z * rot.z ) ) * scl.y;
+		const float l12 = 2.0f * ( rot.y *rot.z + rot.x *rot.w );
+		const float l20 = 2.0f * ( rot.x * rot.z + rot.y * rot.w );
+		const float l21 = 2.0f * ( rot.y *rot.z - rot.x *rot.w );
+		const float l22 = ( 1.0f - 2.0f * ( rot.x * rot.x + rot.y * rot.y ) ) * scl.z;
+		const float( &p )[4][4] = parent.m;
+		Mat4x4 mat;
+		for ( int j = 0; j < 4; j++ )
+		{
+			mat.m[0][j] = l00 * p[0][j] + l01 * p[1][j] + l02 * p[2][j];
+			mat.m[1][j] = l10 * p[0][j] + l11 * p[1][j] + l12 * p[2][j];
+			mat.m[2][j] = l20 * p[0][j] + l21 * p[1][j] + l22 * p[2][j];
+			mat.m[3][j] = pos.x * p[0][j] + pos.y * p[1][j] + pos.z * p[2][j] + p[3][j];
+		}
+		return mat;
+	}
+	Mat4x4 rotSclPosToMat4x4( const FQuat& rot, const FVec3& scl, const FVec3& pos,
+		const Mat4x4& parent )
+	{
+#if defined( HP_SIMD_SSE )
+		const __m128 p0 = _mm_loadu_ps( parent.m[0] );
+		const __m128 p1 = _mm_loadu_ps( parent.m[1] );
+		const __m128 p2 = _mm_loadu_ps( parent.m[2] );
+		const __m128 p3 = _mm_loadu_ps( parent.m[3] );
+		// columns of the local matrix without its last one, lane i is row i
+		const __m128 l0 = _mm_setr_ps(
+			( 1.0f - 2.0f * ( rot.y * rot.y + rot.z * rot.z ) ) * scl.x,
+			2.0f * ( rot.x * rot.y - rot.z * rot.w ), 2.0f * ( rot.x * rot.z + rot.y * rot.w ),
+			pos.x );
+		const __m128 l1 = _mm_setr_ps( 2.0f * ( rot.x *rot.y + rot.z * rot.w ),
+			( 1.0f - 2.0f * ( rot.x * rot.x + rot.z * rot.z ) ) * scl.y,
+			2.0f * ( rot.y *rot.z - rot.x *rot.w ), pos.y );
+		const __m128 l2 = _mm_setr_ps( 2.0f * ( rot.x * rot.z - rot.y * rot.w ),
+			2.0f * ( rot.y *rot.z + rot.x *rot.w ),
+			( 1.0f - 2.0f * ( rot.x * rot.x + rot.y * rot.y ) ) * scl.z, pos.z );
+		Mat4x4 mat;
+		_mm_storeu_ps( mat.m[0], combineRows<0>( l0, l1, l2, p0, p1, p2 ) );
+		_mm_storeu_ps( mat.m[1], combineRows<1>( l0, l1, l2, p0, p1, p2 ) );
+		_mm_storeu_ps( mat.m[2], combineRows<2>( l0, l1, l2, p0, p1, p2 ) );
+		_mm_storeu_ps( mat.m[3], _mm_add_ps( combineRows<3>( l0, l1, l2, p0, p1, p2 ), p3 ) );
+		return mat;
+#else
+		return rotSclPosToMat4x4Scalar( rot, scl, pos, parent );
+#endif
 	}
 }
 
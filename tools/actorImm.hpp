@@ -1,21 +1,67 @@
 #pragma once
-#include <adt/list.hpp>
+#include <utility>
+#include <adt/vector.hpp>
 #include <core/actors/component.hpp>
 // Generated using tools/immutableStruct.hs:
-// gen "Actor" [("List<ActorImm>", "children"), ("List<Component>", "components")] ["adt/list.hpp", "core/actors/component.hpp"]
+// gen "Actor" [("Vector<ActorImm>", "children"), ("Vector<Component>", "components")] ["adt/vector.hpp", "core/actors/component.hpp"]
 namespace hp_fp
 {
-struct ActorImm
-{
-const List<ActorImm> children;
-const List<Component> components;
-const ActorImm setChildren(const List<ActorImm> c) const
-{
-return ActorImm{ c, components };
- }
-const ActorImm setComponents(const List<Component> c) const
-{
-return ActorImm{ children, c };
- }
-};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	struct ActorImm
+	{
+		struct Builder;
+		ActorImm( Vector<ActorImm> children, Vector<Component> components )
+			: _children( std::move( children ) ), _components( std::move( components ) )
+		{ }
+		const Vector<ActorImm>& children( ) const
+		{
+			return _children;
+		}
+		const Vector<Component>& components( ) const
+		{
+			return _components;
+		}
+		ActorImm setChildren( Vector<ActorImm> c ) const &
+		{
+			return ActorImm( std::move( c ), _components );
+		}
+		// moves the other fields out of this
+		ActorImm setChildren( Vector<ActorImm> c ) &&
+		{
+			return ActorImm( std::move( c ), std::move( _components ) );
+		}
+		ActorImm setComponents( Vector<Component> c ) const &
+		{
+			return ActorImm( _children, std::move( c ) );
+		}
+		// moves the other fields out of this
+		ActorImm setComponents( Vector<Component> c ) &&
+		{
+			return ActorImm( std::move( _children ), std::move( c ) );
+		}
+		Builder builder( ) const &;
+		Builder builder( ) &&;
+	private:
+		Vector<ActorImm> _children;
+		Vector<Component> _components;
+	};
+	// batches changes of several fields into one construction
+	struct ActorImm::Builder
+	{
+		Vector<ActorImm> children;
+		Vector<Component> components;
+		ActorImm build( ) &&
+		{
+			return ActorImm( std::move( children ), std::move( components ) );
+		}
+	};
+	inline ActorImm::Builder ActorImm::builder( ) const &
+	{
+		return Builder{ _children, _components };
+	}
+	inline ActorImm::Builder ActorImm::builder( ) &&
+	{
+		return Builder{ std::move( _children ), std::move( _components ) };
+	}
 }
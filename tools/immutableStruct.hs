@@ -1,6 +1,6 @@
 import Data.Char (toLower, toUpper)
 import System.IO
-import Data.List (intersperse)
+import Data.List (intercalate, intersperse)
 
 type Name = String
 type VarType = String
@@ -8,41 +8,87 @@ type VarName = String
 type Include = String
 
 {-|
-Generates C++ source code for immutable struct including constructor and setters.
+Generates C++ source code for immutable struct including constructor, getters, setters and
+a builder. Setters called on an rvalue move the fields they do not change, so a chain of
+setters never copies the struct. The builder batches changes of several fields into one
+construction.
 
 Example input:
-immutableStruct "WindowConfig" [("unsigned", "width"), ("unsigned", "height"), ("WindowStyle", "windowStyle"), ("unsigned", "bitsPerPx")] ["windowStyle"]
+immutableStruct "WindowConfig" [("UInt", "width"), ("UInt", "height")] ["window/windowStyle.hpp"]
+
+Usage in C++:
+const WindowConfigImm resized = std::move( config ).setWidth( 800 ).setHeight( 600 );
+WindowConfigImm::Builder b = config.builder( );
+b.width = 800;
+b.height = 600;
+const WindowConfigImm resized = std::move( b ).build( );
 
 Output:
 #pragma once
-#include "windowStyle.hpp"
+#include <utility>
+#include <window/windowStyle.hpp>
 // Generated using tools/immutableStruct.hs:
-// gen "WindowConfig" [("UInt", "width"), ("UInt", "height"), ("WindowStyle", "windowStyle"), ("UInt", "bitsPerPx")] ["windowStyle"]
+// gen "WindowConfig" [("UInt", "width"), ("UInt", "height")] ["window/windowStyle.hpp"]
 namespace hp_fp
 {
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
 	struct WindowConfigImm
 	{
-		const UInt width;
-		const UInt height;
-		const WindowStyle windowStyle;
-		const UInt bitsPerPx;
-		const WindowConfigImm setWidth( const UInt w ) const
+		struct Builder;
+		WindowConfigImm( UInt width, UInt height )
+			: _width( std::move( width ) ), _height( std::move( height ) )
+		{ }
+		const UInt& width( ) const
+		{
+			return _width;
+		}
+		const UInt& height( ) const
+		{
+			return _height;
+		}
+		WindowConfigImm setWidth( UInt w ) const &
+		{
+			return WindowConfigImm( std::move( w ), _height );
+		}
+		// moves the other fields out of this
+		WindowConfigImm setWidth( UInt w ) &&
 		{
-			return WindowConfigImm{ w, height, windowStyle, bitsPerPx };
+			return WindowConfigImm( std::move( w ), std::move( _height ) );
 		}
-		const WindowConfigImm setHeight( const UInt h ) const
+		WindowConfigImm setHeight( UInt h ) const &
 		{
-			return WindowConfigImm{ width, h, windowStyle, bitsPerPx };
+			return WindowConfigImm( _width, std::move( h ) );
 		}
-		const WindowConfigImm setWindowStyle( const WindowStyle w ) const
+		// moves the other fields out of this
+		WindowConfigImm setHeight( UInt h ) &&
 		{
-			return WindowConfigImm{ width, height, w, bitsPerPx };
+			return WindowConfigImm( std::move( _width ), std::move( h ) );
 		}
-		const WindowConfigImm setBitsPerPx( const UInt b ) const
+		Builder builder( ) const &;
+		Builder builder( ) &&;
+	private:
+		UInt _width;
+		UInt _height;
+	};
+	// batches changes of several fields into one construction
+	struct WindowConfigImm::Builder
+	{
+		UInt width;
+		UInt height;
+		WindowConfigImm build( ) &&
 		{
-			return WindowConfigImm{ width, height, windowStyle, b };
+			return WindowConfigImm( std::move( width ), std::move( height ) );
 		}
 	};
+	inline WindowConfigImm::Builder WindowConfigImm::builder( ) const &
+	{
+		return Builder{ _width, _height };
+	}
+	inline WindowConfigImm::Builder WindowConfigImm::builder( ) &&
+	{
+		return Builder{ std::move( _width ), std::move( _height ) };
+	}
 }
 
 -}
@@ -58,43 +104,95 @@ gen' :: Name -> [(VarType, VarName)] -> [Include] -> IO ()
 gen' n vs i = putStrLn $ immutableStruct n vs i
 
 immutableStruct :: Name -> [(VarType, VarName)] -> [Include] -> String
-immutableStruct n vs i = "#pragma once\n" ++ includes i ++ "// Generated using tools/immutableStruct.hs:\n// gen " ++ args n vs i ++ "\nnamespace hp_fp\n{\nstruct " ++ nn ++ "\n{\n" ++ variables vs ++ setters nn (variableNames vs) vs ++ "};\n}"
-  where 
+immutableStruct n vs i = intercalate "\n" $
+  ["#pragma once", "#include <utility>"] ++
+  map (\x -> "#include <" ++ x ++ ">") i ++
+  ["// Generated using tools/immutableStruct.hs:",
+   "// gen " ++ args n vs i,
+   "namespace hp_fp",
+   "{",
+   "\t// [const][cop-c][cop-a][mov-c][mov-a]",
+   "\t// [  +  ][  +  ][  +  ][  +  ][  +  ]",
+   "\tstruct " ++ nn,
+   "\t{",
+   "\t\tstruct Builder;"] ++
+  constructor ++
+  concatMap getter vs ++
+  concatMap setter vs ++
+  ["\t\tBuilder builder( ) const &;",
+   "\t\tBuilder builder( ) &&;",
+   "\tprivate:"] ++
+  map (\(vType, vName) -> "\t\t" ++ vType ++ " " ++ member vName ++ ";") vs ++
+  ["\t};"] ++
+  builder ++
+  ["}"]
+  where
   nn = n ++ "Imm"
-  includes :: [Include] -> String
-  includes [] = ""
-  includes i = foldl1 (++) (map (\x -> "#include <" ++ x ++ ">\n") i)
+  vNames = map snd vs
+  member :: VarName -> String
+  member vName = '_' : vName
+  moved :: String -> String
+  moved x = "std::move( " ++ x ++ " )"
+  -- items separated by commas between open and close, only a space between them when empty
+  enclose :: String -> String -> [String] -> String
+  enclose open close [] = open ++ " " ++ close
+  enclose open close xs = open ++ " " ++ intercalate ", " xs ++ " " ++ close
+  -- construction of the struct with f applied to each field name as its argument
+  construct :: (VarName -> String) -> String
+  construct f = nn ++ enclose "(" ")" (map f vNames)
   args :: Name -> [(VarType, VarName)] -> [Include] -> String
   args n vs i = "\"" ++ n ++ "\" [" ++ vArgs vs ++ "] " ++ includesList i
     where
     vArgs :: [(String, String)] -> String
+    vArgs [] = ""
     vArgs [(vType, vName)] = "(\"" ++ vType ++ "\", \"" ++ vName ++ "\")"
     vArgs ((vType, vName):vs) = "(\"" ++ vType ++ "\", \"" ++ vName ++ "\")" ++ ", " ++ vArgs vs
     includesList :: [Include] -> String
     includesList [] = "[]"
     includesList i = "[" ++ foldl1 (++) (intersperse ", " (map (\x -> "\"" ++ x ++ "\"") i)) ++ "]"
-  constructor :: String -> [(String, String)] -> String
-  constructor _ [] = ""
-  constructor n vs = n ++ "(" ++ constructorArgs vs ++ ");"
-    where
-    constructorArgs ::  [(String, String)] -> String
-    constructorArgs [(vType, vName)] = "const " ++ vType ++ " " ++ vName
-    constructorArgs ((vType, vName):vs) = "const " ++ vType ++ " " ++ vName ++ ", " ++ constructorArgs vs
-  variables :: [(String, String)] -> String
-  variables [] = ""
-  variables ((vType, vName):vs) = "const " ++ vType ++ " " ++ vName ++ ";\n" ++ variables vs
-  setters :: String -> [String] -> [(String, String)] -> String
-  setters _ _ [] = ""
-  setters n vNames ((vType, vName):vs) = "const " ++ n ++ " set" ++ (toUpper (head vName):tail vName) ++ "(const " ++ vType ++ " " ++ [head vName] ++ ") const\n{\nreturn " ++ n ++ "{ " ++ constructorArgs vName vNames ++ " };\n }\n" ++ setters n vNames vs
+  -- without fields there is no initializer list
+  constructor :: [String]
+  constructor =
+    ["\t\t" ++ nn ++ enclose "(" ")" (map (\(vType, vName) -> vType ++ " " ++ vName) vs)] ++
+    (if null vs then [] else
+      ["\t\t\t: " ++ intercalate ", " (map (\vName -> member vName ++ "( " ++ moved vName ++ " )") vNames)]) ++
+    ["\t\t{ }"]
+  getter :: (VarType, VarName) -> [String]
+  getter (vType, vName) =
+    ["\t\tconst " ++ vType ++ "& " ++ vName ++ "( ) const",
+     "\t\t{",
+     "\t\t\treturn " ++ member vName ++ ";",
+     "\t\t}"]
+  setter :: (VarType, VarName) -> [String]
+  setter (vType, vName) =
+    ["\t\t" ++ nn ++ " " ++ setterName ++ "( " ++ vType ++ " " ++ param ++ " ) const &",
+     "\t\t{",
+     "\t\t\treturn " ++ construct (\x -> if x == vName then moved param else member x) ++ ";",
+     "\t\t}",
+     "\t\t// moves the other fields out of this",
+     "\t\t" ++ nn ++ " " ++ setterName ++ "( " ++ vType ++ " " ++ param ++ " ) &&",
+     "\t\t{",
+     "\t\t\treturn " ++ construct (\x -> moved (if x == vName then param else member x)) ++ ";",
+     "\t\t}"]
     where
-    constructorArgs :: String -> [String] -> String
-    constructorArgs currentVName [vName] = if (currentVName == vName) 
-                                              then [head vName]
-                                              else vName
-    constructorArgs currentVName (vName:vNames) = (if (currentVName == vName) 
-                                                     then [head vName] ++ ", " 
-                                                     else vName ++ ", ")
-                                                   ++ constructorArgs currentVName vNames
-  variableNames :: [(String, String)] -> [String]
-  variableNames [] = []
-  variableNames ((vType, vName):vs) = vName : variableNames vs
\ No newline at end of file
+    param = [head vName]
+    setterName = "set" ++ (toUpper (head vName):tail vName)
+  builder :: [String]
+  builder =
+    ["\t// batches changes of several fields into one construction",
+     "\tstruct " ++ nn ++ "::Builder",
+     "\t{"] ++
+    map (\(vType, vName) -> "\t\t" ++ vType ++ " " ++ vName ++ ";") vs ++
+    ["\t\t" ++ nn ++ " build( ) &&",
+     "\t\t{",
+     "\t\t\treturn " ++ construct moved ++ ";",
+     "\t\t}",
+     "\t};",
+     "\tinline " ++ nn ++ "::Builder " ++ nn ++ "::builder( ) const &",
+     "\t{",
+     "\t\treturn Builder" ++ enclose "{" "}" (map member vNames) ++ ";",
+     "\t}",
+     "\tinline " ++ nn ++ "::Builder " ++ nn ++ "::builder( ) &&",
+     "\t{",
+     "\t\treturn Builder" ++ enclose "{" "}" (map (moved . member) vNames) ++ ";",
+     "\t}"]
\ No newline at end of file
@@ -1,16 +1,52 @@
 #pragma once
+#include <utility>
 #include <adt/tree.hpp>
 #include <core/actors/actor.hpp>
 // Generated using tools/immutableStruct.hs:
 // gen "Scene" [("Tree<ActorImm>", "actors")] ["adt/tree.hpp", "core/actors/actor.hpp"]
 namespace hp_fp
 {
-struct SceneImm
-{
-const Tree<ActorImm> actors;
-const SceneImm setActors(const Tree<ActorImm> a) const
-{
-return SceneImm{ a };
- }
-};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	struct SceneImm
+	{
+		struct Builder;
+		SceneImm( Tree<ActorImm> actors )
+			: _actors( std::move( actors ) )
+		{ }
+		const Tree<ActorImm>& actors( ) const
+		{
+			return _actors;
+		}
+		SceneImm setActors( Tree<ActorImm> a ) const &
+		{
+			return SceneImm( std::move( a ) );
+		}
+		// moves the other fields out of this
+		SceneImm setActors( Tree<ActorImm> a ) &&
+		{
+			return SceneImm( std::move( a ) );
+		}
+		Builder builder( ) const &;
+		Builder builder( ) &&;
+	private:
+		Tree<ActorImm> _actors;
+	};
+	// batches changes of several fields into one construction
+	struct SceneImm::Builder
+	{
+		Tree<ActorImm> actors;
+		SceneImm build( ) &&
+		{
+			return SceneImm( std::move( actors ) );
+		}
+	};
+	inline SceneImm::Builder SceneImm::builder( ) const &
+	{
+		return Builder{ _actors };
+	}
+	inline SceneImm::Builder SceneImm::builder( ) &&
+	{
+		return Builder{ std::move( _actors ) };
+	}
 }
@@ -1,30 +1,96 @@
 #pragma once
+#include <utility>
 #include <window/windowStyle.hpp>
 // Generated using tools/immutableStruct.hs:
 // gen "WindowConfig" [("UInt", "width"), ("UInt", "height"), ("WindowStyle", "windowStyle"), ("UInt", "bitsPerPx")] ["window/windowStyle.hpp"]
 namespace hp_fp
 {
-struct WindowConfigImm
-{
-const UInt width;
-const UInt height;
-const WindowStyle windowStyle;
-const UInt bitsPerPx;
-const WindowConfigImm setWidth(const UInt w) const
-{
-return WindowConfigImm{ w, height, windowStyle, bitsPerPx };
- }
-const WindowConfigImm setHeight(const UInt h) const
-{
-return WindowConfigImm{ width, h, windowStyle, bitsPerPx };
- }
-const WindowConfigImm setWindowStyle(const WindowStyle w) const
-{
-return WindowConfigImm{ width, height, w, bitsPerPx };
- }
-const WindowConfigImm setBitsPerPx(const UInt b) const
-{
-return WindowConfigImm{ width, height, windowStyle, b };
- }
-};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	struct WindowConfigImm
+	{
+		struct Builder;
+		WindowConfigImm( UInt width, UInt height, WindowStyle windowStyle, UInt bitsPerPx )
+			: _width( std::move( width ) ), _height( std::move( height ) ), _windowStyle( std::move( windowStyle ) ), _bitsPerPx( std::move( bitsPerPx ) )
+		{ }
+		const UInt& width( ) const
+		{
+			return _width;
+		}
+		const UInt& height( ) const
+		{
+			return _height;
+		}
+		const WindowStyle& windowStyle( ) const
+		{
+			return _windowStyle;
+		}
+		const UInt& bitsPerPx( ) const
+		{
+			return _bitsPerPx;
+		}
+		WindowConfigImm setWidth( UInt w ) const &
+		{
+			return WindowConfigImm( std::move( w ), _height, _windowStyle, _bitsPerPx );
+		}
+		// moves the other fields out of this
+		WindowConfigImm setWidth( UInt w ) &&
+		{
+			return WindowConfigImm( std::move( w ), std::move( _height ), std::move( _windowStyle ), std::move( _bitsPerPx ) );
+		}
+		WindowConfigImm setHeight( UInt h ) const &
+		{
+			return WindowConfigImm( _width, std::move( h ), _windowStyle, _bitsPerPx );
+		}
+		// moves the other fields out of this
+		WindowConfigImm setHeight( UInt h ) &&
+		{
+			return WindowConfigImm( std::move( _width ), std::move( h ), std::move( _windowStyle ), std::move( _bitsPerPx ) );
+		}
+		WindowConfigImm setWindowStyle( WindowStyle w ) const &
+		{
+			return WindowConfigImm( _width, _height, std::move( w ), _bitsPerPx );
+		}
+		// moves the other fields out of this
+		WindowConfigImm setWindowStyle( WindowStyle w ) &&
+		{
+			return WindowConfigImm( std::move( _width ), std::move( _height ), std::move( w ), std::move( _bitsPerPx ) );
+		}
+		WindowConfigImm setBitsPerPx( UInt b ) const &
+		{
+			return WindowConfigImm( _width, _height, _windowStyle, std::move( b ) );
+		}
+		// moves the other fields out of this
+		WindowConfigImm setBitsPerPx( UInt b ) &&
+		{
+			return WindowConfigImm( std::move( _width ), std::move( _height ), std::move( _windowStyle ), std::move( b ) );
+		}
+		Builder builder( ) const &;
+		Builder builder( ) &&;
+	private:
+		UInt _width;
+		UInt _height;
+		WindowStyle _windowStyle;
+		UInt _bitsPerPx;
+	};
+	// batches changes of several fields into one construction
+	struct WindowConfigImm::Builder
+	{
+		UInt width;
+		UInt height;
+		WindowStyle windowStyle;
+		UInt bitsPerPx;
+		WindowConfigImm build( ) &&
+		{
+			return WindowConfigImm( std::move( width ), std::move( height ), std::move( windowStyle ), std::move( bitsPerPx ) );
+		}
+	};
+	inline WindowConfigImm::Builder WindowConfigImm::builder( ) const &
+	{
+		return Builder{ _width, _height, _windowStyle, _bitsPerPx };
+	}
+	inline WindowConfigImm::Builder WindowConfigImm::builder( ) &&
+	{
+		return Builder{ std::move( _width ), std::move( _height ), std::move( _windowStyle ), std::move( _bitsPerPx ) };
+	}
 }
@@ -1,16 +1,52 @@
 #pragma once
-#include <adt/list.hpp>
+#include <utility>
+#include <adt/vector.hpp>
 #include <core/sceneImm.hpp>
 // Generated using tools/immutableStruct.hs:
-// gen "World" [("List<SceneImm>", "scenes")] ["adt/list.hpp", "core/sceneImm.hpp"]
+// gen "World" [("Vector<SceneImm>", "scenes")] ["adt/vector.hpp", "core/sceneImm.hpp"]
 namespace hp_fp
 {
-struct WorldImm
-{
-const List<SceneImm> scenes;
-const WorldImm setScenes(const List<SceneImm> s) const
-{
-return WorldImm{ s };
- }
-};
+	// [const][cop-c][cop-a][mov-c][mov-a]
+	// [  +  ][  +  ][  +  ][  +  ][  +  ]
+	struct WorldImm
+	{
+		struct Builder;
+		WorldImm( Vector<SceneImm> scenes )
+			: _scenes( std::move( scenes ) )
+		{ }
+		const Vector<SceneImm>& scenes( ) const
+		{
+			return _scenes;
+		}
+		WorldImm setScenes( Vector<SceneImm> s ) const &
+		{
+			return WorldImm( std::move( s ) );
+		}
+		// moves the other fields out of this
+		WorldImm setScenes( Vector<SceneImm> s ) &&
+		{
+			return WorldImm( std::move( s ) );
+		}
+		Builder builder( ) const &;
+		Builder builder( ) &&;
+	private:
+		Vector<SceneImm> _scenes;
+	};
+	// batches changes of several fields into one construction
+	struct WorldImm::Builder
+	{
+		Vector<SceneImm> scenes;
+		WorldImm build( ) &&
+		{
+			return WorldImm( std::move( scenes ) );
+		}
+	};
+	inline WorldImm::Builder WorldImm::builder( ) const &
+	{
+		return Builder{ _scenes };
+	}
+	inline WorldImm::Builder WorldImm::builder( ) &&
+	{
+		return Builder{ std::move( _scenes ) };
+	}
 }